@@ -31,7 +31,7 @@ using namespace DromeGfx;
 using namespace DromeMath;
 
 Block::Block(const Vector3 &position, const Vector3 &bounds,
-             RefPtr <Texture> texture, RefPtr <Texture> normalmap)
+             const RefPtr <Texture> &texture, const RefPtr <Texture> &normalmap)
 {
 	setPosition(position);
 	setBounds(bounds);
@@ -46,5 +46,17 @@ Block::render(GfxDriver *driver)
 {
 	driver->bindTexture(0, m_texture);
 	driver->bindTexture(1, m_normalmap);
-	m_mesh->render();
+	m_mesh->render(driver);
+}
+
+void
+Block::queue(RenderQueue *renderQueue, const Matrix4 &transform, const Vector3 &viewerPosition)
+{
+	RenderItem item;
+	item.mesh = m_mesh;
+	item.textures[0] = m_texture;
+	item.textures[1] = m_normalmap;
+	item.transform = transform;
+	item.depth = (Vector3(transform[12], transform[13], transform[14]) - viewerPosition).length();
+	renderQueue->add(item);
 }
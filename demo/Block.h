@@ -29,6 +29,7 @@
 #include <DromeMath/BoundingBox.h>
 #include <DromeGfx/Driver.h>
 #include <DromeGfx/Mesh.h>
+#include <DromeGfx/RenderQueue.h>
 
 class Block : public DromeMath::BoundingBox
 {
@@ -38,9 +39,10 @@ class Block : public DromeMath::BoundingBox
 		DromeCore::RefPtr <DromeGfx::Texture> m_normalmap;
 
 	public:
-		Block(const DromeMath::Vector3 &position, const DromeMath::Vector3 &bounds, DromeCore::RefPtr <DromeGfx::Texture> texture, DromeCore::RefPtr <DromeGfx::Texture> normalmap);
+		Block(const DromeMath::Vector3 &position, const DromeMath::Vector3 &bounds, const DromeCore::RefPtr <DromeGfx::Texture> &texture, const DromeCore::RefPtr <DromeGfx::Texture> &normalmap);
 
 		void render(DromeGfx::GfxDriver *driver);
+		void queue(DromeGfx::RenderQueue *renderQueue, const DromeMath::Matrix4 &transform, const DromeMath::Vector3 &viewerPosition);
 };
 
 #endif /* __BLOCK_H__ */
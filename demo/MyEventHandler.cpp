@@ -49,6 +49,7 @@ MyEventHandler::MyEventHandler(IOContext *io)
 	m_io = io;
 	m_io->setWindowDimensions(RESOLUTIONS[m_resolutionIndex][0], RESOLUTIONS[m_resolutionIndex][1]);
 	m_io->setWindowTitle("Drome Engine Demo");
+	m_io->setFixedTimeStep(1.0f / 120.0f);
 	m_io->init();
 	
 	// create graphics driver
@@ -71,9 +72,19 @@ MyEventHandler::~MyEventHandler()
 void
 MyEventHandler::cycle(float secondsElapsed)
 {
+	ProfilerZone zone("MyScene1::cycle");
 	m_scene->cycle(secondsElapsed);
-	m_scene->render(m_driver);
+}
+
+void
+MyEventHandler::renderFrame(float alpha)
+{
+	{
+		ProfilerZone zone("MyScene1::render");
+		m_scene->render(m_driver, alpha);
+	}
 
+	ProfilerZone zone("swapBuffers");
 	m_driver->flush();
 	m_io->swapBuffers();
 }
@@ -114,6 +125,21 @@ MyEventHandler::buttonPress(Button button)
 		case BTN_F:
 			m_io->setFullScreen(m_io->getFullScreen() == false);
 			break;
+		case BTN_P:
+			// toggle profiling, writing out the recorded frames when it stops
+			if(Profiler::isEnabled()) {
+				Profiler::setEnabled(false);
+				try {
+					Profiler::writeChromeTrace("trace.json");
+					cerr << "Wrote profile to trace.json" << endl;
+				} catch(const Exception &ex) {
+					cerr << ex.toString() << endl;
+				}
+			} else {
+				Profiler::clear();
+				Profiler::setEnabled(true);
+			}
+			break;
 		case BTN_SPACE:
 			m_grabMouse = !m_grabMouse;
 			if(m_grabMouse)
@@ -44,6 +44,7 @@ class MyEventHandler : public DromeCore::EventHandler
 		~MyEventHandler();
 
 		void cycle(float secondsElapsed);
+		void renderFrame(float alpha);
 
 		void windowDimensionsChanged(int width, int height);
 		void mouseMove(int x, int y, int xrel, int yrel);
@@ -23,6 +23,7 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdio>
 #include <DromeGfx/DromeGfx>
 #include <DromeGui/DromeGui>
 #include "MyScene1.h"
@@ -37,6 +38,9 @@ MyScene1::MyScene1(IOContext *io, GfxDriver *driver)
 {
 	m_player.setPosition(Vector3(0.0f, 0.0f, 0.0f));
 	m_player.setBounciness(0.1f);
+	m_jobSystem = JobSystem::create();
+	m_physicsWorld.setParallelRunner(m_jobSystem.get());
+	m_physicsWorld.addBody(&m_player);
 
 	// load font
 	m_font = Font::create(driver, "Data/Fonts/VeraBd.ttf", 12.0f);
@@ -63,9 +67,13 @@ MyScene1::MyScene1(IOContext *io, GfxDriver *driver)
 
 	// create/initialize other stuff
 	m_sphere = SphereMesh::create(10, 0.1f);
+	m_renderQueue = RenderQueue::create();
+	m_sceneGraph = SceneGraph::create();
 	m_autoCamera = true;
 	m_camera.setPosition(Vector3(0.0f, -4.0f, 0.0f));
 	m_camera.update();
+	m_previousCameraPosition = m_camera.getPosition();
+	m_frameTime = getNanoseconds();
 
 	// initialize lights
 	m_lightColor[0] = Vector3(1.0f, 0.0f, 0.0f);
@@ -73,6 +81,13 @@ MyScene1::MyScene1(IOContext *io, GfxDriver *driver)
 	m_lightColor[2] = Vector3(0.0f, 0.0f, 1.0f);
 	m_lightRotation = 0.0f;
 
+	// the lights circle the origin as their parent node rotates
+	m_lightsNode = m_sceneGraph->addNode(Transform());
+	for(int i = 0; i < 3; ++i) {
+		float r = (float)i * ((M_PI * 2.0f) / 3.0f);
+		m_lightNodes[i] = m_sceneGraph->addNode(Transform(Vector3(cosf(r), sinf(r)) * 7.5f), m_lightsNode);
+	}
+
 	// create light textures and shadow map framebuffers
 	for(int i = 0; i < 3; ++i) {
 		RefPtr <Image> image = Image::create(1, 1, 3);
@@ -116,10 +131,9 @@ MyScene1::buttonRelease(Button button)
 void
 MyScene1::cycle(float secondsElapsed)
 {
-	float fps = 1.0f / secondsElapsed;
-	m_label->setText(String("Frames per second: ") + String((int)fps));
-
+	m_previousCameraPosition = m_camera.getPosition();
 	m_lightRotation += (M_PI / 4.0f) * secondsElapsed;
+	m_sceneGraph->setTransform(m_lightsNode, Transform(Vector3(), Quaternion::fromAxis(Vector3(0.0f, 0.0f, 1.0f), m_lightRotation)));
 
 	// handle player movement
 	if(m_buttonState.isPressed(BTN_UP)) {
@@ -155,8 +169,7 @@ MyScene1::cycle(float secondsElapsed)
 		m_player.setPosition(m_camera.getPosition());
 	} else {
 		// handle collision
-		for(unsigned int i = 0; i < m_sceneObjects.size(); ++i)
-			m_player.collisionResponse(m_sceneObjects[i]);
+		m_physicsWorld.collide();
 
 		m_camera.setPosition(m_player.getPosition());
 	}
@@ -164,19 +177,68 @@ MyScene1::cycle(float secondsElapsed)
 	m_camera.update();
 }
 
+void
+MyScene1::cullSceneObjects(GfxDriver *driver)
+{
+	m_visibleNodes.clear();
+	m_sceneGraph->query(m_camera.getFrustum(driver->getProjectionMatrix()), m_visibleNodes);
+
+	// keep only the nodes of scene objects, so that m_visibleNodes[i]
+	// is the node of m_visibleSceneObjects[i]
+	m_visibleSceneObjects.clear();
+	unsigned int numVisibleNodes = 0;
+	for(unsigned int i = 0; i < m_visibleNodes.size(); ++i) {
+		unsigned int node = m_visibleNodes[i];
+		if(node < m_nodeObjects.size() && m_nodeObjects[node] >= 0) {
+			m_visibleNodes[numVisibleNodes++] = node;
+			m_visibleSceneObjects.push_back((unsigned int)m_nodeObjects[node]);
+		}
+	}
+	m_visibleNodes.resize(numVisibleNodes);
+}
+
+void
+MyScene1::render(GfxDriver *driver, float alpha)
+{
+	uint64_t frameTime = getNanoseconds();
+	float fps = 1.0e9f / (float)(frameTime - m_frameTime);
+	m_frameTime = frameTime;
+
+	// format into a buffer so the label's string can reuse its memory
+	char text[64];
+	sprintf(text, "Frames per second: %d", (int)fps);
+	m_label->setText(text);
+
+	// render from between the camera's last two positions
+	Vector3 cameraPosition = m_camera.getPosition();
+	m_camera.setPosition(m_previousCameraPosition + (cameraPosition - m_previousCameraPosition) * alpha);
+	m_camera.update();
+
+	render(driver);
+
+	m_camera.setPosition(cameraPosition);
+	m_camera.update();
+}
+
 void
 MyScene1::render(GfxDriver *driver)
 {
+	// only the lights move, so only their nodes are recalculated
+	m_sceneGraph->update();
+	cullSceneObjects(driver);
+
 	// if the shader program wasn't created, just
 	// render the objects to the screen
 	if(m_shaderProgram.isNull()) {
 		driver->clearBuffers();
 
 		// render scene objects from player's perspective
-		for(unsigned int i = 0; i < m_sceneObjects.size(); ++i) {
-			driver->setModelViewMatrix(Matrix4().translate(m_sceneObjects[i]->getPosition()) * m_camera.getMatrix());
-			m_sceneObjects[i]->render(driver);
+		m_renderQueue->clear();
+		for(unsigned int i = 0; i < m_visibleSceneObjects.size(); ++i) {
+			unsigned int node = m_visibleNodes[i];
+			m_sceneObjects[m_visibleSceneObjects[i]]->queue(m_renderQueue.get(), m_sceneGraph->getWorldMatrix(node), m_camera.getPosition());
 		}
+		m_renderQueue->execute(driver, m_camera.getMatrix());
 
 		return;
 	}
@@ -187,10 +249,9 @@ MyScene1::render(GfxDriver *driver)
 	// render shadow maps
 	driver->setCullFace(CULL_FACE_FRONT);
 	for(int i = 0; i < 3; ++i) {
-		// calculate light position
-		float r = m_lightRotation + (float)i * ((M_PI * 2.0f) / 3.0f);
-		lightPosition[i] = Vector3(cosf(r), sinf(r)) * 7.5f;
-		lightPosition[i].z = 0.0f;
+		// get light position
+		const Matrix4 &m = m_sceneGraph->getWorldMatrix(m_lightNodes[i]);
+		lightPosition[i] = Vector3(m[12], m[13], m[14]);
 
 /*
 		// create light camera
@@ -238,9 +299,10 @@ MyScene1::render(GfxDriver *driver)
 	driver->bindTexture(2, m_lightFramebuffers[0]);
 	driver->bindTexture(3, m_lightFramebuffers[1]);
 	driver->bindTexture(4, m_lightFramebuffers[2]);
-	for(unsigned int i = 0; i < m_sceneObjects.size(); ++i) {
-		m_shaderProgram->setUniform("objectPosition", m_sceneObjects[i]->getPosition());
-		m_sceneObjects[i]->render(driver);
+	for(unsigned int i = 0; i < m_visibleSceneObjects.size(); ++i) {
+		Block *block = m_sceneObjects[m_visibleSceneObjects[i]];
+		m_shaderProgram->setUniform("objectPosition", block->getPosition());
+		block->render(driver);
 	}
 	driver->bindTexture(2, Texture::none());
 	driver->bindTexture(3, Texture::none());
@@ -251,9 +313,9 @@ MyScene1::render(GfxDriver *driver)
 
 	// render light spheres
 	for(int i = 0; i < 3; ++i) {
-		driver->setModelViewMatrix(Matrix4().translate(lightPosition[i]) * m_camera.getMatrix());
+		driver->setModelViewMatrix(m_camera.getMatrix() * m_sceneGraph->getWorldMatrix(m_lightNodes[i]));
 		driver->bindTexture(m_lightTextures[i]);
-		m_sphere->render();
+		m_sphere->render(driver);
 	}
 
 	// render GUI elements
@@ -266,6 +328,8 @@ MyScene1::render(GfxDriver *driver)
 void
 MyScene1::loadSceneFile(const char *filePath)
 {
+	ProfilerZone zone("MyScene1::loadSceneFile");
+
 	// load XML scene file
 	XmlDocument doc;
 	doc.fromFile(File::getPath(filePath));
@@ -276,6 +340,7 @@ MyScene1::loadSceneFile(const char *filePath)
 		throw Exception("MyScene1::loadSceneFile(): Invalid root element name");
 
 	vector < RefPtr <Texture> > textures;
+	m_levelNode = m_sceneGraph->addNode(Transform());
 
 	// loop through each child element
 	for(unsigned int i = 0; i < root->getNumChildren(); ++i) {
@@ -318,8 +383,17 @@ MyScene1::loadSceneFile(const char *filePath)
 
 			// create block
 			m_sceneObjects.push_back(new Block(position, bounds, textures[index], normalmap));
+			m_physicsWorld.addBody(m_sceneObjects.back(), true);
+
+			// blocks don't move, so their nodes are only calculated once
+			unsigned int node = m_sceneGraph->addNode(Transform(position), m_levelNode);
+			m_sceneGraph->setBounds(node, bounds * -1.0f, bounds);
+			if(node >= m_nodeObjects.size())
+				m_nodeObjects.resize(node + 1, -1);
+			m_nodeObjects[node] = (int)m_sceneObjects.size() - 1;
 		} else {
 			throw Exception("MyScene1::loadSceneFile(): Invalid element name '" + child->getName() + "'");
 		}
 	}
+
 }
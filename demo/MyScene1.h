@@ -36,9 +36,22 @@ class MyScene1 : public DromeGfx::Scene
 		bool m_autoCamera;
 		float m_autoCameraRotation;
 		DromeGfx::Camera m_camera;
+		DromeMath::Vector3 m_previousCameraPosition;
+		uint64_t m_frameTime;
 		DromeMath::BoundingBox m_player;
 
 		std::vector <Block *> m_sceneObjects;
+		std::vector <unsigned int> m_visibleSceneObjects;
+
+		// the blocks' nodes are children of the level node;
+		// m_nodeObjects maps each node to its block, or -1
+		DromeCore::RefPtr <DromeGfx::SceneGraph> m_sceneGraph;
+		unsigned int m_levelNode;
+		std::vector <unsigned int> m_visibleNodes;
+		std::vector <int> m_nodeObjects;
+		DromeCore::RefPtr <DromeCore::JobSystem> m_jobSystem;
+		DromeMath::PhysicsWorld m_physicsWorld;
+		DromeCore::RefPtr <DromeGfx::RenderQueue> m_renderQueue;
 
 		// GUI
 		DromeCore::RefPtr <DromeGui::Font> m_font;
@@ -50,6 +63,8 @@ class MyScene1 : public DromeGfx::Scene
 		DromeCore::RefPtr <DromeGfx::Texture> m_lightTextures[3];
 		DromeMath::Vector3 m_lightColor[3];
 		float m_lightRotation;
+		unsigned int m_lightsNode;
+		unsigned int m_lightNodes[3];
 
 		// other
 		DromeCore::RefPtr <DromeGfx::Mesh> m_sphere;
@@ -64,7 +79,9 @@ class MyScene1 : public DromeGfx::Scene
 		void buttonRelease(DromeCore::Button button);
 
 		void cycle(float secondsElapsed);
+		void cullSceneObjects(DromeGfx::GfxDriver *driver);
 		void render(DromeGfx::GfxDriver *driver);
+		void render(DromeGfx::GfxDriver *driver, float alpha);
 
 		void loadSceneFile(const char *filePath);
 };
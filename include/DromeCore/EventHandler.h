@@ -41,12 +41,19 @@ class EventHandler {
 		virtual ~EventHandler() { }
 
 		/**
-		 * Called when the application may perform tasks such as rendering and logic.
+		 * Called when the application may perform tasks such as rendering and logic. If the IOContext has a fixed time step, this is called zero or more times per IOContext cycle with secondsElapsed set to the time step, and rendering should be done in renderFrame().
 		 *
 		 * @param secondsElapsed The number of seconds that have elapsed since the last cycle.
 		 */
 		virtual void cycle(float secondsElapsed) = 0;
 
+		/**
+		 * Called once per IOContext cycle, after cycle(), when a frame may be rendered.
+		 *
+		 * @param alpha The fraction of a fixed time step that has elapsed since the last call to cycle(), from 0 up to (but not including) 1, for interpolating between the previous and current states. Without a fixed time step this is always 1.
+		 */
+		virtual void renderFrame(float alpha);
+
 		/**
 		 * Called when the application window's dimensions have changed.
 		 *
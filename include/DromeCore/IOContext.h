@@ -39,7 +39,12 @@ namespace DromeCore {
 class IOContext {
 	protected:
 		EventHandler *m_handler;
-		long m_ticks;
+		uint64_t m_cycleTime;
+
+		// fixed time step state, in nanoseconds
+		uint64_t m_fixedTimeStep;
+		uint64_t m_accumulatedTime;
+		unsigned int m_maxStepsPerCycle;
 
 	public:
 		IOContext();
@@ -57,6 +62,27 @@ class IOContext {
 		 */
 		void setEventHandler(EventHandler *value);
 
+		/**
+		 * @return The time step passed to the EventHandler's cycle() function, in seconds, or 0 if the time step varies.
+		 */
+		float getFixedTimeStep() const;
+
+		/**
+		 * Sets a fixed time step for the EventHandler. Each IOContext cycle adds the elapsed time to an accumulator and calls the EventHandler's cycle() function once for every whole time step accumulated, so that simulation behaves the same at any frame rate, and then calls renderFrame() with the fraction of a step left over.
+		 *
+		 * @param seconds The time step in seconds (e.g. 1/120), or 0 to call cycle() once per IOContext cycle with the elapsed time.
+		 */
+		void setFixedTimeStep(float seconds);
+
+		unsigned int getMaxStepsPerCycle() const { return m_maxStepsPerCycle; }
+
+		/**
+		 * Limits the number of fixed time steps run per IOContext cycle. If the steps take longer to run than the time they simulate, the accumulated time would otherwise grow without bound; instead, time beyond this many steps is dropped and the simulation slows down.
+		 *
+		 * @param value The maximum number of steps per cycle.
+		 */
+		void setMaxStepsPerCycle(unsigned int value);
+
 
 	// virtual functions
 		/**
@@ -106,6 +132,9 @@ class IOContext {
 		 */
 		virtual bool init() = 0;
 
+		/**
+		 * Runs the EventHandler for one frame, and then resets the frame allocator (see LinearAllocator::getFrameAllocator()).
+		 */
 		virtual void cycle();
 
 		/**
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_JOBSYSTEM_H__
+#define __DROMECORE_JOBSYSTEM_H__
+
+#include <vector>
+#include <DromeMath/ParallelRunner.h>
+#include "Ref.h"
+
+namespace DromeCore {
+
+/**
+ * A function run by a job. It is given the data and index range the job was submitted with.
+ */
+typedef DromeMath::ParallelFunction JobFunction;
+
+class JobCounter;
+class JobQueue;
+class JobSystemState;
+class JobWorker;
+
+/**
+ * A job waiting to be run by a JobSystem.
+ */
+class Job
+{
+	public:
+		JobFunction function;
+		void *data;
+		unsigned int first, end;
+		JobCounter *counter;
+};
+
+/**
+ * The JobCounter class counts the unfinished jobs submitted with it. It can be waited on with JobSystem::wait() and used as a dependency of other jobs, which are held back until the count reaches zero. A counter must not be destroyed until wait() has returned for it.
+ */
+class JobCounter
+{
+	friend class JobSystem;
+
+	protected:
+		volatile int m_value;
+		std::vector <Job> m_waitingJobs;
+
+	private:
+		// counters are referred to by queued jobs, so they can't be copied
+		JobCounter(const JobCounter &);
+		void operator = (const JobCounter &);
+
+	public:
+		JobCounter() { m_value = 0; }
+
+		/**
+		 * @return True if all jobs submitted with this counter have finished.
+		 */
+		bool isDone() const { return m_value == 0; }
+};
+
+/**
+ * The JobSystem class runs jobs on a fixed pool of worker threads. Each worker has its own queue of jobs. Jobs submitted by a worker are pushed to its own queue and jobs submitted by other threads are spread over all queues; workers take jobs from the back of their own queue and, when it is empty, steal jobs from the front of the other queues. Threads that wait for jobs to finish run queued jobs while they wait.
+ */
+class JobSystem : public RefClass, public DromeMath::ParallelRunner
+{
+	friend class JobWorker;
+
+	protected:
+		std::vector <JobQueue *> m_queues;
+		std::vector <JobWorker *> m_workers;
+		JobSystemState *m_state;
+
+		JobSystem(unsigned int numWorkers);
+		virtual ~JobSystem();
+
+		unsigned int getCurrentQueueIndex() const;
+		void enqueue(const Job &job);
+		bool runJob(unsigned int queueIndex);
+		void finishJob(const Job &job);
+		void workerLoop(unsigned int queueIndex);
+
+	public:
+		/**
+		 * @return The number of worker threads.
+		 */
+		unsigned int getNumWorkers() const { return (unsigned int)m_workers.size(); }
+
+		/**
+		 * Queues a job.
+		 *
+		 * @param function The function to run.
+		 * @param data Data to pass to the function.
+		 * @param first The first index to pass to the function.
+		 * @param end The end index to pass to the function.
+		 * @param counter A counter to increment until the job has finished, or NULL.
+		 * @param dependency A counter that must reach zero before the job is started, or NULL.
+		 */
+		void submit(JobFunction function, void *data, unsigned int first = 0, unsigned int end = 1, JobCounter *counter = 0, JobCounter *dependency = 0);
+
+		/**
+		 * Runs queued jobs until all jobs submitted with the given counter have finished.
+		 *
+		 * @param counter The counter to wait for.
+		 */
+		void wait(JobCounter *counter);
+
+		/**
+		 * Splits a range of indices into jobs of at most grainSize indices and waits for them to finish. The calling thread runs jobs too. The ranges given to the function don't depend on the number of worker threads.
+		 *
+		 * @param count The number of indices.
+		 * @param grainSize The maximum number of indices in each job.
+		 * @param function The function to run for each range of indices.
+		 * @param data Data to pass to the function.
+		 */
+		void parallelFor(unsigned int count, unsigned int grainSize, JobFunction function, void *data);
+
+		/**
+		 * @param numWorkers The number of worker threads to create. If 0, one fewer than the number of processors is used.
+		 * @return A new JobSystem object.
+		 */
+		static RefPtr <JobSystem> create(unsigned int numWorkers = 0);
+
+		/**
+		 * @return The number of processors available.
+		 */
+		static unsigned int getNumProcessors();
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_JOBSYSTEM_H__ */
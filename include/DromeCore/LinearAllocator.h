@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_LINEARALLOCATOR_H__
+#define __DROMECORE_LINEARALLOCATOR_H__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace DromeCore {
+
+/**
+ * The LinearAllocator class allocates memory by advancing an offset through large blocks, which makes allocation a few instructions and freeing free: memory is released all at once by reset(), or back to a marker by rewind(). It suits short-lived scratch memory, such as arrays built and drawn within one frame.
+ *
+ * When an allocation doesn't fit in the current block another block is added; reset() then replaces the blocks with a single block large enough for all of them, so an allocator settles on one block sized for its busiest use.
+ *
+ * Objects allocated with a LinearAllocator don't have their destructors called when the memory is released. A LinearAllocator must only be used by one thread at a time.
+ */
+class LinearAllocator
+{
+	public:
+		/**
+		 * The alignment, in bytes, of allocations that don't specify one. It is enough for any scalar type and for SIMD vectors.
+		 */
+		static const size_t DEFAULT_ALIGNMENT = 16;
+
+		/**
+		 * The default size, in bytes, of the first block.
+		 */
+		static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+		/**
+		 * A position in a LinearAllocator that it can be rewound to.
+		 */
+		struct Marker
+		{
+			size_t block;
+			size_t offset;
+			size_t numBytes;
+		};
+
+	protected:
+		struct Block
+		{
+			char *data;
+			size_t size;
+		};
+
+		std::vector <Block> m_blocks;
+		size_t m_blockSize;
+		size_t m_currentBlock;
+		size_t m_offset;
+		size_t m_numBytes;
+		size_t m_peakNumBytes;
+
+		void *allocateFromNextBlock(size_t size, size_t alignment);
+
+	private:
+		LinearAllocator(const LinearAllocator &);
+		void operator = (const LinearAllocator &);
+
+	public:
+		/**
+		 * @param blockSize The size, in bytes, of the first block. No memory is allocated until the first allocation.
+		 */
+		LinearAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		~LinearAllocator();
+
+		/**
+		 * Allocates memory. std::bad_alloc is thrown if no memory is available.
+		 *
+		 * @param size The number of bytes to allocate.
+		 * @param alignment The alignment of the memory in bytes, which must be a power of two.
+		 * @return The allocated memory, which is valid until the allocator is reset or rewound to a marker taken before it was allocated.
+		 */
+		void *
+		allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT)
+		{
+			if(m_currentBlock < m_blocks.size()) {
+				const Block &block = m_blocks[m_currentBlock];
+				size_t address = (size_t)block.data + m_offset;
+				size_t start = ((address + alignment - 1) & ~(alignment - 1)) - (size_t)block.data;
+				if(start <= block.size && size <= block.size - start) {
+					m_offset = start + size;
+					m_numBytes += size;
+					return block.data + start;
+				}
+			}
+
+			return allocateFromNextBlock(size, alignment);
+		}
+
+		/**
+		 * Allocates an array. The elements are not constructed or destroyed, so this is meant for simple types whose elements are all assigned before use.
+		 *
+		 * @param count The number of elements.
+		 * @return The allocated array.
+		 */
+		template <class T> T *
+		allocateArray(size_t count)
+		{
+			return (T *)allocate(count * sizeof(T));
+		}
+
+		/**
+		 * @return The current position, which memory allocated later can be released back to with rewind().
+		 */
+		Marker getMarker() const;
+
+		/**
+		 * Releases all memory allocated since a marker was taken.
+		 *
+		 * @param marker A marker returned by getMarker() since the last reset().
+		 */
+		void rewind(const Marker &marker);
+
+		/**
+		 * Releases all allocated memory, and merges the blocks into one if more than one was needed.
+		 */
+		void reset();
+
+		/**
+		 * @return The number of bytes allocated since the last reset(), not counting alignment padding.
+		 */
+		size_t getNumBytes() const { return m_numBytes; }
+
+		/**
+		 * @return The largest number of bytes that have been allocated at once.
+		 */
+		size_t getPeakNumBytes() const { return m_peakNumBytes; }
+
+		/**
+		 * @return The total size of the allocator's blocks in bytes.
+		 */
+		size_t getCapacity() const;
+
+		/**
+		 * Gets the allocator for memory that only needs to last until the end of the current frame. IOContext::cycle() resets it after each frame is rendered, so it must only be used by the thread that runs the IOContext.
+		 *
+		 * @return The frame allocator.
+		 */
+		static LinearAllocator &getFrameAllocator();
+};
+
+/**
+ * The LinearAllocatorScope class rewinds a LinearAllocator to its position at the start of the scope the object is declared in, releasing the memory allocated within the scope.
+ */
+class LinearAllocatorScope
+{
+	private:
+		LinearAllocator &m_allocator;
+		LinearAllocator::Marker m_marker;
+
+		LinearAllocatorScope(const LinearAllocatorScope &);
+		void operator = (const LinearAllocatorScope &);
+
+	public:
+		LinearAllocatorScope(LinearAllocator &allocator) : m_allocator(allocator) { m_marker = allocator.getMarker(); }
+		~LinearAllocatorScope() { m_allocator.rewind(m_marker); }
+};
+
+/**
+ * The LinearStlAllocator class is an STL allocator that allocates from a LinearAllocator, so that standard containers can use it for scratch memory. Deallocation does nothing; the memory is released with the LinearAllocator.
+ *
+ * For example, a vector of scratch vertices for the current frame:
+ *
+ * std::vector <Vector3, LinearStlAllocator <Vector3> > vertices(LinearStlAllocator <Vector3> (LinearAllocator::getFrameAllocator()));
+ */
+template <class T>
+class LinearStlAllocator
+{
+	template <class U> friend class LinearStlAllocator;
+
+	protected:
+		LinearAllocator *m_allocator;
+
+	public:
+		typedef T value_type;
+		typedef T *pointer;
+		typedef const T *const_pointer;
+		typedef T &reference;
+		typedef const T &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template <class U>
+		struct rebind
+		{
+			typedef LinearStlAllocator <U> other;
+		};
+
+		LinearStlAllocator(LinearAllocator &allocator) { m_allocator = &allocator; }
+		template <class U> LinearStlAllocator(const LinearStlAllocator <U> &other) { m_allocator = other.m_allocator; }
+
+		LinearAllocator &getAllocator() const { return *m_allocator; }
+
+		pointer address(reference x) const { return &x; }
+		const_pointer address(const_reference x) const { return &x; }
+
+		pointer
+		allocate(size_type n, const void * = 0)
+		{
+			if(n > max_size())
+				throw std::bad_alloc();
+			return (pointer)m_allocator->allocate(n * sizeof(T));
+		}
+
+		void deallocate(pointer, size_type) { }
+
+		size_type max_size() const { return (size_t)-1 / sizeof(T); }
+
+		void construct(pointer p, const T &value) { new((void *)p) T(value); }
+		void destroy(pointer p) { p->~T(); }
+
+		template <class U> bool operator == (const LinearStlAllocator <U> &other) const { return m_allocator == other.m_allocator; }
+		template <class U> bool operator != (const LinearStlAllocator <U> &other) const { return m_allocator != other.m_allocator; }
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_LINEARALLOCATOR_H__ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_OBJECTPOOL_H__
+#define __DROMECORE_OBJECTPOOL_H__
+
+#include <cstddef>
+#include <vector>
+
+namespace DromeCore {
+
+/**
+ * The ObjectPool class allocates the objects of a class from slabs of fixed-size blocks instead of the general heap, and keeps statistics on the objects allocated. Freed blocks are reused by later allocations of the same size class, so frequently created and destroyed objects don't fragment the heap. Blocks are shared by all pools with objects of the same size class, and slab memory is kept for the life of the process.
+ *
+ * A class opts in by declaring class-level operator new and operator delete that call allocate() and deallocate() of a pool defined in its source file. Classes derived from it use the same pool, with blocks sized for each derived class, but their objects are counted together under the pool's name: operator new is only given the size of the object, so a pool can't tell which derived class is being allocated. Derived classes that need their own statistics can declare their own operators and pool. Objects larger than MAX_POOLED_SIZE are allocated from the general heap but are still counted. Pools can be used from several threads at once; each thread keeps a small cache of free blocks, so most allocations don't lock.
+ */
+class ObjectPool
+{
+	protected:
+		const char *m_name;
+
+		// index of the pool's counters in each thread
+		unsigned int m_index;
+
+		// next pool in the list of all pools
+		ObjectPool *m_next;
+
+	private:
+		ObjectPool(const ObjectPool &);
+		void operator = (const ObjectPool &);
+
+	public:
+		/**
+		 * The largest object size, in bytes, that is allocated from slabs.
+		 */
+		static const size_t MAX_POOLED_SIZE = 512;
+
+		/**
+		 * Creates a pool. Pools are meant to be defined as static objects and are never destroyed.
+		 *
+		 * @param name The name of the pooled class, used when reporting statistics. The string must not be freed.
+		 */
+		ObjectPool(const char *name);
+
+		const char *getName() const { return m_name; }
+
+		/**
+		 * Gets statistics on the objects allocated from this pool, including objects of derived classes that share it. The counters are kept per thread so that allocation doesn't need to lock, so gathering them takes a little time.
+		 *
+		 * @param numObjects Set to the number of objects that haven't been freed.
+		 * @param numBytes Set to the number of bytes used by objects that haven't been freed.
+		 * @param numAllocations Set to the total number of objects that have been allocated.
+		 */
+		void getStatistics(int &numObjects, int &numBytes, int &numAllocations) const;
+
+		/**
+		 * @return The number of objects allocated from this pool that haven't been freed.
+		 */
+		int getNumObjects() const;
+
+		/**
+		 * @return The number of bytes used by objects allocated from this pool that haven't been freed.
+		 */
+		int getNumBytes() const;
+
+		/**
+		 * @return The total number of objects that have been allocated from this pool.
+		 */
+		int getNumAllocations() const;
+
+		/**
+		 * Allocates memory for an object.
+		 *
+		 * @param size The size of the object in bytes.
+		 * @return The allocated memory. std::bad_alloc is thrown if no memory is available.
+		 */
+		void *allocate(size_t size);
+
+		/**
+		 * Frees memory allocated by allocate().
+		 *
+		 * @param ptr The memory to free, or NULL.
+		 * @param size The size passed to allocate().
+		 */
+		void deallocate(void *ptr, size_t size);
+
+		/**
+		 * Gets all pools that have been created.
+		 *
+		 * @param pools Vector to append the pools to.
+		 */
+		static void getPools(std::vector <const ObjectPool *> &pools);
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_OBJECTPOOL_H__ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_PROFILER_H__
+#define __DROMECORE_PROFILER_H__
+
+#include <string>
+
+namespace DromeCore {
+
+/**
+ * The Profiler class records how long named zones of code take to run. Each thread records its completed zones in its own ring buffer, keeping the most recent ones, and zones may be nested. The recorded zones can be written as a Chrome trace (JSON that can be loaded in chrome://tracing or Perfetto) for offline analysis.
+ *
+ * Zones are usually recorded with a ProfilerZone object. Recording is disabled by default, in which case a zone costs a single check.
+ */
+class Profiler
+{
+	public:
+		/**
+		 * The number of completed zones kept for each thread.
+		 */
+		static const unsigned int EVENTS_PER_THREAD = 16384;
+
+		static bool isEnabled();
+
+		/**
+		 * Enables or disables recording of zones.
+		 *
+		 * @param value True to record zones.
+		 */
+		static void setEnabled(bool value);
+
+		/**
+		 * Starts timing a zone on the calling thread.
+		 *
+		 * @param name The name of the zone. Only the pointer is stored, so the string must not be freed or changed while the profiler is in use; string literals are best.
+		 * @return True if the zone was started, in which case endZone() must be called to end it.
+		 */
+		static bool beginZone(const char *name);
+
+		/**
+		 * Ends the zone most recently started on the calling thread and records it.
+		 */
+		static void endZone();
+
+		/**
+		 * Discards the recorded zones of all threads.
+		 */
+		static void clear();
+
+		/**
+		 * @return The recorded zones of all threads in Chrome's trace event format.
+		 */
+		static std::string getChromeTrace();
+
+		/**
+		 * Writes the recorded zones of all threads to a file in Chrome's trace event format.
+		 *
+		 * @param filename The path of the file to write.
+		 */
+		static void writeChromeTrace(const char *filename);
+};
+
+/**
+ * The ProfilerZone class times the scope it is declared in as a Profiler zone.
+ */
+class ProfilerZone
+{
+	private:
+		bool m_active;
+
+		ProfilerZone(const ProfilerZone &);
+		void operator = (const ProfilerZone &);
+
+	public:
+		/**
+		 * @param name The name of the zone; see Profiler::beginZone().
+		 */
+		ProfilerZone(const char *name) { m_active = Profiler::beginZone(name); }
+		~ProfilerZone() { if(m_active) Profiler::endZone(); }
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_PROFILER_H__ */
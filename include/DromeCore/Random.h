@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_RANDOM_H__
+#define __DROMECORE_RANDOM_H__
+
+#include <stdint.h>
+#include <DromeMath/Vector3.h>
+
+namespace DromeCore {
+
+/**
+ * The Random class generates pseudo-random numbers with the PCG32 algorithm. Each object has its own state, so generators can be used on different threads without locking, and a generator seeded with the same seed and stream always produces the same sequence. Generators with the same seed but different streams produce independent sequences.
+ */
+class Random
+{
+	protected:
+		uint64_t m_state;
+		uint64_t m_increment;
+
+	public:
+		/**
+		 * @param seed The starting state of the generator.
+		 * @param stream The sequence to generate; only the lower 63 bits are used.
+		 */
+		Random(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0);
+
+		/**
+		 * Restarts the generator with a new seed and stream.
+		 *
+		 * @param seed The starting state of the generator.
+		 * @param stream The sequence to generate; only the lower 63 bits are used.
+		 */
+		void seed(uint64_t seed, uint64_t stream = 0);
+
+		/**
+		 * @return A new generator seeded from this one, using a different stream.
+		 */
+		Random split();
+
+		/**
+		 * @return A random 32-bit unsigned integer.
+		 */
+		inline uint32_t nextUInt()
+		{
+			uint64_t oldState = m_state;
+			m_state = oldState * 6364136223846793005ULL + m_increment;
+
+			uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+			uint32_t rotation = (uint32_t)(oldState >> 59);
+			return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+		}
+
+		/**
+		 * @param bound The upper boundary of the range.
+		 * @return A random unsigned integer from 0 up to (but not including) bound, without modulo bias.
+		 */
+		uint32_t nextUInt(uint32_t bound);
+
+		/**
+		 * @return A random float from 0 up to (but not including) 1.
+		 */
+		inline float nextFloat() { return (float)(nextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+		/**
+		 * @param min The minimum boundary of the range.
+		 * @param max The maximum boundary of the range.
+		 * @return A random float from min up to (but not including) max.
+		 */
+		inline float nextFloat(float min, float max) { return min + (max - min) * nextFloat(); }
+
+		/**
+		 * @return A random vector with a length of 1, uniformly distributed over the unit sphere.
+		 */
+		DromeMath::Vector3 nextUnitVector();
+
+		/**
+		 * Fills an array with random 32-bit unsigned integers.
+		 *
+		 * @param values The array to fill.
+		 * @param numValues The number of values to generate.
+		 */
+		void fillUInts(uint32_t *values, unsigned int numValues);
+
+		/**
+		 * Fills an array with random floats. The result is the same as calling nextFloat(min, max) for each element.
+		 *
+		 * @param values The array to fill.
+		 * @param numValues The number of values to generate.
+		 * @param min The minimum boundary of the range.
+		 * @param max The maximum boundary of the range.
+		 */
+		void fillFloats(float *values, unsigned int numValues, float min = 0.0f, float max = 1.0f);
+
+		/**
+		 * Fills an array with random unit vectors.
+		 *
+		 * @param vectors The array to fill.
+		 * @param numVectors The number of vectors to generate.
+		 */
+		void fillUnitVectors(DromeMath::Vector3 *vectors, unsigned int numVectors);
+
+		/**
+		 * Fills separate arrays of x, y and z components with random unit vectors.
+		 *
+		 * @param x The array to fill with the x components.
+		 * @param y The array to fill with the y components.
+		 * @param z The array to fill with the z components.
+		 * @param numVectors The number of vectors to generate.
+		 */
+		void fillUnitVectors(float *x, float *y, float *z, unsigned int numVectors);
+
+		/**
+		 * Gets the calling thread's generator, which is created the first time it is requested. Each thread's generator uses a different stream.
+		 *
+		 * @return The calling thread's generator.
+		 */
+		static Random &getThreadRandom();
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_RANDOM_H__ */
@@ -30,18 +30,45 @@ namespace DromeCore {
 
 /**
  * The RefClass class provides a reference counting mechanism for classes that derive from it. Its initial reference count is 1. When its reference count reaches 0, it will automatically delete itself. The RefPtr class should be used for pointers to RefClass-derived classes, as it will automatically increment and decrement the reference count.
+ *
+ * By default the reference count is a plain integer, which is fastest but can only be changed by one thread at a time. Objects whose RefPtrs are copied or destroyed on several threads, such as objects created by loader threads or shared with worker threads, should use an atomic reference count; see setAtomicRefCount().
  */
 class RefClass
 {
 	protected:
+		// plain so that the non-atomic path can keep it in a register;
+		// only atomicAddRef() accesses it with atomic operations
 		int m_refCount;
+		bool m_atomicRefCount;
+
+		int atomicAddRef(int amount);
 
 	public:
-		RefClass() { m_refCount = 0; }
+		RefClass() { m_refCount = 0; m_atomicRefCount = false; }
 		virtual ~RefClass() { }
 
-		inline void ref() { ++m_refCount; }
-		inline void unref() { if(--m_refCount == 0) delete this; }
+		inline void ref()
+		{
+			if(m_atomicRefCount)
+				atomicAddRef(1);
+			else
+				++m_refCount;
+		}
+
+		inline void unref()
+		{
+			if((m_atomicRefCount ? atomicAddRef(-1) : --m_refCount) == 0)
+				delete this;
+		}
+
+		bool hasAtomicRefCount() const { return m_atomicRefCount; }
+
+		/**
+		 * Sets whether the reference count is changed with atomic operations, so that RefPtrs to the object can be copied and destroyed on several threads at once. This must be set before the object is shared between threads.
+		 *
+		 * @param value True to use atomic operations.
+		 */
+		void setAtomicRefCount(bool value) { m_atomicRefCount = value; }
 };
 
 /**
@@ -69,10 +96,32 @@ template <typename T> class RefPtr
 				ptr->ref();
 		}
 
-		virtual ~RefPtr() { if(ptr) ptr->unref(); }
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+		// moving a RefPtr takes over its reference instead of adding one
+		RefPtr(RefPtr <T> &&arg)
+		{
+			ptr = arg.ptr;
+			arg.ptr = 0;
+		}
+
+		inline void operator = (RefPtr <T> &&arg)
+		{
+			if(&arg == this)
+				return;
+
+			T *old = ptr;
+			ptr = arg.ptr;
+			arg.ptr = 0;
+			if(old)
+				old->unref();
+		}
+#endif
+
+		~RefPtr() { if(ptr) ptr->unref(); }
 
 		inline bool isSet() const { return (ptr != 0); }
 		inline bool isNull() const { return (ptr == 0); }
+		inline T *get() const { return ptr; }
 
 		// operators
 		inline T * operator -> () { return ptr; }
@@ -80,31 +129,37 @@ template <typename T> class RefPtr
 
 		inline bool operator ! () const  { return (ptr ? false : true); }
 
-		inline void operator = (RefPtr <T> arg)
+		// the new object is referenced before the old one is released,
+		// so assigning a RefPtr the object it already points to is safe
+		inline void operator = (const RefPtr <T> &arg)
 		{
-			if(ptr)
-				ptr->unref();
-			ptr = arg.ptr;
-			if(ptr)
-				ptr->ref();
+			*this = arg.ptr;
 		}
 
 		inline void operator = (T *arg)
 		{
+			if(arg)
+				arg->ref();
 			if(ptr)
 				ptr->unref();
 			ptr = arg;
-			if(ptr)
-				ptr->ref();
 		}
 
 		inline void operator = (T &arg)
 		{
-			if(ptr)
-				ptr->unref();
-			ptr = &arg;
-			if(ptr)
-				ptr->ref();
+			*this = &arg;
+		}
+
+		/**
+		 * Exchanges the objects pointed to by two RefPtrs without changing their reference counts.
+		 *
+		 * @param arg The RefPtr to swap with.
+		 */
+		inline void swap(RefPtr <T> &arg)
+		{
+			T *tmp = ptr;
+			ptr = arg.ptr;
+			arg.ptr = tmp;
 		}
 
 		inline bool operator == (const RefPtr <T> &arg) const
@@ -26,9 +26,13 @@
 #ifndef __DROMECORE_UTIL_H__
 #define __DROMECORE_UTIL_H__
 
+#include <stdint.h>
+
 namespace DromeCore {
 
 /**
+ * The random functions use the calling thread's generator from Random::getThreadRandom(). Code that needs many random numbers or a reproducible sequence should use its own Random object.
+ *
  * @return A random unsigned char.
  */
 unsigned char randomUChar();
@@ -61,6 +65,13 @@ int strCaseCmp(const char *s1, const char *s2);
  */
 long getTicks();
 
+/**
+ * Reads a monotonic clock with nanosecond units. The clock is unaffected by changes to the system time, so differences between its values are reliable for measuring elapsed time, though its actual resolution depends on the platform.
+ *
+ * @return The number of nanoseconds that have passed since an unspecified starting point.
+ */
+uint64_t getNanoseconds();
+
 } // namespace DromeCore
 
 #endif /* __DROMECORE_UTIL_H__ */
@@ -103,6 +103,17 @@ class Camera {
 		 */
 		inline const DromeMath::Matrix4 &getMatrix() const { return m_matrix; }
 
+		/**
+		 * @return The inverse of Camera's view matrix, which transforms from view space to world space. The view matrix only rotates and translates, so this is cheaper than a general inverse.
+		 */
+		inline DromeMath::Matrix4 getInverseMatrix() const { return m_matrix.inverseOrthonormal(); }
+
+		/**
+		 * @param projection The projection matrix to combine with Camera's view matrix, such as the one returned by GfxDriver::getProjectionMatrix().
+		 * @return Camera's view frustum.
+		 */
+		inline DromeMath::Frustum getFrustum(const DromeMath::Matrix4 &projection) const { return DromeMath::Frustum(projection * m_matrix); }
+
 		/**
 		 * Sets the Camera's translation Vector, which is added to the Camera's position Vector during Matrix generation. This is handy if, for example, the Camera view should be a bit above the ground if its Z position is 0.
 		 *
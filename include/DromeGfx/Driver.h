@@ -26,6 +26,7 @@
 #ifndef __DROMEGFX_DRIVER_H__
 #define __DROMEGFX_DRIVER_H__
 
+#include <vector>
 #include <DromeMath/Matrix4.h>
 #include <DromeMath/Rect2i.h>
 #include "Framebuffer.h"
@@ -37,11 +38,28 @@
 
 namespace DromeGfx {
 
+class Mesh;
+
 class GfxDriver {
+	protected:
+		std::vector <DromeMath::Matrix4> m_projectionMatrixStack;
+		std::vector <DromeMath::Matrix4> m_modelViewMatrixStack;
+
 	public:
 		GfxDriver() { }
 		virtual ~GfxDriver() { }
 
+		/**
+		 * Sets whether textures, framebuffers, vertex/index buffers and shader programs create OpenGL objects. Programs that render without an OpenGL context, such as ones that only use GfxDriverRecorder, should disable this once at startup, before creating any resources or threads. It's enabled by default.
+		 * @param enabled False to create resources without any OpenGL objects.
+		 */
+		static void setGLEnabled(bool enabled);
+
+		/**
+		 * @return True if resources create OpenGL objects. See setGLEnabled().
+		 */
+		static bool isGLEnabled();
+
 		virtual void flush() = 0;
 
 		virtual void clearBuffers() = 0;
@@ -66,6 +84,26 @@ class GfxDriver {
 		virtual DromeMath::Matrix4 getModelViewMatrix() const = 0;
 		virtual void setModelViewMatrix(const DromeMath::Matrix4 &value) = 0;
 
+		/**
+		 * Saves the current projection matrix. It can be restored with popProjectionMatrix().
+		 */
+		void pushProjectionMatrix();
+
+		/**
+		 * Restores the projection matrix saved by the last call to pushProjectionMatrix().
+		 */
+		void popProjectionMatrix();
+
+		/**
+		 * Saves the current modelview matrix. It can be restored with popModelViewMatrix().
+		 */
+		void pushModelViewMatrix();
+
+		/**
+		 * Restores the modelview matrix saved by the last call to pushModelViewMatrix().
+		 */
+		void popModelViewMatrix();
+
 		virtual DromeMath::Matrix4 getTextureMatrix() const = 0;
 		virtual void setTextureMatrix(const DromeMath::Matrix4 &value) = 0;
 
@@ -73,13 +111,36 @@ class GfxDriver {
 		virtual void enable2D() = 0;
 		virtual void disable2D() = 0;
 
-		virtual void bindTexture(uint8_t textureUnit, DromeCore::RefPtr <Texture> texture) = 0;
-		virtual void bindTexture(DromeCore::RefPtr <Texture> texture);
-		virtual void bindFramebuffer(DromeCore::RefPtr <Framebuffer> framebuffer) = 0;
-		virtual void bindShaderProgram(DromeCore::RefPtr <ShaderProgram> shaderProgram) = 0;
+		virtual void bindTexture(uint8_t textureUnit, const DromeCore::RefPtr <Texture> &texture) = 0;
+		virtual void bindTexture(const DromeCore::RefPtr <Texture> &texture);
+		virtual void bindFramebuffer(const DromeCore::RefPtr <Framebuffer> &framebuffer) = 0;
+		virtual void bindShaderProgram(const DromeCore::RefPtr <ShaderProgram> &shaderProgram) = 0;
 
 	/* Rendering functions */
-		virtual void drawPic(DromeCore::RefPtr <Texture> texture, Color color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest) = 0;
+		virtual void drawPic(const DromeCore::RefPtr <Texture> &texture, Color color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest) = 0;
+
+		/**
+		 * Draws primitives from vertex data in client memory.
+		 * @param type The type of primitives to draw.
+		 * @param numVertices The number of vertices to draw.
+		 * @param vertices Array of numVertices vertex positions.
+		 * @param texCoords Array of numVertices * 2 texture coordinates, or NULL.
+		 * @param colors Array of numVertices colors, or NULL to draw the primitives in white.
+		 */
+		virtual void drawPrimitives(PrimitiveType type, unsigned int numVertices, const DromeMath::Vector3 *vertices, const float *texCoords, const Color *colors) = 0;
+
+		/**
+		 * Draws a mesh. The mesh is taken as a plain pointer so that drawing doesn't change its reference count; the caller must keep it alive for the duration of the call.
+		 */
+		virtual void drawMesh(const Mesh *mesh) = 0;
+
+		/**
+		 * Draws several copies of a mesh. The modelview matrix of each copy is the current modelview matrix * transforms[i]. The default implementation draws each copy with a separate call to drawMesh().
+		 * @param mesh The mesh to draw.
+		 * @param transforms Array of numInstances object transforms.
+		 * @param numInstances The number of copies to draw.
+		 */
+		virtual void drawMeshInstanced(const Mesh *mesh, const DromeMath::Matrix4 *transforms, unsigned int numInstances);
 
 		static GfxDriver *create();
 };
@@ -27,20 +27,119 @@
 #define __DROMEGFX_DRIVER_GL_H__
 
 #include "Driver.h"
+#include "IndexBuffer.h"
+#include "SpriteBatch.h"
 
 namespace DromeGfx {
 
+/**
+ * Counters for the calls made to a GfxDriverGL during a single frame. State changes that would set the state to the value it already has are elided and don't reach OpenGL.
+ */
+class GfxDriverStats {
+	public:
+		unsigned int numStateChanges;
+		unsigned int numElidedStateChanges;
+		unsigned int numTextureBinds;
+		unsigned int numElidedTextureBinds;
+		unsigned int numShaderProgramBinds;
+		unsigned int numElidedShaderProgramBinds;
+		unsigned int numDrawCalls;
+
+		GfxDriverStats() { reset(); }
+
+		void reset()
+		{
+			numStateChanges = numElidedStateChanges = 0;
+			numTextureBinds = numElidedTextureBinds = 0;
+			numShaderProgramBinds = numElidedShaderProgramBinds = 0;
+			numDrawCalls = 0;
+		}
+};
+
 class GfxDriverGL : public GfxDriver {
+	public:
+		static const unsigned int MAX_TEXTURE_UNITS = 16;
+
 	protected:
+		enum ClientArray {
+			CLIENT_ARRAY_VERTEX = 0,
+			CLIENT_ARRAY_NORMAL,
+			CLIENT_ARRAY_COLOR,
+			CLIENT_ARRAY_TEXCOORD0,
+			CLIENT_ARRAY_TEXCOORD1,
+			CLIENT_ARRAY_TEXCOORD2,
+
+			NUM_CLIENT_ARRAYS
+		};
+
 		int m_viewportWidth, m_viewportHeight;
+
+		// shadowed OpenGL state
+		bool m_wireframe;
 		bool m_depthWritesEnabled;
 		DepthMode m_depthMode;
 		BlendMode m_blendMode;
+		CullFace m_cullFace;
+		bool m_savedDepthWritesEnabled;
+		DepthMode m_savedDepthMode;
+
+		// matrices are kept on the CPU side so that reading them
+		// doesn't require a round trip to the GL implementation
+		unsigned int m_matrixMode;
+		DromeMath::Matrix4 m_projectionMatrix;
+		DromeMath::Matrix4 m_modelViewMatrix;
+		DromeMath::Matrix4 m_textureMatrix;
+
+		unsigned int m_activeTextureUnit;
+		unsigned int m_clientActiveTextureUnit;
+		DromeCore::RefPtr <Texture> m_textures[MAX_TEXTURE_UNITS];
+		DromeCore::RefPtr <Framebuffer> m_framebuffer;
+		DromeCore::RefPtr <ShaderProgram> m_shaderProgram;
+		DromeCore::RefPtr <VertexBuffer> m_arrayBuffer;
+		DromeCore::RefPtr <IndexBuffer> m_elementBuffer;
+		bool m_clientArrays[NUM_CLIENT_ARRAYS];
+
+		bool m_instancingSupported;
+		DromeCore::RefPtr <VertexBuffer> m_instanceBuffer;
+
+		bool m_2DEnabled;
+		DromeCore::RefPtr <SpriteBatch> m_spriteBatch;
+		DromeCore::RefPtr <VertexBuffer> m_spriteBuffer;
+
+		GfxDriverStats m_stats;
+		GfxDriverStats m_lastFrameStats;
+
+		bool checkStateChange(bool changed);
+		void setMatrixMode(unsigned int mode);
+		void setActiveTextureUnit(unsigned int textureUnit);
+		void setClientActiveTextureUnit(unsigned int textureUnit);
+		void setClientArrayEnabled(ClientArray array, bool enabled);
+		void bindArrayBuffer(const DromeCore::RefPtr <VertexBuffer> &buffer);
+		void bindElementBuffer(const DromeCore::RefPtr <IndexBuffer> &buffer);
+		void setTexture(unsigned int textureUnit, const DromeCore::RefPtr <Texture> &texture);
+		void flushSprites();
+		void setMeshArrays(const Mesh *mesh);
+		void drawMeshCommands(const Mesh *mesh, unsigned int numInstances);
 
 	public:
 		GfxDriverGL();
 		virtual ~GfxDriverGL();
 
+		/**
+		 * @return Counters for the frame currently being rendered.
+		 */
+		const GfxDriverStats &getStats() const { return m_stats; }
+
+		/**
+		 * @return Counters for the frame that was completed by the last call to flush().
+		 */
+		const GfxDriverStats &getLastFrameStats() const { return m_lastFrameStats; }
+
+		/**
+		 * @return The batch that pictures drawn with drawPic() are accumulated in while 2D mode is enabled. The batch is drawn before any other state change or draw call and when 2D mode is disabled.
+		 */
+		const DromeCore::RefPtr <SpriteBatch> &getSpriteBatch() const { return m_spriteBatch; }
+
 		void flush();
 
 		void clearBuffers();
@@ -71,12 +170,19 @@ class GfxDriverGL : public GfxDriver {
 		void enable2D();
 		void disable2D();
 
-		void bindTexture(uint8_t textureUnit, DromeCore::RefPtr <Texture> texture);
-		void bindFramebuffer(DromeCore::RefPtr <Framebuffer> framebuffer);
-		void bindShaderProgram(DromeCore::RefPtr <ShaderProgram> shaderProgram);
+		void bindTexture(uint8_t textureUnit, const DromeCore::RefPtr <Texture> &texture);
+		void bindFramebuffer(const DromeCore::RefPtr <Framebuffer> &framebuffer);
+		void bindShaderProgram(const DromeCore::RefPtr <ShaderProgram> &shaderProgram);
 
 	/* Rendering functions */
-		void drawPic(DromeCore::RefPtr <Texture> texture, Color color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest);
+		void drawPic(const DromeCore::RefPtr <Texture> &texture, Color color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest);
+		void drawPrimitives(PrimitiveType type, unsigned int numVertices, const DromeMath::Vector3 *vertices, const float *texCoords, const Color *colors);
+		void drawMesh(const Mesh *mesh);
+
+		/**
+		 * Draws several copies of a mesh with a single draw call if the bound shader program has a mat4 attribute named instanceMatrix and OpenGL 3.3 is available. The shader should then compute the modelview matrix of each copy as gl_ModelViewMatrix * instanceMatrix. Otherwise, each copy is drawn separately.
+		 */
+		void drawMeshInstanced(const Mesh *mesh, const DromeMath::Matrix4 *transforms, unsigned int numInstances);
 };
 
 } // namespace DromeGfx
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_DRIVER_RECORDER_H__
+#define __DROMEGFX_DRIVER_RECORDER_H__
+
+#include <vector>
+#include "Driver.h"
+
+namespace DromeGfx {
+
+enum GfxCommandType {
+	GFX_COMMAND_FLUSH = 0,
+	GFX_COMMAND_CLEAR_BUFFERS,
+	GFX_COMMAND_SET_WIREFRAME,
+	GFX_COMMAND_SET_DEPTH_WRITES_ENABLED,
+	GFX_COMMAND_SET_DEPTH_MODE,
+	GFX_COMMAND_SET_BLEND_MODE,
+	GFX_COMMAND_SET_CULL_FACE,
+	GFX_COMMAND_SET_PROJECTION_MATRIX,
+	GFX_COMMAND_SET_MODELVIEW_MATRIX,
+	GFX_COMMAND_SET_TEXTURE_MATRIX,
+	GFX_COMMAND_SET_VIEWPORT_DIMENSIONS,
+	GFX_COMMAND_ENABLE_2D,
+	GFX_COMMAND_DISABLE_2D,
+	GFX_COMMAND_BIND_TEXTURE,
+	GFX_COMMAND_BIND_FRAMEBUFFER,
+	GFX_COMMAND_BIND_SHADER_PROGRAM,
+	GFX_COMMAND_DRAW_PIC,
+	GFX_COMMAND_DRAW_PRIMITIVES,
+	GFX_COMMAND_DRAW_MESH,
+	GFX_COMMAND_DRAW_MESH_INSTANCED,
+
+	NUM_GFX_COMMANDS
+};
+
+/**
+ * A single call made to a GfxDriverRecorder.
+ */
+class GfxCommand {
+	public:
+		GfxCommandType type;
+
+		/**
+		 * True if the command is a state change that set the state to the value it already had.
+		 */
+		bool redundant;
+
+		/**
+		 * Command-specific value, such as the new state for state changes, the texture unit for GFX_COMMAND_BIND_TEXTURE, the color for GFX_COMMAND_DRAW_PIC, the number of vertices for GFX_COMMAND_DRAW_PRIMITIVES, the number of submitted indices for GFX_COMMAND_DRAW_MESH or the number of instances for GFX_COMMAND_DRAW_MESH_INSTANCED.
+		 */
+		uint32_t value;
+
+		/**
+		 * The texture, framebuffer, shader program or mesh the command refers to, if any. This is only used to identify the object and isn't reference counted.
+		 */
+		const void *object;
+};
+
+/**
+ * The GfxDriverRecorder class is a GfxDriver that doesn't render anything. Instead, it stores every call made to it in an in-memory command log, which makes it possible to exercise and profile rendering code on machines without an OpenGL context. Programs that use a recorder without an OpenGL context should call GfxDriver::setGLEnabled(false) before creating any textures, buffers or shader programs.
+ */
+class GfxDriverRecorder : public GfxDriver {
+	public:
+		static const unsigned int MAX_TEXTURE_UNITS = 16;
+
+	protected:
+		std::vector <GfxCommand> m_commands;
+		unsigned int m_commandCounts[NUM_GFX_COMMANDS];
+		unsigned int m_numRedundantCommands;
+		unsigned int m_numFrames;
+
+		int m_viewportWidth, m_viewportHeight;
+		bool m_wireframe;
+		bool m_depthWritesEnabled;
+		DepthMode m_depthMode;
+		BlendMode m_blendMode;
+		CullFace m_cullFace;
+
+		DromeMath::Matrix4 m_projectionMatrix;
+		DromeMath::Matrix4 m_modelViewMatrix;
+		DromeMath::Matrix4 m_textureMatrix;
+
+		DromeCore::RefPtr <Texture> m_textures[MAX_TEXTURE_UNITS];
+		DromeCore::RefPtr <Framebuffer> m_framebuffer;
+		DromeCore::RefPtr <ShaderProgram> m_shaderProgram;
+
+		void record(GfxCommandType type, bool redundant = false, uint32_t value = 0, const void *object = 0);
+
+	public:
+		GfxDriverRecorder();
+		virtual ~GfxDriverRecorder();
+
+		/**
+		 * @return The number of commands recorded since the last call to clear().
+		 */
+		unsigned int getNumCommands() const { return (unsigned int)m_commands.size(); }
+
+		/**
+		 * @param type The type of command to count.
+		 * @return The number of commands of the given type recorded since the last call to clear().
+		 */
+		unsigned int getNumCommands(GfxCommandType type) const { return m_commandCounts[type]; }
+
+		/**
+		 * @return The number of state changes recorded since the last call to clear() that didn't change any state.
+		 */
+		unsigned int getNumRedundantCommands() const { return m_numRedundantCommands; }
+
+		/**
+		 * @return The number of calls to flush() since the last call to clear().
+		 */
+		unsigned int getNumFrames() const { return m_numFrames; }
+
+		const GfxCommand &getCommand(unsigned int index) const { return m_commands[index]; }
+		const std::vector <GfxCommand> &getCommands() const { return m_commands; }
+
+		/**
+		 * Empties the command log and resets all counters. The current driver state is kept.
+		 */
+		void clear();
+
+		void flush();
+
+		void clearBuffers();
+		void setWireframe(bool enabled);
+
+		bool getDepthWritesEnabled() const;
+		void setDepthWritesEnabled(bool value);
+
+		DepthMode getDepthMode() const;
+		void setDepthMode(DepthMode value);
+
+		BlendMode getBlendMode() const;
+		void setBlendMode(BlendMode value);
+
+		void setCullFace(CullFace value);
+
+	/* Matrix functions */
+		DromeMath::Matrix4 getProjectionMatrix() const;
+		void setProjectionMatrix(const DromeMath::Matrix4 &m);
+
+		DromeMath::Matrix4 getModelViewMatrix() const;
+		void setModelViewMatrix(const DromeMath::Matrix4 &m);
+
+		DromeMath::Matrix4 getTextureMatrix() const;
+		void setTextureMatrix(const DromeMath::Matrix4 &m);
+
+		void setViewportDimensions(int width, int height);
+		void enable2D();
+		void disable2D();
+
+		void bindTexture(uint8_t textureUnit, const DromeCore::RefPtr <Texture> &texture);
+		void bindFramebuffer(const DromeCore::RefPtr <Framebuffer> &framebuffer);
+		void bindShaderProgram(const DromeCore::RefPtr <ShaderProgram> &shaderProgram);
+
+	/* Rendering functions */
+		void drawPic(const DromeCore::RefPtr <Texture> &texture, Color color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest);
+		void drawPrimitives(PrimitiveType type, unsigned int numVertices, const DromeMath::Vector3 *vertices, const float *texCoords, const Color *colors);
+		void drawMesh(const Mesh *mesh);
+		void drawMeshInstanced(const Mesh *mesh, const DromeMath::Matrix4 *transforms, unsigned int numInstances);
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_DRIVER_RECORDER_H__ */
@@ -140,6 +140,12 @@ class Image : public DromeCore::RefClass {
 		virtual ~Image();
 
 	public:
+		/**
+		 * Image objects are allocated from an ObjectPool; see DromeCore::ObjectPool.
+		 */
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
 		std::string getFilename() const;
 		const uint8_t *getData() const;
 		unsigned int getWidth() const;
@@ -148,7 +154,7 @@ class Image : public DromeCore::RefClass {
 
 		Color getPixel(unsigned int x, unsigned int y) const;
 		void setPixel(unsigned int x, unsigned int y, Color c);
-		void copyFrom(DromeCore::RefPtr <Image> image);
+		void copyFrom(const DromeCore::RefPtr <Image> &image);
 
 		DromeCore::RefPtr <Image> scale(unsigned int width, unsigned int height);
 
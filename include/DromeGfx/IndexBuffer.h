@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_INDEXBUFFER_H__
+#define __DROMEGFX_INDEXBUFFER_H__
+
+#include <DromeCore/Ref.h>
+
+namespace DromeGfx {
+
+/**
+ * The IndexBuffer class stores 16-bit vertex indices in GPU memory.
+ */
+class IndexBuffer : public DromeCore::RefClass
+{
+	protected:
+		unsigned int m_id;
+		int m_size;
+
+		IndexBuffer(const unsigned short *data, int size);
+		virtual ~IndexBuffer();
+
+	public:
+		/**
+		 * IndexBuffer objects are allocated from an ObjectPool; see DromeCore::ObjectPool.
+		 */
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
+		unsigned int getId() const;
+
+		/**
+		 * @return The number of indices in the buffer.
+		 */
+		int getSize() const;
+
+		static DromeCore::RefPtr <IndexBuffer> none();
+		static DromeCore::RefPtr <IndexBuffer> create(const unsigned short *data, int size);
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_INDEXBUFFER_H__ */
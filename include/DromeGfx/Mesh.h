@@ -28,43 +28,93 @@
 
 #include <vector>
 #include <DromeCore/Ref.h>
+#include <DromeMath/Matrix4.h>
 #include <DromeMath/Vector3.h>
+#include "IndexBuffer.h"
 #include "Types.h"
 #include "VertexBuffer.h"
+#include "VertexLayout.h"
 
 namespace DromeGfx {
 
+class GfxDriver;
+
 class Mesh : public DromeCore::RefClass
 {
-	protected:
+	public:
 		class Command
 		{
 			public:
 				PrimitiveType type;
-				DromeCore::RefPtr <VertexBuffer> texCoords;
 				unsigned short *indices;
 				unsigned int numIndices;
 
+				/**
+				 * Position of the command's first index in the mesh's index buffer.
+				 */
+				unsigned int firstIndex;
+
 				Command();
 				Command(unsigned int numIndicesParam);
 				virtual ~Command();
 		};
 
-		DromeMath::Vector3 *m_vertexData;
-		DromeMath::Vector3 *m_tangentSpaceData;
-
-		DromeCore::RefPtr <VertexBuffer> m_vertices;
-		DromeCore::RefPtr <VertexBuffer> m_texCoords;
-		DromeCore::RefPtr <VertexBuffer> m_tangentSpace;
+	protected:
+		DromeCore::RefPtr <VertexBuffer> m_vertexBuffer;
+		VertexLayout m_vertexLayout;
 		unsigned int m_numVertices;
 
 		std::vector <Command *> m_commands;
+		DromeCore::RefPtr <IndexBuffer> m_indexBuffer;
 
 		Mesh();
 		virtual ~Mesh();
 
+		/**
+		 * Creates the vertex buffer of the mesh from interleaved vertices.
+		 * @param data Array of numVertices vertices.
+		 * @param numVertices The number of vertices.
+		 * @param layout The layout of each vertex. Its stride must be a multiple of four bytes.
+		 */
+		void setVertices(const void *data, unsigned int numVertices, const VertexLayout &layout);
+		void setVertices(const std::vector <MeshVertex> &vertices);
+
+		/**
+		 * Copies the indices of all commands into a single index buffer, so that they don't have to be sent to the GPU each time the mesh is drawn.
+		 */
+		void createIndexBuffer();
+
 	public:
-		void render();
+		/**
+		 * Mesh objects are allocated from an ObjectPool; see DromeCore::ObjectPool.
+		 */
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
+		const DromeCore::RefPtr <VertexBuffer> &getVertexBuffer() const { return m_vertexBuffer; }
+		const VertexLayout &getVertexLayout() const { return m_vertexLayout; }
+		unsigned int getNumVertices() const { return m_numVertices; }
+
+		unsigned int getNumCommands() const { return (unsigned int)m_commands.size(); }
+		const Command *getCommand(unsigned int index) const { return m_commands[index]; }
+
+		/**
+		 * @return The buffer containing the indices of all commands, or a null pointer if the indices are only stored in client memory.
+		 */
+		const DromeCore::RefPtr <IndexBuffer> &getIndexBuffer() const { return m_indexBuffer; }
+
+		/**
+		 * Converts all triangle strip, triangle fan and triangle list commands into a single triangle list command and stores its indices in an index buffer, so that the mesh can be drawn with a single draw call. Degenerate triangles are removed.
+		 */
+		void bake();
+
+		void render(GfxDriver *driver);
+
+		/**
+		 * Draws numInstances copies of the mesh with a single call if the driver supports it.
+		 * @see GfxDriver::drawMeshInstanced()
+		 */
+		void renderInstanced(GfxDriver *driver, const DromeMath::Matrix4 *transforms, unsigned int numInstances);
 };
 
 } // namespace DromeGfx
@@ -27,71 +27,60 @@
 #define __DROMEGFX_PARTICLEEMITTER_H__
 
 #include <vector>
+#include <DromeCore/JobSystem.h>
+#include <DromeCore/Random.h>
 #include <DromeCore/Ref.h>
 #include "Driver.h"
 
 namespace DromeGfx {
 
-class Particle : public DromeCore::RefClass
+/**
+ * The ParticleEmitter class emits textured particles that face the viewer. The state of the particles is kept in one array per property so that updating them doesn't need any per-particle allocation or indirection. Particles that fade out are removed by moving the last particle into their place, and all particles are drawn with a single draw call.
+ *
+ * Given a JobSystem, cycle() updates fixed-size ranges of particles on several threads. Particles are still emitted and removed on the calling thread in the same order, so the result doesn't depend on the number of threads.
+ *
+ * Each emitter has its own random number generator, so seeding it with getRandom().seed() makes the emitted particles reproducible.
+ */
+class ParticleEmitter : public DromeCore::RefClass
 {
 	protected:
-		bool m_done;
-
 		DromeMath::Vector3 m_position;
-		DromeMath::Vector3 m_velocity;
-		float m_rotation;
 		float m_width;
 		float m_height;
 
 		Color m_color;
+		DromeCore::RefPtr <Texture> m_texture;
 
-		Particle();
-		virtual ~Particle() { }
-
-	public:
-		bool isDone() const { return m_done; }
-
-		DromeMath::Vector3 getPosition() const { return m_position; }
-		void setPosition(const DromeMath::Vector3 &value) { m_position = value; }
-
-		DromeMath::Vector3 getVelocity() const { return m_velocity; }
-		void setVelocity(const DromeMath::Vector3 &value) { m_velocity = value; }
-
-		float getRotation() const { return m_rotation; }
-		void setRotation(float value) { m_rotation = value; }
-
-		float getWidth() const { return m_width; }
-		void setWidth(float value) { m_width = value; }
-
-		float getHeight() const { return m_height; }
-		void setHeight(float value) { m_height = value; }
-
-		Color getColor() const { return m_color; }
-		void setColor(const Color &value) { m_color = value; }
+		float m_particlesPerSecond;
+		float m_timeRemainder;
+		DromeCore::Random m_random;
 
-		void render(DromeGfx::GfxDriver *driver);
-		void cycle(float secondsElapsed);
+		// particle state, one element per live particle
+		std::vector <float> m_positionX, m_positionY, m_positionZ;
+		std::vector <float> m_velocityX, m_velocityY, m_velocityZ;
+		std::vector <float> m_rotations;
+		std::vector <float> m_sizes;
+		std::vector <float> m_alphas;
+		std::vector <Color> m_colors;
 
-		static DromeCore::RefPtr <Particle> create();
-};
+		// indices of particles that faded out during the last cycle
+		std::vector <unsigned int> m_deadParticles;
 
-class ParticleEmitter : public DromeCore::RefClass
-{
-	protected:
-		DromeMath::Vector3 m_position;
-		float m_width;
-		float m_height;
+		// number of dead particles found in each range of particles
+		std::vector <unsigned int> m_numDeadInRange;
 
-		Color m_color;
-		DromeCore::RefPtr <Texture> m_texture;
+		DromeCore::RefPtr <DromeCore::JobSystem> m_jobSystem;
 
-		std::vector < DromeCore::RefPtr <Particle> > m_particles;
-		float m_particlesPerSecond;
-		float m_timeRemainder;
+		// texture coordinates used for drawing, which are the same every frame; the
+		// other vertex arrays are allocated from the frame allocator while drawing
+		std::vector <float> m_texCoords;
 
 		ParticleEmitter();
 		virtual ~ParticleEmitter() { }
 
+		void emitParticles(unsigned int numParticles);
+		void removeParticle(unsigned int index);
+
 	public:
 		DromeMath::Vector3 getPosition() const { return m_position; }
 		void setPosition(const DromeMath::Vector3 &value) { m_position = value; }
@@ -105,17 +94,54 @@ class ParticleEmitter : public DromeCore::RefClass
 		Color getColor() const { return m_color; }
 		void setColor(const Color &value) { m_color = value; }
 
-		DromeCore::RefPtr <Texture> getTexture() const { return m_texture; }
-		void setTexture(DromeCore::RefPtr <Texture> value) { m_texture = value; }
+		const DromeCore::RefPtr <Texture> &getTexture() const { return m_texture; }
+		void setTexture(const DromeCore::RefPtr <Texture> &value) { m_texture = value; }
 
 		float getParticlesPerSecond() const { return m_particlesPerSecond; }
 		void setParticlesPerSecond(float value) { m_particlesPerSecond = value; }
 
-		DromeCore::RefPtr <Particle> createParticle();
+		/**
+		 * @return The generator used to pick the direction, rotation and size of new particles.
+		 */
+		DromeCore::Random &getRandom() { return m_random; }
+
+		const DromeCore::RefPtr <DromeCore::JobSystem> &getJobSystem() const { return m_jobSystem; }
+
+		/**
+		 * Sets the job system used to update particles in parallel.
+		 *
+		 * @param value The job system to use, or NULL to update all particles on the calling thread.
+		 */
+		void setJobSystem(const DromeCore::RefPtr <DromeCore::JobSystem> &value) { m_jobSystem = value; }
+
+		/**
+		 * @return The number of live particles.
+		 */
+		unsigned int getNumParticles() const { return (unsigned int)m_alphas.size(); }
+
+		/**
+		 * Allocates memory for the given number of particles, so that no allocation is needed until there are more live particles.
+		 *
+		 * @param numParticles The number of particles to allocate memory for.
+		 */
+		void reserve(unsigned int numParticles);
+
 		void render(DromeGfx::GfxDriver *driver);
 		void cycle(float secondsElapsed);
 
 		static DromeCore::RefPtr <ParticleEmitter> create();
+
+		/**
+		 * Sets whether cycle() may use SSE or AVX instructions to update several particles at once. The widest instruction set supported by the CPU is used unless this is disabled.
+		 *
+		 * @param value False to update particles one at a time.
+		 */
+		static void setSimdEnabled(bool value);
+
+		/**
+		 * @return The name of the instruction set used by cycle(): "AVX", "SSE" or "scalar".
+		 */
+		static const char *getInstructionSetName();
 };
 
 } // namespace DromeGfx
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_RENDERQUEUE_H__
+#define __DROMEGFX_RENDERQUEUE_H__
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include <DromeCore/Ref.h>
+#include <DromeMath/Matrix4.h>
+#include "Driver.h"
+#include "Mesh.h"
+
+namespace DromeGfx {
+
+/**
+ * A mesh to be drawn by a RenderQueue, along with the state needed to draw it.
+ */
+class RenderItem
+{
+	public:
+		static const unsigned int MAX_TEXTURES = 4;
+
+		DromeCore::RefPtr <Mesh> mesh;
+
+		/**
+		 * Textures to bind to the first texture units. The first texture is used for sorting.
+		 */
+		DromeCore::RefPtr <Texture> textures[MAX_TEXTURES];
+		DromeCore::RefPtr <ShaderProgram> shaderProgram;
+		DromeCore::RefPtr <Framebuffer> framebuffer;
+
+		/**
+		 * The object transform. The modelview matrix used to draw the item is the view matrix passed to RenderQueue::execute() * transform.
+		 */
+		DromeMath::Matrix4 transform;
+
+		/**
+		 * Distance from the viewer, used to draw opaque items front to back and translucent items back to front.
+		 */
+		float depth;
+
+		/**
+		 * Translucent items are drawn after the opaque items of the same framebuffer, with depth writes disabled.
+		 */
+		bool translucent;
+
+		RenderItem();
+};
+
+/**
+ * The RenderQueue class collects RenderItems and draws them in an order that minimizes state changes. Each item is given a 64-bit sort key made of, from the most to the least significant bits, the framebuffer, whether the item is translucent and then either the shader program, texture and depth (front to back) for opaque items or the depth (back to front), shader program and texture for translucent items. The keys are sorted with a radix sort.
+ */
+class RenderQueue : public DromeCore::RefClass
+{
+	protected:
+		std::vector <RenderItem> m_items;
+
+		// sort keys and the indices of the items they belong to
+		std::vector <uint64_t> m_keys, m_keysScratch;
+		std::vector <uint32_t> m_order, m_orderScratch;
+		bool m_sorted;
+
+		// small ids for the objects used in sort keys,
+		// assigned in order of first appearance
+		std::map <const void *, uint32_t> m_framebufferIds;
+		std::map <const void *, uint32_t> m_shaderProgramIds;
+		std::map <const void *, uint32_t> m_textureIds;
+
+		float m_minDepth, m_maxDepth;
+
+		RenderQueue();
+		virtual ~RenderQueue();
+
+		uint64_t makeKey(const RenderItem &item);
+
+	public:
+		/**
+		 * Sets the range of depths that sort keys can distinguish. Depths outside the range are clamped.
+		 */
+		void setDepthRange(float minDepth, float maxDepth);
+
+		void add(const RenderItem &item);
+
+		unsigned int getNumItems() const { return (unsigned int)m_items.size(); }
+
+		/**
+		 * @param index The position of the item in drawing order. sort() must have been called after the last item was added.
+		 */
+		const RenderItem &getSortedItem(unsigned int index) const { return m_items[m_order[index]]; }
+
+		/**
+		 * Sorts the items into drawing order. This is done automatically by execute().
+		 */
+		void sort();
+
+		/**
+		 * Draws all items in sorted order. The driver's current framebuffer, shader program, modelview matrix and depth write state are changed.
+		 * @param driver The driver to draw with.
+		 * @param view The view matrix, such as the matrix of a Camera.
+		 */
+		void execute(GfxDriver *driver, const DromeMath::Matrix4 &view);
+
+		/**
+		 * Removes all items. Allocated memory is kept for reuse.
+		 */
+		void clear();
+
+		static DromeCore::RefPtr <RenderQueue> create();
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_RENDERQUEUE_H__ */
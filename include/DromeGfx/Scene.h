@@ -35,6 +35,14 @@ class Scene : public DromeCore::EventHandler {
 	public:
 		virtual void cycle(float secondsElapsed) = 0;
 		virtual void render(GfxDriver *driver) = 0;
+
+		/**
+		 * Renders the scene between the states of the last two cycles. The default implementation ignores alpha and renders the current state.
+		 *
+		 * @param driver The driver to render with.
+		 * @param alpha The fraction of a time step that has elapsed since the last cycle, as passed to EventHandler::renderFrame().
+		 */
+		virtual void render(GfxDriver *driver, float /*alpha*/) { render(driver); }
 };
 
 } // namespace DromeGfx
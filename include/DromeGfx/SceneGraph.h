@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_SCENEGRAPH_H__
+#define __DROMEGFX_SCENEGRAPH_H__
+
+#include <vector>
+#include <DromeCore/Ref.h>
+#include <DromeMath/Frustum.h>
+#include <DromeMath/Matrix4.h>
+#include <DromeMath/Transform.h>
+#include <DromeMath/Vector3.h>
+
+namespace DromeGfx {
+
+/**
+ * \brief A node of a SceneGraph.
+ */
+class SceneGraphNode
+{
+	public:
+		/**
+		 * The id the node was given by SceneGraph::addNode(), which doesn't change when the nodes are reordered.
+		 */
+		unsigned int id;
+
+		/**
+		 * Index of the parent node in the graph's node order, or SceneGraph::INVALID_INDEX for root nodes.
+		 */
+		unsigned int parent;
+
+		/**
+		 * The number of ancestors of the node.
+		 */
+		unsigned int depth;
+
+		DromeMath::Transform transform;
+		DromeMath::Matrix4 worldMatrix;
+
+		/**
+		 * The node's own bounds in local space, if hasBounds is set, and in world space.
+		 */
+		DromeMath::Vector3 min, max;
+		DromeMath::Vector3 worldMin, worldMax;
+		bool hasBounds;
+
+		/**
+		 * The world space bounds of the node and all of its descendants, if hasSubtreeBounds is set.
+		 */
+		DromeMath::Vector3 subtreeMin, subtreeMax;
+		bool hasSubtreeBounds;
+
+		/**
+		 * Set when the world matrix needs to be recalculated, and when the subtree bounds do.
+		 */
+		bool isDirty, isBoundsDirty;
+};
+
+/**
+ * The SceneGraph class holds a hierarchy of nodes, each with a Transform relative to its parent and optional bounds, and calculates their world matrices and bounds.
+ *
+ * The nodes are stored in a flat array sorted by depth, so that update() visits every parent before its children in one pass over memory. Only the nodes whose transform or bounds changed since the last update, and their descendants, are recalculated, so a static scene costs nothing to update. The bounds of each node include those of its descendants, so that query() can skip whole subtrees outside a frustum.
+ */
+class SceneGraph : public DromeCore::RefClass
+{
+	public:
+		static const unsigned int INVALID_INDEX = 0xffffffff;
+
+	protected:
+		std::vector <SceneGraphNode> m_nodes;
+
+		// the index in m_nodes of the node with each id
+		std::vector <unsigned int> m_indices;
+
+		bool m_isSorted;
+		bool m_isDirty;
+		unsigned int m_numUpdatedNodes;
+
+		SceneGraph();
+		virtual ~SceneGraph();
+
+		void markBoundsDirty(unsigned int index);
+		void sortNodes();
+
+	public:
+		/**
+		 * Adds a node to the graph.
+		 *
+		 * @param transform The transform of the node relative to its parent.
+		 * @param parent The id of the parent node, or INVALID_INDEX for a root node.
+		 * @return The id of the new node. Ids are assigned in order from 0.
+		 */
+		unsigned int addNode(const DromeMath::Transform &transform, unsigned int parent = INVALID_INDEX);
+
+		unsigned int getNumNodes() const { return (unsigned int)m_nodes.size(); }
+
+		/**
+		 * @param node The id of a node.
+		 * @return The id of the node's parent, or INVALID_INDEX for a root node.
+		 */
+		unsigned int getParent(unsigned int node) const;
+
+		/**
+		 * Moves a node and its descendants under another parent.
+		 *
+		 * @param node The id of the node to move.
+		 * @param parent The id of the new parent node, or INVALID_INDEX to make the node a root node. It must not be the node or one of its descendants.
+		 */
+		void setParent(unsigned int node, unsigned int parent);
+
+		const DromeMath::Transform &getTransform(unsigned int node) const { return m_nodes[m_indices[node]].transform; }
+
+		/**
+		 * Sets the transform of a node relative to its parent. The world matrices and bounds of the node and its descendants are recalculated by the next update().
+		 */
+		void setTransform(unsigned int node, const DromeMath::Transform &transform);
+
+		/**
+		 * Sets the bounds of a node in its local space, such as the bounds of its mesh. Nodes without bounds, such as groups, are only visible through their descendants.
+		 *
+		 * @param node The id of the node.
+		 * @param min The minimum corner of the bounds.
+		 * @param max The maximum corner of the bounds.
+		 */
+		void setBounds(unsigned int node, const DromeMath::Vector3 &min, const DromeMath::Vector3 &max);
+
+		/**
+		 * Removes the bounds of a node.
+		 */
+		void clearBounds(unsigned int node);
+
+		/**
+		 * @param node The id of a node.
+		 * @return The matrix that transforms from the node's local space to world space, as of the last update().
+		 */
+		const DromeMath::Matrix4 &getWorldMatrix(unsigned int node) const { return m_nodes[m_indices[node]].worldMatrix; }
+
+		/**
+		 * Gets the world space bounds of a node and all of its descendants, as of the last update().
+		 *
+		 * @return False if neither the node nor any of its descendants has bounds.
+		 */
+		bool getWorldBounds(unsigned int node, DromeMath::Vector3 &min, DromeMath::Vector3 &max) const;
+
+		/**
+		 * Recalculates the world matrices and bounds of the nodes that changed since the last update and of their descendants.
+		 */
+		void update();
+
+		/**
+		 * @return The number of world matrices recalculated by the last update().
+		 */
+		unsigned int getNumUpdatedNodes() const { return m_numUpdatedNodes; }
+
+		/**
+		 * Finds the nodes whose own bounds may be inside a frustum, skipping the descendants of nodes whose bounds are outside it. update() must have been called after the last change.
+		 *
+		 * @param frustum The frustum to test.
+		 * @param results Vector to append the ids of the nodes to, in order of depth.
+		 */
+		void query(const DromeMath::Frustum &frustum, std::vector <unsigned int> &results) const;
+
+		static DromeCore::RefPtr <SceneGraph> create();
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_SCENEGRAPH_H__ */
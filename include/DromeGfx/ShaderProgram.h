@@ -37,6 +37,7 @@ class ShaderProgram : public DromeCore::RefClass
 {
 	protected:
 		unsigned int m_id;
+		int m_instanceMatrixLocation;
 
 		ShaderProgram();
 		virtual ~ShaderProgram();
@@ -56,6 +57,18 @@ class ShaderProgram : public DromeCore::RefClass
 		void linkShaders();
 
 		int getUniformVariableLocation(const char *name) const;
+
+		/**
+		 * @param name The name of a vertex attribute.
+		 * @return The location of the attribute, or -1 if the linked program has no active attribute with the given name.
+		 */
+		int getAttributeLocation(const char *name) const;
+
+		/**
+		 * @return The location of the mat4 instanceMatrix attribute used for hardware instancing, or -1 if the program has none. The location is looked up when the program is linked; see GfxDriverGL::drawMeshInstanced().
+		 */
+		int getInstanceMatrixLocation() const { return m_instanceMatrixLocation; }
+
 		void setUniform(const char *name, int value);
 		void setUniform(const char *name, const DromeMath::Vector3 *values, int numValues);
 		void setUniform(const char *name, const DromeMath::Vector3 &value);
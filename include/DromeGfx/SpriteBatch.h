@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_SPRITEBATCH_H__
+#define __DROMEGFX_SPRITEBATCH_H__
+
+#include <vector>
+#include <DromeCore/Ref.h>
+#include <DromeMath/Rect2i.h>
+#include "Image.h"
+#include "Texture.h"
+
+namespace DromeGfx {
+
+/**
+ * A vertex of a sprite quad, laid out for direct upload to a vertex buffer.
+ */
+struct SpriteVertex
+{
+	float x, y;
+	float s, t;
+	Color color;
+};
+
+/**
+ * The SpriteBatch class accumulates textured 2D quads so that they can be drawn with as few draw calls as possible. Consecutive quads that use the same texture are merged into a single batch.
+ */
+class SpriteBatch : public DromeCore::RefClass
+{
+	public:
+		/**
+		 * A range of quads that use the same texture.
+		 */
+		struct Batch
+		{
+			DromeCore::RefPtr <Texture> texture;
+			unsigned int firstVertex;
+			unsigned int numVertices;
+		};
+
+		/**
+		 * The number of vertices used for each quad. Quads are stored as two independent triangles.
+		 */
+		static const unsigned int VERTICES_PER_QUAD = 6;
+
+	protected:
+		std::vector <SpriteVertex> m_vertices;
+		std::vector <Batch> m_batches;
+		bool m_sortByTexture;
+
+		SpriteBatch();
+		virtual ~SpriteBatch();
+
+	public:
+		bool isEmpty() const { return m_vertices.empty(); }
+		unsigned int getNumQuads() const { return (unsigned int)m_vertices.size() / VERTICES_PER_QUAD; }
+		unsigned int getNumBatches() const { return (unsigned int)m_batches.size(); }
+
+		const SpriteVertex *getVertices() const { return m_vertices.empty() ? 0 : &m_vertices[0]; }
+		unsigned int getNumVertices() const { return (unsigned int)m_vertices.size(); }
+		const Batch &getBatch(unsigned int index) const { return m_batches[index]; }
+
+		bool getSortByTexture() const { return m_sortByTexture; }
+
+		/**
+		 * Sets whether sort() groups quads by texture. Sorting reduces the number of batches, but changes the order in which overlapping quads that use different textures are drawn, so it's disabled by default.
+		 */
+		void setSortByTexture(bool value) { m_sortByTexture = value; }
+
+		/**
+		 * Adds a quad to the batch.
+		 * @param texture The texture to draw the quad with, or a null pointer for an untextured quad.
+		 * @param color The color to multiply the texture by.
+		 * @param src The source rectangle in the texture, in pixels.
+		 * @param dest The destination rectangle on the screen, in pixels.
+		 */
+		void addQuad(const DromeCore::RefPtr <Texture> &texture, const Color &color, const DromeMath::Rect2i &src, const DromeMath::Rect2i &dest);
+
+		/**
+		 * Groups the quads by texture and merges the resulting batches if sorting is enabled. Quads that use the same texture keep their relative order.
+		 */
+		void sort();
+
+		/**
+		 * Removes all quads. Allocated memory is kept for reuse.
+		 */
+		void clear();
+
+		static DromeCore::RefPtr <SpriteBatch> create();
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_SPRITEBATCH_H__ */
@@ -38,16 +38,22 @@ class Texture : public DromeCore::RefClass
 		unsigned int m_width, m_height;
 
 		Texture();
-		Texture(DromeCore::RefPtr <Image> image);
+		Texture(const DromeCore::RefPtr <Image> &image);
 		virtual ~Texture();
 
 	public:
+		/**
+		 * Texture objects are allocated from an ObjectPool; see DromeCore::ObjectPool.
+		 */
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
 		unsigned int getId() const;
 		unsigned int getWidth() const;
 		unsigned int getHeight() const;
 
 		static DromeCore::RefPtr <Texture> none();
-		static DromeCore::RefPtr <Texture> create(DromeCore::RefPtr <Image> image);
+		static DromeCore::RefPtr <Texture> create(const DromeCore::RefPtr <Image> &image);
 };
 
 } // namespace DromeGfx
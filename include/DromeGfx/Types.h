@@ -54,12 +54,19 @@ enum PrimitiveType {
 	PRIMITIVE_TYPE_TRIANGLE_FAN
 };
 
+enum VertexBufferUsage {
+	VERTEX_BUFFER_USAGE_STATIC = 0,
+	VERTEX_BUFFER_USAGE_DYNAMIC,
+	VERTEX_BUFFER_USAGE_STREAM
+};
+
 enum ShaderType {
 	SHADER_TYPE_VERTEX = 0,
 	SHADER_TYPE_FRAGMENT
 };
 
 unsigned int primitiveTypeToGL(PrimitiveType type);
+unsigned int vertexBufferUsageToGL(VertexBufferUsage usage);
 
 } // namespace DromeGfx
 
@@ -29,6 +29,7 @@
 #include <DromeCore/Ref.h>
 #include <DromeMath/Vector3.h>
 #include <DromeMath/Matrix4.h>
+#include "Types.h"
 
 namespace DromeGfx {
 
@@ -36,15 +37,55 @@ class VertexBuffer : public DromeCore::RefClass
 {
 	protected:
 		unsigned int m_id;
+		int m_size;
+		VertexBufferUsage m_usage;
 
-		VertexBuffer(const float *data, int size);
+		VertexBuffer(const float *data, int size, VertexBufferUsage usage);
 		virtual ~VertexBuffer();
 
 	public:
+		/**
+		 * VertexBuffer objects are allocated from an ObjectPool; see DromeCore::ObjectPool.
+		 */
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
 		unsigned int getId() const;
 
+		/**
+		 * @return The size of the buffer, in floats.
+		 */
+		int getSize() const;
+
+		VertexBufferUsage getUsage() const;
+
+		/**
+		 * Replaces the contents of the buffer. The previous storage is orphaned, so this doesn't wait for draw calls that are still using the old contents.
+		 * @param data Array of size floats to copy into the buffer, or NULL to leave the new contents undefined.
+		 * @param size The new size of the buffer, in floats.
+		 */
+		void setData(const float *data, int size);
+
+		/**
+		 * Like setData(), but the buffer must already be bound to GL_ARRAY_BUFFER, so the previous binding doesn't have to be read back and restored. GfxDriverGL binds buffers through its state cache and then uses this for per-frame uploads.
+		 */
+		void setBoundData(const float *data, int size);
+
+		/**
+		 * Overwrites part of the contents of the buffer.
+		 * @param offset Offset into the buffer, in floats.
+		 * @param data Array of size floats to copy into the buffer.
+		 * @param size The number of floats to copy.
+		 */
+		void setSubData(int offset, const float *data, int size);
+
+		/**
+		 * Like setSubData(), but the buffer must already be bound to GL_ARRAY_BUFFER.
+		 */
+		void setBoundSubData(int offset, const float *data, int size);
+
 		static DromeCore::RefPtr <VertexBuffer> none();
-		static DromeCore::RefPtr <VertexBuffer> create(const float *data, int size);
+		static DromeCore::RefPtr <VertexBuffer> create(const float *data, int size, VertexBufferUsage usage = VERTEX_BUFFER_USAGE_STATIC);
 		static DromeCore::RefPtr <VertexBuffer> create(const DromeMath::Vector3 *data, int size);
 		static DromeCore::RefPtr <VertexBuffer> create(const DromeMath::Matrix4 *data, int size);
 };
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_VERTEXLAYOUT_H__
+#define __DROMEGFX_VERTEXLAYOUT_H__
+
+#include <DromeMath/Vector3.h>
+
+namespace DromeGfx {
+
+enum VertexAttribute {
+	VERTEX_ATTRIBUTE_POSITION = 0,
+	VERTEX_ATTRIBUTE_TEXCOORD,
+	VERTEX_ATTRIBUTE_TANGENT,
+	VERTEX_ATTRIBUTE_BINORMAL,
+	VERTEX_ATTRIBUTE_NORMAL,
+
+	NUM_VERTEX_ATTRIBUTES
+};
+
+/**
+ * The interleaved vertex format used by the built-in meshes.
+ */
+struct MeshVertex
+{
+	DromeMath::Vector3 position;
+	float s, t;
+	DromeMath::Vector3 tangent;
+	DromeMath::Vector3 binormal;
+	DromeMath::Vector3 normal;
+};
+
+/**
+ * The VertexLayout class describes where each attribute is stored in an interleaved vertex. Positions are three floats, texture coordinates are two floats and tangents, binormals and normals are three floats each.
+ */
+class VertexLayout
+{
+	protected:
+		unsigned int m_stride;
+		int m_offsets[NUM_VERTEX_ATTRIBUTES];
+
+	public:
+		/**
+		 * Creates an empty layout with the given stride.
+		 * @param stride The size of a vertex, in bytes.
+		 */
+		VertexLayout(unsigned int stride = 0);
+
+		unsigned int getStride() const { return m_stride; }
+
+		bool hasAttribute(VertexAttribute attribute) const { return m_offsets[attribute] >= 0; }
+
+		/**
+		 * @return The offset of the attribute from the start of a vertex in bytes, or -1 if the layout doesn't contain the attribute.
+		 */
+		int getOffset(VertexAttribute attribute) const { return m_offsets[attribute]; }
+
+		/**
+		 * Adds an attribute to the layout.
+		 * @param attribute The attribute to add.
+		 * @param offset The offset of the attribute from the start of a vertex, in bytes.
+		 */
+		void setAttribute(VertexAttribute attribute, unsigned int offset);
+
+		/**
+		 * @return The layout of the MeshVertex struct.
+		 */
+		static VertexLayout meshVertex();
+};
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_VERTEXLAYOUT_H__ */
@@ -60,7 +60,7 @@ class Font : public DromeCore::RefClass
 	public:
 		unsigned int getWidth() const { return m_width; }
 		unsigned int getHeight() const { return m_height; }
-		DromeCore::RefPtr <DromeGfx::Texture> getTexture() const { return m_texture; }
+		const DromeCore::RefPtr <DromeGfx::Texture> &getTexture() const { return m_texture; }
 
 		DromeMath::Vector2i drawChar(DromeGfx::GfxDriver *driver, uint32_t c, const DromeMath::Vector2i &position, const DromeGfx::Color &color);
 		DromeMath::Vector2i getStringDimensions(const char *s, const DromeMath::Vector2i &maxDimensions = DromeMath::Vector2i()) const;
@@ -39,8 +39,8 @@ class Label : public Widget
 		std::string m_text;
 
 	public:
-		DromeCore::RefPtr <Font> getFont() const { return m_font; }
-		void setFont(DromeCore::RefPtr <Font> value) { m_font = value; }
+		const DromeCore::RefPtr <Font> &getFont() const { return m_font; }
+		void setFont(const DromeCore::RefPtr <Font> &value) { m_font = value; }
 
 		std::string getText() const { return m_text; }
 		void setText(const char *value) { m_text = value; }
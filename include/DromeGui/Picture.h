@@ -36,12 +36,12 @@ class Picture : public Widget
 		DromeCore::RefPtr <DromeGfx::Texture> m_texture;
 		unsigned int m_imageWidth, m_imageHeight;
 
-		Picture(DromeGfx::GfxDriver *driver, DromeCore::RefPtr <DromeGfx::Image> image);
+		Picture(DromeGfx::GfxDriver *driver, const DromeCore::RefPtr <DromeGfx::Image> &image);
 
 	public:
 		virtual void render(DromeGfx::GfxDriver *driver);
 
-		static DromeCore::RefPtr <Picture> create(DromeGfx::GfxDriver *driver, DromeCore::RefPtr <DromeGfx::Image> image);
+		static DromeCore::RefPtr <Picture> create(DromeGfx::GfxDriver *driver, const DromeCore::RefPtr <DromeGfx::Image> &image);
 };
 
 } // namespace DromeGui
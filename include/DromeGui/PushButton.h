@@ -39,7 +39,7 @@ class PushButton : public Picture
 		std::string m_text;
 		DromeMath::Rect2i m_textBounds;
 
-		PushButton(DromeGfx::GfxDriver *driver, DromeCore::RefPtr <DromeGfx::Image> image, DromeCore::RefPtr <Font> font);
+		PushButton(DromeGfx::GfxDriver *driver, const DromeCore::RefPtr <DromeGfx::Image> &image, const DromeCore::RefPtr <Font> &font);
 
 	public:
 		std::string getText() const;
@@ -48,7 +48,7 @@ class PushButton : public Picture
 
 		void render(DromeGfx::GfxDriver *driver);
 
-		static DromeCore::RefPtr <PushButton> create(DromeGfx::GfxDriver *driver, DromeCore::RefPtr <DromeGfx::Image> image, DromeCore::RefPtr <Font> font);
+		static DromeCore::RefPtr <PushButton> create(DromeGfx::GfxDriver *driver, const DromeCore::RefPtr <DromeGfx::Image> &image, const DromeCore::RefPtr <Font> &font);
 };
 
 } // namespace DromeGui
@@ -44,6 +44,7 @@ class BoundingBox : public PhysicsObject
 		void setBounds(const Vector3 &value);
 
 		virtual PhysicsObjectType getType() const;
+		virtual void getBounds(Vector3 &min, Vector3 &max) const;
 		virtual CollisionInfo collisionCheck(const BoundingBox *box) const;
 		virtual CollisionInfo collisionCheck(const BoundingSphere *box) const;
 		virtual CollisionInfo collisionCheck(const PhysicsObject *object) const;
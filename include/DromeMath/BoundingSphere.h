@@ -44,6 +44,7 @@ class BoundingSphere : public PhysicsObject
 		void setRadius(float value);
 
 		virtual PhysicsObjectType getType() const;
+		virtual void getBounds(Vector3 &min, Vector3 &max) const;
 		virtual CollisionInfo collisionCheck(const BoundingSphere *sphere) const;
 		virtual CollisionInfo collisionCheck(const BoundingBox *sphere) const;
 		virtual CollisionInfo collisionCheck(const PhysicsObject *object) const;
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_BOUNDINGVOLUMEHIERARCHY_H__
+#define __DROMEMATH_BOUNDINGVOLUMEHIERARCHY_H__
+
+#include <vector>
+#include "Frustum.h"
+#include "PhysicsObject.h"
+#include "Vector3.h"
+
+namespace DromeMath {
+
+/**
+ * \brief A node of a BoundingVolumeHierarchy.
+ */
+class BoundingVolumeHierarchyNode
+{
+	public:
+		Vector3 min, max;
+
+		/**
+		 * Index of the parent node, or BoundingVolumeHierarchy::INVALID_INDEX for the root node.
+		 */
+		unsigned int parent;
+
+		/**
+		 * For leaf nodes, the position of the node's first object in the hierarchy's object order. For interior nodes, the index of the second child. The first child always directly follows its parent.
+		 */
+		unsigned int offset;
+
+		/**
+		 * The number of objects in a leaf node, or 0 for interior nodes.
+		 */
+		unsigned int numObjects;
+
+		inline bool isLeaf() const { return numObjects != 0; }
+};
+
+/**
+ * \brief The result of a ray cast against a BoundingVolumeHierarchy.
+ */
+class RaycastInfo
+{
+	public:
+		bool hit;
+		unsigned int objectIndex;
+		float distance;
+
+		RaycastInfo(bool hitParam, unsigned int objectIndexParam = 0, float distanceParam = 0.0f) { hit = hitParam; objectIndex = objectIndexParam; distance = distanceParam; }
+};
+
+/**
+ * \brief A bounding volume hierarchy over PhysicsObjects.
+ *
+ * The hierarchy is built top-down using the surface area heuristic and stored as a flat array of nodes in depth-first order. Objects are referred to by the index they were given by addObject(). The hierarchy keeps pointers to the objects, which must stay valid until the hierarchy is cleared. When objects move, refit() updates the bounds of the nodes without changing the structure of the tree.
+ */
+class BoundingVolumeHierarchy
+{
+	public:
+		static const unsigned int INVALID_INDEX = 0xffffffff;
+
+	protected:
+		std::vector <const PhysicsObject *> m_objects;
+		std::vector <Vector3> m_objectMin, m_objectMax;
+
+		// object indices in leaf order, and the leaf node of each object
+		std::vector <unsigned int> m_objectOrder;
+		std::vector <unsigned int> m_objectLeaves;
+
+		std::vector <BoundingVolumeHierarchyNode> m_nodes;
+
+		void updateObjectBounds(unsigned int objectIndex);
+		bool updateNodeBounds(unsigned int nodeIndex);
+		unsigned int buildNode(unsigned int first, unsigned int count, unsigned int parent, unsigned int depth);
+
+	public:
+		BoundingVolumeHierarchy();
+
+		/**
+		 * Removes all objects and nodes.
+		 */
+		void clear();
+
+		/**
+		 * Adds an object to the hierarchy. The object is not included in queries until build() is called.
+		 *
+		 * @param object The object to add. Its bounds are given by PhysicsObject::getBounds().
+		 * @return The index of the object, which is returned by queries.
+		 */
+		unsigned int addObject(const PhysicsObject *object);
+
+		/**
+		 * @return The number of objects added to the hierarchy.
+		 */
+		unsigned int getNumObjects() const { return (unsigned int)m_objects.size(); }
+
+		/**
+		 * @param index The index of an object.
+		 * @return The object with the given index.
+		 */
+		const PhysicsObject *getObject(unsigned int index) const { return m_objects[index]; }
+
+		/**
+		 * @return The number of nodes in the hierarchy.
+		 */
+		unsigned int getNumNodes() const { return (unsigned int)m_nodes.size(); }
+
+		/**
+		 * @param index The index of a node. The root node has index 0.
+		 * @return The node with the given index.
+		 */
+		const BoundingVolumeHierarchyNode &getNode(unsigned int index) const { return m_nodes[index]; }
+
+		/**
+		 * Builds the hierarchy from the current bounds of all added objects.
+		 */
+		void build();
+
+		/**
+		 * Updates the bounds of all nodes from the current bounds of their objects.
+		 */
+		void refit();
+
+		/**
+		 * Updates the bounds of the nodes containing the given object after it has moved or changed size.
+		 *
+		 * @param objectIndex The index of the object.
+		 */
+		void refit(unsigned int objectIndex);
+
+		/**
+		 * Finds the objects whose bounds may be inside a frustum.
+		 *
+		 * @param frustum The frustum to test against.
+		 * @param results Vector that the indices of the objects found are appended to.
+		 */
+		void query(const Frustum &frustum, std::vector <unsigned int> &results) const;
+
+		/**
+		 * Finds the objects whose bounds overlap an axis-aligned box.
+		 *
+		 * @param min The minimum corner of the box.
+		 * @param max The maximum corner of the box.
+		 * @param results Vector that the indices of the objects found are appended to.
+		 */
+		void query(const Vector3 &min, const Vector3 &max, std::vector <unsigned int> &results) const;
+
+		/**
+		 * Finds the objects whose bounds overlap the bounds of the given object.
+		 *
+		 * @param object The object to test against.
+		 * @param results Vector that the indices of the objects found are appended to.
+		 */
+		void query(const PhysicsObject *object, std::vector <unsigned int> &results) const;
+
+		/**
+		 * Finds the closest object hit by a ray. Boxes and spheres are tested exactly.
+		 *
+		 * @param origin The origin of the ray.
+		 * @param direction The direction of the ray. This vector does not need to be normalized; distances are measured in multiples of its length.
+		 * @param maxDistance The maximum distance along the ray to test.
+		 * @return A RaycastInfo object describing the closest hit, if any.
+		 */
+		RaycastInfo raycast(const Vector3 &origin, const Vector3 &direction, float maxDistance) const;
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_BOUNDINGVOLUMEHIERARCHY_H__ */
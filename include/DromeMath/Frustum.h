@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_FRUSTUM_H__
+#define __DROMEMATH_FRUSTUM_H__
+
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "Matrix4.h"
+#include "Vector3.h"
+
+namespace DromeMath {
+
+/**
+ * \brief Represents a view frustum as six planes.
+ *
+ * The planes are stored as separate arrays of X, Y and Z normal components and distances so that several planes can be tested at once with SIMD instructions. The planes point into the frustum.
+ */
+class Frustum
+{
+	public:
+		enum Plane
+		{
+			PLANE_LEFT = 0,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+
+			NUM_PLANES
+		};
+
+		// the plane arrays are padded to a multiple of four
+		// with planes that every point is in front of
+		static const unsigned int NUM_PADDED_PLANES = 8;
+
+	protected:
+		float m_normalX[NUM_PADDED_PLANES];
+		float m_normalY[NUM_PADDED_PLANES];
+		float m_normalZ[NUM_PADDED_PLANES];
+		float m_distance[NUM_PADDED_PLANES];
+
+	public:
+		/**
+		 * Creates a new Frustum object that contains everything between -1 and 1 on each axis.
+		 */
+		Frustum();
+
+		/**
+		 * Creates a new Frustum object from the given projection and view matrices.
+		 *
+		 * @param projectionView The projection matrix multiplied by the view matrix, such as driver->getProjectionMatrix() * camera.getMatrix().
+		 */
+		Frustum(const Matrix4 &projectionView);
+
+		/**
+		 * Extracts the planes of the frustum from the given projection and view matrices.
+		 *
+		 * @param projectionView The projection matrix multiplied by the view matrix.
+		 */
+		void setMatrix(const Matrix4 &projectionView);
+
+		/**
+		 * @param plane The plane to get the normal of.
+		 * @return The normalized normal vector of the given plane, pointing into the frustum.
+		 */
+		Vector3 getPlaneNormal(Plane plane) const;
+
+		/**
+		 * @param plane The plane to get the distance of.
+		 * @return The distance term of the given plane's equation.
+		 */
+		float getPlaneDistance(Plane plane) const;
+
+		/**
+		 * @param point A point to test.
+		 * @return True if the point is inside the frustum.
+		 */
+		bool containsPoint(const Vector3 &point) const;
+
+		/**
+		 * @param center The center of the sphere.
+		 * @param radius The radius of the sphere.
+		 * @return True if any part of the sphere may be inside the frustum.
+		 */
+		bool intersectsSphere(const Vector3 &center, float radius) const;
+
+		/**
+		 * @param center The center of the box.
+		 * @param extents Half the size of the box along each axis.
+		 * @return True if any part of the box may be inside the frustum.
+		 */
+		bool intersectsBox(const Vector3 &center, const Vector3 &extents) const;
+
+		/**
+		 * @param sphere A sphere to test.
+		 * @return True if any part of the sphere may be inside the frustum.
+		 */
+		bool intersects(const BoundingSphere &sphere) const;
+
+		/**
+		 * @param box A box to test.
+		 * @return True if any part of the box may be inside the frustum.
+		 */
+		bool intersects(const BoundingBox &box) const;
+
+		/**
+		 * Tests an array of spheres against the frustum.
+		 *
+		 * @param centers The centers of the spheres.
+		 * @param radii The radii of the spheres.
+		 * @param numSpheres The number of spheres to test.
+		 * @param visibleIndices An array of at least numSpheres elements that receives the indices of the spheres that may be visible, in increasing order.
+		 * @return The number of indices written to visibleIndices.
+		 */
+		unsigned int cullSpheres(const Vector3 *centers, const float *radii, unsigned int numSpheres, unsigned int *visibleIndices) const;
+
+		/**
+		 * Tests an array of boxes against the frustum.
+		 *
+		 * @param centers The centers of the boxes.
+		 * @param extents Half the size of each box along each axis.
+		 * @param numBoxes The number of boxes to test.
+		 * @param visibleIndices An array of at least numBoxes elements that receives the indices of the boxes that may be visible, in increasing order.
+		 * @return The number of indices written to visibleIndices.
+		 */
+		unsigned int cullBoxes(const Vector3 *centers, const Vector3 *extents, unsigned int numBoxes, unsigned int *visibleIndices) const;
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_FRUSTUM_H__ */
@@ -26,17 +26,29 @@
 #ifndef __DROMEMATH_MATRIX4_H__
 #define __DROMEMATH_MATRIX4_H__
 
+#include <cstddef>
 #include <string>
+#include "Util.h"
 #include "Vector3.h"
+#include "Vector4.h"
 
 namespace DromeMath {
 
+class ParallelRunner;
+
 /** \brief Represents a 4x4 matrix.
+ *
+ * The elements are stored in column-major order, as OpenGL expects, so elements 12, 13 and 14 hold the translation. The elements are aligned to 16 bytes so that each column can be loaded as a single SIMD register; operations use SSE or NEON instructions when the compiler targets them.
  */
 class Matrix4
 {
 	protected:
-		float m_matrix[16];
+		DROMEMATH_ALIGN(16) float m_matrix[16];
+
+		enum Uninitialized { UNINITIALIZED };
+
+		// leaves the elements uninitialized, for results that are about to be written
+		Matrix4(Uninitialized) { }
 
 	public:
 		/**
@@ -54,13 +66,31 @@ class Matrix4
 		/**
 		 * @return A pointer to the array of floats that makes up the matrix.
 		 */
-		const float *getData() const;
+		const float *getData() const { return m_matrix; }
 
 		/**
 		 * @param i The index of the matrix element to access.
 		 * @return A reference to the matrix element at the given index.
 		 */
-		float &operator [] (int i);
+		float &operator [] (int i) { return m_matrix[i]; }
+
+		/**
+		 * @param i The index of the matrix element to access.
+		 * @return The matrix element at the given index.
+		 */
+		float operator [] (int i) const { return m_matrix[i]; }
+
+		/**
+		 * @param matrix A matrix to compare this matrix to.
+		 * @return True if all elements of both matrices are equal.
+		 */
+		bool operator == (const Matrix4 &matrix) const;
+
+		/**
+		 * @param matrix A matrix to compare this matrix to.
+		 * @return True if any element of the matrices differs.
+		 */
+		bool operator != (const Matrix4 &matrix) const;
 
 		/**
 		 * @param scalar A scalar to multiply this matrix by.
@@ -87,16 +117,123 @@ class Matrix4
 		Matrix4 operator * (const Matrix4 &matrix) const;
 
 		/**
-		 * @param vector A vector multiply this matrix by.
-		 * @return A Vector3 object that is the result of multiplying this matrix by a vector.
+		 * @param vector A point to multiply this matrix by.
+		 * @return A Vector3 object that is the result of multiplying this matrix by the point (with a W coordinate of 1), without dividing by the resulting W coordinate.
 		 */
 		Vector3 operator * (const Vector3 &vector) const;
 
+		/**
+		 * @param vector A vector to multiply this matrix by.
+		 * @return A Vector4 object that is the result of multiplying this matrix by the vector.
+		 */
+		Vector4 operator * (const Vector4 &vector) const;
+
+		/**
+		 * Multiplies this matrix by each point of an array, as with operator * (const Vector3 &).
+		 *
+		 * @param points The points to transform.
+		 * @param results Array to write the transformed points to. It may be the same array as points.
+		 * @param numPoints The number of points to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		void transformPoints(const Vector3 *points, Vector3 *results, unsigned int numPoints,
+		                     ParallelRunner *runner = NULL) const;
+
+		/**
+		 * Multiplies the upper 3x3 of this matrix by each direction of an array, so that directions are rotated and scaled but not translated.
+		 *
+		 * @param directions The directions to transform.
+		 * @param results Array to write the transformed directions to. It may be the same array as directions.
+		 * @param numDirections The number of directions to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		void transformDirections(const Vector3 *directions, Vector3 *results, unsigned int numDirections,
+		                         ParallelRunner *runner = NULL) const;
+
+		/**
+		 * Multiplies the normal matrix (see normalMatrix()) by each normal of an array and normalizes the results, so that normals stay perpendicular to surfaces transformed by this matrix even when it has a non-uniform scale.
+		 *
+		 * @param normals The normals to transform.
+		 * @param results Array to write the transformed normals to. It may be the same array as normals.
+		 * @param numNormals The number of normals to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		void transformNormals(const Vector3 *normals, Vector3 *results, unsigned int numNormals,
+		                      ParallelRunner *runner = NULL) const;
+
+		/**
+		 * Multiplies each point of an array by one of several matrices, such as the bone transforms of a skinned mesh.
+		 *
+		 * @param matrices The matrices to transform the points by.
+		 * @param matrixIndices The index into matrices of the matrix for each point.
+		 * @param points The points to transform.
+		 * @param results Array to write the transformed points to. It may be the same array as points.
+		 * @param numPoints The number of points to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		static void transformPoints(const Matrix4 *matrices, const unsigned short *matrixIndices,
+		                            const Vector3 *points, Vector3 *results, unsigned int numPoints,
+		                            ParallelRunner *runner = NULL);
+
+		/**
+		 * Multiplies each direction of an array by the upper 3x3 of one of several matrices.
+		 *
+		 * @param matrices The matrices to transform the directions by.
+		 * @param matrixIndices The index into matrices of the matrix for each direction.
+		 * @param directions The directions to transform.
+		 * @param results Array to write the transformed directions to. It may be the same array as directions.
+		 * @param numDirections The number of directions to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		static void transformDirections(const Matrix4 *matrices, const unsigned short *matrixIndices,
+		                                const Vector3 *directions, Vector3 *results, unsigned int numDirections,
+		                                ParallelRunner *runner = NULL);
+
+		/**
+		 * Multiplies each normal of an array by the normal matrix (see normalMatrix()) of one of several matrices and normalizes the results, like the non-static transformNormals() does for a single matrix.
+		 *
+		 * @param matrices The matrices to transform the normals by.
+		 * @param matrixIndices The index into matrices of the matrix for each normal.
+		 * @param normals The normals to transform.
+		 * @param results Array to write the transformed normals to. It may be the same array as normals.
+		 * @param numNormals The number of normals to transform.
+		 * @param runner If not NULL, large arrays are split into ranges that are transformed on the runner's threads.
+		 */
+		static void transformNormals(const Matrix4 *matrices, const unsigned short *matrixIndices,
+		                             const Vector3 *normals, Vector3 *results, unsigned int numNormals,
+		                             ParallelRunner *runner = NULL);
+
+		/**
+		 * @return A Matrix4 object whose upper 3x3 is the inverse transpose of the upper 3x3 of this matrix and that has no translation, for transforming normals.
+		 */
+		Matrix4 normalMatrix() const;
+
 		/**
 		 * @return A Matrix4 object that is the result of taking the transpose of this matrix.
 		 */
 		Matrix4 transpose() const;
 
+		/**
+		 * Calculates the inverse of this matrix. The matrix must be invertible; the inverse of a singular matrix has infinite or NaN elements.
+		 *
+		 * @return A Matrix4 object that is the result of inverting this matrix.
+		 */
+		Matrix4 inverse() const;
+
+		/**
+		 * Calculates the inverse of this matrix, which must be an affine transform (its last row is 0, 0, 0, 1), such as any combination of translations, rotations and scalings. This is cheaper than inverse(), since only the upper 3x3 needs to be inverted.
+		 *
+		 * @return A Matrix4 object that is the result of inverting this matrix.
+		 */
+		Matrix4 inverseAffine() const;
+
+		/**
+		 * Calculates the inverse of this matrix, which must be a rotation followed by a translation, such as a camera's view matrix. This is the cheapest inverse, since the inverse of the rotation is its transpose.
+		 *
+		 * @return A Matrix4 object that is the result of inverting this matrix.
+		 */
+		Matrix4 inverseOrthonormal() const;
+
 		/**
 		 * @param vector A vector to translate this matrix by.
 		 * @return A Matrix4 object that is the result of translating this matrix by the given vector.
@@ -151,6 +288,31 @@ class Matrix4
 		 * @return A rotation matrix that rotates by the given angle around the given vector.
 		 */
 		static Matrix4 rotation(float angle, const Vector3 &vector);
+
+		/**
+		 * Multiplies a matrix by each matrix of an array, such as a view matrix by the transforms of many objects.
+		 *
+		 * @param matrix The matrix to multiply by each matrix (on the left).
+		 * @param matrices The matrices to multiply.
+		 * @param results Array to write matrix * matrices[i] to. It may be the same array as matrices.
+		 * @param numMatrices The number of matrices to multiply.
+		 */
+		static void multiply(const Matrix4 &matrix, const Matrix4 *matrices, Matrix4 *results, unsigned int numMatrices);
+
+		/**
+		 * Multiplies the corresponding matrices of two arrays, such as the bone transforms and inverse bind poses of a skeleton.
+		 *
+		 * @param matrices1 The matrices on the left of each product.
+		 * @param matrices2 The matrices on the right of each product.
+		 * @param results Array to write matrices1[i] * matrices2[i] to. It may be the same array as either of the others.
+		 * @param numMatrices The number of matrices in each array.
+		 */
+		static void multiply(const Matrix4 *matrices1, const Matrix4 *matrices2, Matrix4 *results, unsigned int numMatrices);
+
+		/**
+		 * @return The name of the instruction set used for matrix operations: "SSE", "NEON" or "scalar".
+		 */
+		static const char *getInstructionSetName();
 };
 
 } // namespace DromeMath
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_PARALLELRUNNER_H__
+#define __DROMEMATH_PARALLELRUNNER_H__
+
+namespace DromeMath {
+
+/**
+ * A function that processes the elements from first up to (but not including) end of some collection.
+ *
+ * @param data Data passed to ParallelRunner::parallelFor().
+ * @param first The index of the first element to process.
+ * @param end One past the index of the last element to process.
+ */
+typedef void (*ParallelFunction)(void *data, unsigned int first, unsigned int end);
+
+/**
+ * \brief Interface for running a ParallelFunction over a range of indices on several threads.
+ *
+ * DromeMath doesn't create threads itself; classes such as PhysicsWorld can be given a ParallelRunner, such as a DromeCore::JobSystem, to split their work with.
+ */
+class ParallelRunner
+{
+	public:
+		virtual ~ParallelRunner() { }
+
+		/**
+		 * Calls a function for consecutive ranges of indices, possibly at the same time on different threads, and returns once all ranges have been processed. The ranges depend only on count and grainSize.
+		 *
+		 * @param count The number of indices.
+		 * @param grainSize The maximum number of indices in each range.
+		 * @param function The function to call for each range.
+		 * @param data Data to pass to the function.
+		 */
+		virtual void parallelFor(unsigned int count, unsigned int grainSize, ParallelFunction function, void *data) = 0;
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_PARALLELRUNNER_H__ */
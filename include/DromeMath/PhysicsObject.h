@@ -71,10 +71,12 @@ class PhysicsObject
 		void cycle(float time, float gravity = STANDARD_GRAVITY);
 
 		virtual PhysicsObjectType getType() const;
+		virtual void getBounds(Vector3 &min, Vector3 &max) const;
 		virtual CollisionInfo collisionCheck(const PhysicsObject *object) const;
 		virtual CollisionInfo collisionCheck(const PhysicsObject &object) const;
 		virtual void collisionResponse(const PhysicsObject *object);
 		virtual void collisionResponse(const PhysicsObject &object);
+		virtual void collisionResponse(const CollisionInfo &info);
 };
 
 } // namespace DromeMath
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_PHYSICSWORLD_H__
+#define __DROMEMATH_PHYSICSWORLD_H__
+
+#include <vector>
+#include "ParallelRunner.h"
+#include "PhysicsObject.h"
+#include "Vector3.h"
+
+namespace DromeMath {
+
+/**
+ * \brief A collision between two bodies of a PhysicsWorld.
+ */
+class Contact
+{
+	public:
+		unsigned int body1, body2;
+
+		/**
+		 * The result of body1's collisionCheck() against body2.
+		 */
+		CollisionInfo info;
+
+		Contact(unsigned int body1Param, unsigned int body2Param, const CollisionInfo &infoParam) : info(infoParam) { body1 = body1Param; body2 = body2Param; }
+};
+
+/**
+ * \brief A collection of PhysicsObjects that are moved and collided together.
+ *
+ * Candidate pairs are found with a sort-and-sweep broadphase: the bounds of the bodies are sorted along the axis with the largest spread, and only bodies whose bounds overlap along that axis are compared. The sort order is kept between steps, so when bodies move a little it is restored with an insertion sort in nearly linear time. collisionCheck() is only called for pairs whose bounds overlap on all three axes, and pairs of static bodies are never tested.
+ *
+ * Given a ParallelRunner, the world integrates its bodies, updates their bounds and runs the narrowphase on several threads. Each body and pair is handled independently and the contacts are gathered in pair order, so the results are the same as when running on one thread.
+ *
+ * The world keeps pointers to its bodies, which must stay valid until the world is cleared.
+ */
+class PhysicsWorld
+{
+	protected:
+		std::vector <PhysicsObject *> m_bodies;
+		std::vector <bool> m_static;
+		std::vector <Vector3> m_min, m_max;
+		float m_gravity;
+
+		// body indices sorted by the minimum of their bounds along the sweep axis
+		std::vector <unsigned int> m_sortedBodies;
+		unsigned int m_sweepAxis;
+
+		std::vector <unsigned int> m_pairs;
+		std::vector <CollisionInfo> m_pairInfo;
+		std::vector <Contact> m_contacts;
+
+		ParallelRunner *m_parallelRunner;
+		float m_integrateTime;
+
+		void runParallel(unsigned int count, unsigned int grainSize, ParallelFunction function);
+		static void integrateRange(void *data, unsigned int first, unsigned int end);
+		static void updateBoundsRange(void *data, unsigned int first, unsigned int end);
+		static void checkPairRange(void *data, unsigned int first, unsigned int end);
+
+		void updateBounds();
+		void sortBodies();
+
+	public:
+		PhysicsWorld();
+
+		/**
+		 * Removes all bodies and contacts.
+		 */
+		void clear();
+
+		/**
+		 * Adds a body to the world.
+		 *
+		 * @param body The body to add.
+		 * @param isStatic If true, the body is never moved by the world and is not tested against other static bodies.
+		 * @return The index of the body, which is used in contacts.
+		 */
+		unsigned int addBody(PhysicsObject *body, bool isStatic = false);
+
+		unsigned int getNumBodies() const { return (unsigned int)m_bodies.size(); }
+		PhysicsObject *getBody(unsigned int index) const { return m_bodies[index]; }
+		bool isBodyStatic(unsigned int index) const { return m_static[index]; }
+
+		float getGravity() const { return m_gravity; }
+		void setGravity(float value) { m_gravity = value; }
+
+		/**
+		 * Sets the runner used to split the work of each step across threads.
+		 *
+		 * @param runner The runner to use, or NULL to do all work on the calling thread.
+		 */
+		void setParallelRunner(ParallelRunner *runner) { m_parallelRunner = runner; }
+		ParallelRunner *getParallelRunner() const { return m_parallelRunner; }
+
+		/**
+		 * Moves each non-static body by its velocity and applies gravity.
+		 *
+		 * @param time The time step in seconds.
+		 */
+		void integrate(float time);
+
+		/**
+		 * Finds the pairs of bodies whose bounds overlap and collision checks them, replacing the contact list.
+		 */
+		void detectCollisions();
+
+		/**
+		 * Calls detectCollisions() and then collisionResponse() for the non-static bodies of each contact, using the CollisionInfo found by detectCollisions() instead of checking each pair again. A body that is in several contacts isn't rechecked after an earlier contact moves it.
+		 */
+		void collide();
+
+		/**
+		 * Calls integrate() and then collide().
+		 *
+		 * @param time The time step in seconds.
+		 */
+		void step(float time);
+
+		/**
+		 * @return The contacts found by the last call to detectCollisions().
+		 */
+		const std::vector <Contact> &getContacts() const { return m_contacts; }
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_PHYSICSWORLD_H__ */
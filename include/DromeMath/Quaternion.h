@@ -74,10 +74,40 @@ class Quaternion
 		Quaternion conjugate() const;
 
 		/**
+		 * @param q The quaternion to calculate the dot product with.
+		 * @return The dot product of the two quaternions, which is the cosine of half the angle between their rotations if both are unit quaternions.
+		 */
+		float dotProduct(const Quaternion &q) const { return v.dotProduct(q.v) + w * q.w; }
+
+		/**
+		 * Finds the matrix representation of this quaternion. The matrix rotates vectors by the inverse of the rotation of rotate(), so that a Camera can use its orientation's matrix as its view rotation.
+		 *
 		 * @return A Matrix4 object that is the result of finding the matrix representation of this quaternion.
 		 */
 		Matrix4 toMatrix4() const;
 
+		/**
+		 * Rotates a vector by this quaternion (q * v * q^-1) without converting it to a matrix. The quaternion must be a unit quaternion.
+		 *
+		 * @param vector The vector to rotate.
+		 * @return The rotated vector.
+		 */
+		Vector3
+		rotate(const Vector3 &vector) const
+		{
+			Vector3 t = v.crossProduct(vector) * 2.0f;
+			return vector + t * w + v.crossProduct(t);
+		}
+
+		/**
+		 * Rotates each vector of an array by this quaternion, as with rotate(const Vector3 &). This converts the quaternion to a matrix once, which is cheaper than rotating each vector directly.
+		 *
+		 * @param vectors The vectors to rotate.
+		 * @param results Array to write the rotated vectors to. It may be the same array as vectors.
+		 * @param numVectors The number of vectors to rotate.
+		 */
+		void rotate(const Vector3 *vectors, Vector3 *results, unsigned int numVectors) const;
+
 		/**
 		 * @param q The quaternion to multiply this one by.
 		 * @return A Quaternion object that is the result of multiplying this quaternion by another one.
@@ -106,6 +136,67 @@ class Quaternion
 
 		static Quaternion fromAxis(const Vector3 &axis, float theta);
 		static Quaternion fromRotation(const Vector3 &rotation);
+
+		/**
+		 * Interpolates linearly between two unit quaternions along the shortest path and normalizes the result. This is cheaper than slerp(), but the rotation doesn't change at a constant rate as t changes.
+		 *
+		 * @param from The rotation at t = 0.
+		 * @param to The rotation at t = 1.
+		 * @param t The interpolation factor, from 0 to 1.
+		 * @return The interpolated unit quaternion.
+		 */
+		static Quaternion nlerp(const Quaternion &from, const Quaternion &to, float t);
+
+		/**
+		 * Interpolates spherically between two unit quaternions along the shortest path, so that the rotation changes at a constant rate as t changes.
+		 *
+		 * @param from The rotation at t = 0.
+		 * @param to The rotation at t = 1.
+		 * @param t The interpolation factor, from 0 to 1.
+		 * @return The interpolated unit quaternion.
+		 */
+		static Quaternion slerp(const Quaternion &from, const Quaternion &to, float t);
+
+		/**
+		 * Interpolates each pair of quaternions of two arrays as with nlerp(const Quaternion &, const Quaternion &, float), such as the bone rotations of two animation frames. The quaternions are processed four at a time with SIMD instructions where they're available.
+		 *
+		 * @param from The rotations at t = 0.
+		 * @param to The rotations at t = 1.
+		 * @param t The interpolation factor, from 0 to 1.
+		 * @param results Array to write the interpolated quaternions to. It may be the same array as either of the others.
+		 * @param numQuaternions The number of quaternions in each array.
+		 */
+		static void nlerp(const Quaternion *from, const Quaternion *to, float t, Quaternion *results, unsigned int numQuaternions);
+
+		/**
+		 * Interpolates each pair of quaternions of two arrays as with slerp(const Quaternion &, const Quaternion &, float).
+		 *
+		 * @param from The rotations at t = 0.
+		 * @param to The rotations at t = 1.
+		 * @param t The interpolation factor, from 0 to 1.
+		 * @param results Array to write the interpolated quaternions to. It may be the same array as either of the others.
+		 * @param numQuaternions The number of quaternions in each array.
+		 */
+		static void slerp(const Quaternion *from, const Quaternion *to, float t, Quaternion *results, unsigned int numQuaternions);
+
+		/**
+		 * Rotates each vector of an array by the corresponding quaternion of another array, as with rotate(const Vector3 &).
+		 *
+		 * @param rotations The unit quaternions to rotate the vectors by.
+		 * @param vectors The vectors to rotate.
+		 * @param results Array to write the rotated vectors to. It may be the same array as vectors.
+		 * @param numVectors The number of vectors to rotate.
+		 */
+		static void rotate(const Quaternion *rotations, const Vector3 *vectors, Vector3 *results, unsigned int numVectors);
+
+		/**
+		 * Finds the matrix representation of each quaternion of an array, as with toMatrix4().
+		 *
+		 * @param quaternions The quaternions to convert.
+		 * @param results Array to write the matrices to.
+		 * @param numQuaternions The number of quaternions to convert.
+		 */
+		static void toMatrix4(const Quaternion *quaternions, Matrix4 *results, unsigned int numQuaternions);
 };
 
 } // namespace DromeMath
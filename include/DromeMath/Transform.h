@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_TRANSFORM_H__
+#define __DROMEMATH_TRANSFORM_H__
+
+#include "Matrix4.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+
+namespace DromeMath {
+
+/**
+ * \brief Represents a transform as a translation, rotation and scale.
+ *
+ * Points are scaled, then rotated, then translated. A Transform is smaller and cheaper to combine and invert than a Matrix4; its matrix is only calculated when getMatrix() is called after the transform has changed.
+ *
+ * The rotation turns vectors by q * v * q^-1, which is the inverse of the rotation of Quaternion::toMatrix4() (which gives the view rotation of a Camera).
+ */
+class Transform
+{
+	protected:
+		Vector3 m_translation;
+		Quaternion m_rotation;
+		Vector3 m_scale;
+
+		mutable Matrix4 m_matrix;
+		mutable bool m_isMatrixValid;
+
+		void updateMatrix() const;
+
+	public:
+		/**
+		 * Creates a new Transform object.
+		 *
+		 * @param translation The translation of the transform.
+		 * @param rotation The rotation of the transform. It must be a unit quaternion.
+		 * @param scale The scale of the transform along each axis.
+		 */
+		Transform(const Vector3 &translation = Vector3(), const Quaternion &rotation = Quaternion(),
+		          const Vector3 &scale = Vector3(1.0f, 1.0f, 1.0f));
+
+		const Vector3 &getTranslation() const { return m_translation; }
+		void setTranslation(const Vector3 &value) { m_translation = value; m_isMatrixValid = false; }
+
+		const Quaternion &getRotation() const { return m_rotation; }
+		void setRotation(const Quaternion &value) { m_rotation = value; m_isMatrixValid = false; }
+
+		const Vector3 &getScale() const { return m_scale; }
+		void setScale(const Vector3 &value) { m_scale = value; m_isMatrixValid = false; }
+
+		/**
+		 * @return The matrix representation of this transform, which is calculated only if the transform has changed since the last call.
+		 */
+		const Matrix4 &
+		getMatrix() const
+		{
+			if(!m_isMatrixValid)
+				updateMatrix();
+
+			return m_matrix;
+		}
+
+		/**
+		 * @return The inverse of the matrix representation of this transform, calculated directly from the translation, rotation and scale.
+		 */
+		Matrix4 getInverseMatrix() const;
+
+		/**
+		 * Combines this transform with another so that the result applies the other transform first. The result is exact if this transform's scale is uniform (the same along each axis); otherwise a rotation followed by a non-uniform scale can't be represented by a Transform, and the matrices should be multiplied instead.
+		 *
+		 * @param transform The transform to apply before this one.
+		 * @return A Transform object that is the result of combining the two transforms.
+		 */
+		Transform operator * (const Transform &transform) const;
+
+		/**
+		 * Calculates the inverse of this transform. The result is exact if the scale is uniform; otherwise use getInverseMatrix().
+		 *
+		 * @return A Transform object that is the result of inverting this transform.
+		 */
+		Transform inverse() const;
+
+		/**
+		 * @param point A point to transform.
+		 * @return The result of scaling, rotating and translating the point.
+		 */
+		Vector3 transformPoint(const Vector3 &point) const;
+
+		/**
+		 * @param direction A direction to transform.
+		 * @return The result of scaling and rotating the direction.
+		 */
+		Vector3 transformDirection(const Vector3 &direction) const;
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_TRANSFORM_H__ */
@@ -32,6 +32,13 @@
 #define M_PI 3.1415926535898
 #endif
 
+// aligns a class or member to the given number of bytes
+#ifdef _MSC_VER
+#define DROMEMATH_ALIGN(n) __declspec(align(n))
+#else
+#define DROMEMATH_ALIGN(n) __attribute__((aligned(n)))
+#endif /* _MSC_VER */
+
 namespace DromeMath {
 
 const float PI_OVER_180 = (float)M_PI / 180.0f;
@@ -26,6 +26,7 @@
 #ifndef __DROMEMATH_VECTOR3_H__
 #define __DROMEMATH_VECTOR3_H__
 
+#include <cmath>
 #include <string>
 
 namespace DromeMath {
@@ -58,7 +59,12 @@ class Vector3
 		 * @param y_param The Y coordinate of the vector.
 		 * @param z_param The Z coordinate of the vector.
 		 */
-		Vector3(float x_param = 0.0f, float y_param = 0.0f, float z_param = 0.0f);
+		Vector3(float x_param = 0.0f, float y_param = 0.0f, float z_param = 0.0f)
+		{
+			x = x_param;
+			y = y_param;
+			z = z_param;
+		}
 
 		/**
 		 * Creates a new Vector3 object from a string representation of a vector.
@@ -80,14 +86,14 @@ class Vector3
 		 * @param v The vector to take the dot product of with this vector.
 		 * @return The dot product of this vector and the given vector.
 		 */
-		float dotProduct(const Vector3 &v) const;
+		float dotProduct(const Vector3 &v) const { return x * v.x + y * v.y + z * v.z; }
 
 		/**
 		 * Calculates the length (or magnitude) of this vector, which is defined as the square root of the sum of the squared components of the vector (sqrt(x^2 + y^2 + z^2)).
 		 *
 		 * @return The length (or magnitude) of this vector.
 		 */
-		float length() const;
+		float length() const { return sqrtf(dotProduct(*this)); }
 
 		/**
 		 * Calculates the cross product of this vector with another vector.
@@ -95,105 +101,116 @@ class Vector3
 		 * @param v The vector to take the cross product of with this vector.
 		 * @return A Vector3 object that is the result of taking the cross product of this vector with the given vector.
 		 */
-		Vector3 crossProduct(const Vector3 &v) const;
+		Vector3
+		crossProduct(const Vector3 &v) const
+		{
+			return Vector3(y * v.z - z * v.y,
+			               z * v.x - x * v.z,
+			               x * v.y - y * v.x);
+		}
 
 		/**
 		 * Calculates the normalized version of this vector, which is a new vector that has the same direction as this vector but a length (magnitude) of 1.
 		 *
 		 * @return A Vector3 object that is the result of normalizing this vector.
 		 */
-		Vector3 normalize() const;
+		Vector3
+		normalize() const
+		{
+			float scale = 1.0f / sqrtf(x*x + y*y + z*z);
+			return Vector3(x * scale, y * scale, z * scale);
+		}
 
 		/**
 		 * @param v The vector to add to this vector.
 		 * @return A Vector3 object that is the result of adding each component of the given vector to the corresponding components of this vector.
 		 */
-		Vector3 operator + (const Vector3 &v) const;
+		Vector3 operator + (const Vector3 &v) const { return Vector3(x + v.x, y + v.y, z + v.z); }
 
 		/**
 		 * @param f The scalar to add to this vector.
 		 * @return A Vector3 object that is the result of adding the given scalar to each component of this vector.
 		 */
-		Vector3 operator + (float f) const;
+		Vector3 operator + (float f) const { return Vector3(x + f, y + f, z + f); }
 
 		/**
 		 * Adds each component of the given vector to the corresponding components of this vector.
 		 *
 		 * @param v The vector to add to this vector.
 		 */
-		void operator += (const Vector3 &v);
+		void operator += (const Vector3 &v) { x += v.x; y += v.y; z += v.z; }
 
 		/**
 		 * Adds the given scalar to each component of this vector.
 		 *
 		 * @param f The scalar to add to this vector.
 		 */
-		void operator += (float f);
+		void operator += (float f) { x += f; y += f; z += f; }
 
 		/**
 		 * @param v The vector to subtract from this vector.
 		 * @return A Vector3 object that is the result of subtracting each component of the given vector from the corresponding components of this vector.
 		 */
-		Vector3 operator - (const Vector3 &v) const;
+		Vector3 operator - (const Vector3 &v) const { return Vector3(x - v.x, y - v.y, z - v.z); }
 
 		/**
 		 * @param f The scalar to subtract from this vector.
 		 * @return A Vector3 object that is the result of subtracting the given scalar from each component of this vector.
 		 */
-		Vector3 operator - (float f) const;
+		Vector3 operator - (float f) const { return Vector3(x - f, y - f, z - f); }
 
 		/**
 		 * Subtracts each component of the given vector from the corresponding components of this vector.
 		 *
 		 * @param v The vector to subtract from this vector.
 		 */
-		void operator -= (const Vector3 &v);
+		void operator -= (const Vector3 &v) { x -= v.x; y -= v.y; z -= v.z; }
 
 		/**
 		 * Subtracts the given scalar from each component of this vector.
 		 *
 		 * @param f The scalar to subtract from this vector.
 		 */
-		void operator -= (float f);
+		void operator -= (float f) { x -= f; y -= f; z -= f; }
 
 		/**
 		 * @param v The vector to multiply this vector by.
 		 * @return A Vector3 object that is the result of multiplying each component of this vector by the corresponding components of the given vector.
 		 */
-		Vector3 operator * (const Vector3 &v) const;
+		Vector3 operator * (const Vector3 &v) const { return Vector3(x * v.x, y * v.y, z * v.z); }
 
 		/**
 		 * @param f The scalar to multiply this vector by.
 		 * @return A Vector3 object that is the result of multiplying each component of this vector by the given scalar.
 		 */
-		Vector3 operator * (float f) const;
+		Vector3 operator * (float f) const { return Vector3(x * f, y * f, z * f); }
 
 		/**
 		 * Multiplies each component of this vector by the corresponding components of the given vector.
 		 *
 		 * @param v The vector to multiply this vector by.
 		 */
-		void operator *= (const Vector3 &v);
+		void operator *= (const Vector3 &v) { x *= v.x; y *= v.y; z *= v.z; }
 
 		/**
 		 * Multiplies each component of this vector by the given scalar.
 		 *
 		 * @param f The scalar to multiply this vector by.
 		 */
-		void operator *= (float f);
+		void operator *= (float f) { x *= f; y *= f; z *= f; }
 
 		/**
 		 * @param f The scalar to divide this vector by.
 		 * @return A Vector3 object that is the result of dividing each component of this vector by the given scalar.
 		 */
-		Vector3 operator / (float f) const;
+		Vector3 operator / (float f) const { return Vector3(x / f, y / f, z / f); }
 
 		/**
 		 * Divides each component of this vector by the given scalar.
 		 *
 		 * @param f The scalar to divide this vector by.
 		 */
-		void operator /= (float f);
+		void operator /= (float f) { x /= f; y /= f; z /= f; }
 
 		/**
 		 * @return A string representation of the vector.
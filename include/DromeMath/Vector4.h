@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_VECTOR4_H__
+#define __DROMEMATH_VECTOR4_H__
+
+#include <string>
+#include "Util.h"
+#include "Vector3.h"
+
+namespace DromeMath {
+
+/**
+ * \brief Represents a four-dimensional vector, such as a point in homogeneous coordinates.
+ *
+ * Vector4 objects are aligned to 16 bytes so that they can be loaded as a single SIMD register.
+ */
+class DROMEMATH_ALIGN(16) Vector4
+{
+	public:
+		/**
+		 * \brief The X component of the four-dimensional vector.
+		 */
+		float x;
+
+		/**
+		 * \brief The Y component of the four-dimensional vector.
+		 */
+		float y;
+
+		/**
+		 * \brief The Z component of the four-dimensional vector.
+		 */
+		float z;
+
+		/**
+		 * \brief The W component of the four-dimensional vector.
+		 */
+		float w;
+
+		/**
+		 * Creates a new Vector4 object representing the vector with the given coordinates.
+		 *
+		 * @param x_param The X coordinate of the vector.
+		 * @param y_param The Y coordinate of the vector.
+		 * @param z_param The Z coordinate of the vector.
+		 * @param w_param The W coordinate of the vector.
+		 */
+		Vector4(float x_param = 0.0f, float y_param = 0.0f, float z_param = 0.0f, float w_param = 0.0f)
+		{
+			x = x_param;
+			y = y_param;
+			z = z_param;
+			w = w_param;
+		}
+
+		/**
+		 * Creates a new Vector4 object from a three-dimensional vector and a W coordinate.
+		 *
+		 * @param v The X, Y and Z coordinates of the vector.
+		 * @param w_param The W coordinate of the vector; 1 for a point, or 0 for a direction.
+		 */
+		Vector4(const Vector3 &v, float w_param)
+		{
+			x = v.x;
+			y = v.y;
+			z = v.z;
+			w = w_param;
+		}
+
+		/**
+		 * @return A Vector3 object with the X, Y and Z coordinates of this vector.
+		 */
+		Vector3 toVector3() const { return Vector3(x, y, z); }
+
+		/**
+		 * @param v The vector to take the dot product of with this vector.
+		 * @return The sum of each component of this vector multiplied by the corresponding component in the given vector.
+		 */
+		float dotProduct(const Vector4 &v) const { return x * v.x + y * v.y + z * v.z + w * v.w; }
+
+		/**
+		 * @return The length (or magnitude) of this vector.
+		 */
+		float length() const { return sqrtf(dotProduct(*this)); }
+
+		/**
+		 * @return A Vector4 object that has the same direction as this vector but a length of 1.
+		 */
+		Vector4
+		normalize() const
+		{
+			float scale = 1.0f / length();
+			return Vector4(x * scale, y * scale, z * scale, w * scale);
+		}
+
+		Vector4 operator + (const Vector4 &v) const { return Vector4(x + v.x, y + v.y, z + v.z, w + v.w); }
+		void operator += (const Vector4 &v) { x += v.x; y += v.y; z += v.z; w += v.w; }
+
+		Vector4 operator - (const Vector4 &v) const { return Vector4(x - v.x, y - v.y, z - v.z, w - v.w); }
+		void operator -= (const Vector4 &v) { x -= v.x; y -= v.y; z -= v.z; w -= v.w; }
+
+		Vector4 operator * (const Vector4 &v) const { return Vector4(x * v.x, y * v.y, z * v.z, w * v.w); }
+		Vector4 operator * (float f) const { return Vector4(x * f, y * f, z * f, w * f); }
+		void operator *= (const Vector4 &v) { x *= v.x; y *= v.y; z *= v.z; w *= v.w; }
+		void operator *= (float f) { x *= f; y *= f; z *= f; w *= f; }
+
+		Vector4 operator / (float f) const { return Vector4(x / f, y / f, z / f, w / f); }
+		void operator /= (float f) { x /= f; y /= f; z /= f; w /= f; }
+
+		/**
+		 * @return A string representation of the vector.
+		 */
+		std::string toString() const;
+};
+
+} // namespace DromeMath
+
+#endif /* __DROMEMATH_VECTOR4_H__ */
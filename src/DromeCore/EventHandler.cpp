@@ -30,6 +30,11 @@ using namespace std;
 
 namespace DromeCore {
 
+void
+EventHandler::renderFrame(float /*alpha*/)
+{
+}
+
 void
 EventHandler::windowDimensionsChanged(int /*width*/, int /*height*/)
 {
@@ -26,6 +26,8 @@
 #include <cstring>
 #include <DromeCore/Exception.h>
 #include <DromeCore/IOContext.h>
+#include <DromeCore/LinearAllocator.h>
+#include <DromeCore/Profiler.h>
 #include <DromeCore/Util.h>
 
 using namespace std;
@@ -38,7 +40,11 @@ namespace DromeCore {
 IOContext::IOContext()
 {
 	m_handler = NULL;
-	m_ticks = getTicks();
+	m_cycleTime = getNanoseconds();
+
+	m_fixedTimeStep = 0;
+	m_accumulatedTime = 0;
+	m_maxStepsPerCycle = 8;
 }
 
 IOContext::~IOContext()
@@ -57,6 +63,31 @@ IOContext::setEventHandler(EventHandler *value)
 	m_handler = value;
 }
 
+float
+IOContext::getFixedTimeStep() const
+{
+	return (float)((double)m_fixedTimeStep * 1.0e-9);
+}
+
+void
+IOContext::setFixedTimeStep(float seconds)
+{
+	if(seconds < 0.0f)
+		throw Exception("IOContext::setFixedTimeStep(): Time step must not be negative");
+
+	m_fixedTimeStep = (uint64_t)((double)seconds * 1.0e9 + 0.5);
+	m_accumulatedTime = 0;
+}
+
+void
+IOContext::setMaxStepsPerCycle(unsigned int value)
+{
+	if(value == 0)
+		throw Exception("IOContext::setMaxStepsPerCycle(): Value must be greater than 0");
+
+	m_maxStepsPerCycle = value;
+}
+
 int
 IOContext::getWindowWidth() const
 {
@@ -107,15 +138,41 @@ IOContext::cycle()
 	if(m_handler == NULL)
 		return;
 
-	long ticks = getTicks();
-	float secondsElapsed = (ticks - m_ticks) / 1000.0f;
-	m_ticks = ticks;
+	ProfilerZone zone("IOContext::cycle");
+
+	uint64_t cycleTime = getNanoseconds();
+	uint64_t elapsed = cycleTime - m_cycleTime;
+	m_cycleTime = cycleTime;
+
+	if(m_fixedTimeStep == 0) {
+		float secondsElapsed = (float)((double)elapsed * 1.0e-9);
+		while(secondsElapsed > maxSecondsElapsed) {
+			m_handler->cycle(maxSecondsElapsed);
+			secondsElapsed -= maxSecondsElapsed;
+		}
+		m_handler->cycle(secondsElapsed);
+		m_handler->renderFrame(1.0f);
+		LinearAllocator::getFrameAllocator().reset();
+		return;
+	}
 
-	while(secondsElapsed > maxSecondsElapsed) {
-		m_handler->cycle(maxSecondsElapsed);
-		secondsElapsed -= maxSecondsElapsed;
+	// drop time that can't be simulated in this cycle, so that
+	// slow steps can't make each cycle run more steps than the last
+	m_accumulatedTime += elapsed;
+	uint64_t maxAccumulatedTime = m_fixedTimeStep * m_maxStepsPerCycle;
+	if(m_accumulatedTime > maxAccumulatedTime)
+		m_accumulatedTime = maxAccumulatedTime;
+
+	float timeStep = getFixedTimeStep();
+	while(m_accumulatedTime >= m_fixedTimeStep) {
+		m_handler->cycle(timeStep);
+		m_accumulatedTime -= m_fixedTimeStep;
 	}
-	m_handler->cycle(secondsElapsed);
+
+	m_handler->renderFrame((float)((double)m_accumulatedTime / (double)m_fixedTimeStep));
+
+	// memory allocated for the frame is no longer needed
+	LinearAllocator::getFrameAllocator().reset();
 }
 
 } // namespace DromeCore
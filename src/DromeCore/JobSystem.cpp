@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <deque>
+#ifndef _WIN32
+	#include <unistd.h>
+#endif /* _WIN32 */
+#include <DromeCore/Exception.h>
+#include <DromeCore/JobSystem.h>
+#include "Threading.h"
+
+using namespace std;
+
+namespace DromeCore {
+
+/*
+ * JobSystem internals
+ */
+class JobQueue
+{
+	public:
+		Mutex mutex;
+		deque <Job> jobs;
+};
+
+class JobSystemState
+{
+	public:
+		// protects sleeping on the condition, the
+		// waiting jobs of counters and the counters
+		// reaching zero
+		Mutex mutex;
+		Condition condition;
+
+		volatile int numQueuedJobs;
+		volatile int numSleepingThreads;
+		volatile int nextQueue;
+		bool quit;
+
+		JobSystemState()
+		{
+			numQueuedJobs = 0;
+			numSleepingThreads = 0;
+			nextQueue = 0;
+			quit = false;
+		}
+};
+
+// the job system and queue of the worker running on the calling thread
+#ifdef _MSC_VER
+static __declspec(thread) JobSystem *currentJobSystem = NULL;
+static __declspec(thread) unsigned int currentQueueIndex = 0;
+#else
+static __thread JobSystem *currentJobSystem = NULL;
+static __thread unsigned int currentQueueIndex = 0;
+#endif /* _MSC_VER */
+
+class JobWorker
+{
+	public:
+		JobSystem *system;
+		unsigned int queueIndex;
+
+#ifdef _WIN32
+		HANDLE thread;
+
+		static DWORD WINAPI
+		run(LPVOID arg)
+		{
+			JobWorker *worker = (JobWorker *)arg;
+			worker->system->workerLoop(worker->queueIndex);
+			return 0;
+		}
+#else
+		pthread_t thread;
+
+		static void *
+		run(void *arg)
+		{
+			JobWorker *worker = (JobWorker *)arg;
+			worker->system->workerLoop(worker->queueIndex);
+			return NULL;
+		}
+#endif /* _WIN32 */
+};
+
+/*
+ * JobSystem
+ */
+JobSystem::JobSystem(unsigned int numWorkers)
+{
+	// job systems are typically shared by objects used on several threads
+	setAtomicRefCount(true);
+
+	m_state = new JobSystemState();
+
+	// queue 0 is used by threads waiting in wait()
+	for(unsigned int i = 0; i < numWorkers + 1; ++i)
+		m_queues.push_back(new JobQueue());
+
+	for(unsigned int i = 0; i < numWorkers; ++i) {
+		JobWorker *worker = new JobWorker();
+		worker->system = this;
+		worker->queueIndex = i + 1;
+
+#ifdef _WIN32
+		worker->thread = CreateThread(NULL, 0, JobWorker::run, worker, 0, NULL);
+		bool failed = (worker->thread == NULL);
+#else
+		bool failed = (pthread_create(&worker->thread, NULL, JobWorker::run, worker) != 0);
+#endif /* _WIN32 */
+
+		// run with the workers that could be created
+		if(failed) {
+			delete worker;
+			break;
+		}
+
+		m_workers.push_back(worker);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	m_state->mutex.lock();
+	m_state->quit = true;
+	m_state->condition.broadcast();
+	m_state->mutex.unlock();
+
+	for(unsigned int i = 0; i < m_workers.size(); ++i) {
+#ifdef _WIN32
+		WaitForSingleObject(m_workers[i]->thread, INFINITE);
+		CloseHandle(m_workers[i]->thread);
+#else
+		pthread_join(m_workers[i]->thread, NULL);
+#endif /* _WIN32 */
+		delete m_workers[i];
+	}
+
+	for(unsigned int i = 0; i < m_queues.size(); ++i)
+		delete m_queues[i];
+
+	delete m_state;
+}
+
+unsigned int
+JobSystem::getCurrentQueueIndex() const
+{
+	return (currentJobSystem == this) ? currentQueueIndex : 0;
+}
+
+void
+JobSystem::enqueue(const Job &job)
+{
+	// workers push to their own queue, where they take the newest
+	// jobs from; other threads spread their jobs over all queues
+	unsigned int queueIndex;
+	if(currentJobSystem == this)
+		queueIndex = currentQueueIndex;
+	else
+		queueIndex = (unsigned int)atomicAdd(&m_state->nextQueue, 1) % (unsigned int)m_queues.size();
+
+	JobQueue *queue = m_queues[queueIndex];
+	queue->mutex.lock();
+	queue->jobs.push_back(job);
+	queue->mutex.unlock();
+
+	// a sleeping thread counts itself before checking for queued
+	// jobs, so either it sees this job or it's seen here
+	atomicAdd(&m_state->numQueuedJobs, 1);
+	if(atomicLoad(&m_state->numSleepingThreads) > 0) {
+		m_state->mutex.lock();
+		m_state->condition.signal();
+		m_state->mutex.unlock();
+	}
+}
+
+bool
+JobSystem::runJob(unsigned int queueIndex)
+{
+	Job job;
+	bool found = false;
+	unsigned int numQueues = (unsigned int)m_queues.size();
+
+	// take the newest job from our own queue, or else
+	// steal the oldest job from one of the other queues
+	for(unsigned int i = 0; i < numQueues && !found; ++i) {
+		JobQueue *queue = m_queues[(queueIndex + i) % numQueues];
+
+		queue->mutex.lock();
+		if(!queue->jobs.empty()) {
+			if(i == 0) {
+				job = queue->jobs.back();
+				queue->jobs.pop_back();
+			} else {
+				job = queue->jobs.front();
+				queue->jobs.pop_front();
+			}
+			found = true;
+		}
+		queue->mutex.unlock();
+	}
+
+	if(!found)
+		return false;
+
+	atomicAdd(&m_state->numQueuedJobs, -1);
+	job.function(job.data, job.first, job.end);
+	finishJob(job);
+
+	return true;
+}
+
+void
+JobSystem::finishJob(const Job &job)
+{
+	if(job.counter == NULL)
+		return;
+
+	// the counter may be destroyed as soon as a waiting thread sees it
+	// reach zero, so it's only changed while holding the lock that
+	// wait() takes before returning
+	vector <Job> waitingJobs;
+	m_state->mutex.lock();
+	if(atomicAdd(&job.counter->m_value, -1) == 0) {
+		waitingJobs.swap(job.counter->m_waitingJobs);
+
+		// wake the threads sleeping in wait()
+		if(atomicLoad(&m_state->numSleepingThreads) > 0)
+			m_state->condition.broadcast();
+	}
+	m_state->mutex.unlock();
+
+	// start the jobs that were waiting for the counter
+
+	for(unsigned int i = 0; i < waitingJobs.size(); ++i)
+		enqueue(waitingJobs[i]);
+}
+
+void
+JobSystem::workerLoop(unsigned int queueIndex)
+{
+	currentJobSystem = this;
+	currentQueueIndex = queueIndex;
+
+	for(;;) {
+		if(runJob(queueIndex))
+			continue;
+
+		// sleep until a job is queued
+		m_state->mutex.lock();
+		atomicAdd(&m_state->numSleepingThreads, 1);
+		while(atomicLoad(&m_state->numQueuedJobs) == 0 && !m_state->quit)
+			m_state->condition.wait(m_state->mutex);
+		atomicAdd(&m_state->numSleepingThreads, -1);
+		bool quit = m_state->quit;
+		m_state->mutex.unlock();
+
+		if(quit)
+			return;
+	}
+}
+
+void
+JobSystem::submit(JobFunction function, void *data, unsigned int first, unsigned int end,
+                  JobCounter *counter, JobCounter *dependency)
+{
+	Job job;
+	job.function = function;
+	job.data = data;
+	job.first = first;
+	job.end = end;
+	job.counter = counter;
+
+	if(counter != NULL)
+		atomicAdd(&counter->m_value, 1);
+
+	if(dependency != NULL) {
+		m_state->mutex.lock();
+		bool waiting = (dependency->m_value != 0);
+		if(waiting)
+			dependency->m_waitingJobs.push_back(job);
+		m_state->mutex.unlock();
+
+		if(waiting)
+			return;
+	}
+
+	enqueue(job);
+}
+
+void
+JobSystem::wait(JobCounter *counter)
+{
+	unsigned int queueIndex = getCurrentQueueIndex();
+
+	for(;;) {
+		if(atomicLoad(&counter->m_value) == 0)
+			break;
+		if(runJob(queueIndex))
+			continue;
+
+		// sleep until a job is queued or the counter reaches zero,
+		// which finishJob() only changes while holding the lock
+		m_state->mutex.lock();
+		atomicAdd(&m_state->numSleepingThreads, 1);
+		while(atomicLoad(&counter->m_value) != 0 && atomicLoad(&m_state->numQueuedJobs) == 0)
+			m_state->condition.wait(m_state->mutex);
+		atomicAdd(&m_state->numSleepingThreads, -1);
+		m_state->mutex.unlock();
+	}
+
+	// wait for the thread that finished the last job to release the
+	// counter; this also makes the results of the jobs visible
+	m_state->mutex.lock();
+	m_state->mutex.unlock();
+}
+
+void
+JobSystem::parallelFor(unsigned int count, unsigned int grainSize, JobFunction function, void *data)
+{
+	if(grainSize == 0)
+		throw Exception("JobSystem::parallelFor(): grainSize must be greater than 0");
+
+	// without workers or with a single range, run the function directly
+	if(m_workers.empty() || count <= grainSize) {
+		for(unsigned int first = 0; first < count; first += grainSize)
+			function(data, first, (count - first > grainSize) ? first + grainSize : count);
+		return;
+	}
+
+	JobCounter counter;
+	for(unsigned int first = 0; first < count; first += grainSize)
+		submit(function, data, first, (count - first > grainSize) ? first + grainSize : count, &counter);
+	wait(&counter);
+}
+
+RefPtr <JobSystem>
+JobSystem::create(unsigned int numWorkers)
+{
+	if(numWorkers == 0) {
+		unsigned int numProcessors = getNumProcessors();
+		numWorkers = (numProcessors > 1) ? numProcessors - 1 : 0;
+	}
+
+	return RefPtr <JobSystem> (new JobSystem(numWorkers));
+}
+
+unsigned int
+JobSystem::getNumProcessors()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (unsigned int)info.dwNumberOfProcessors;
+#else
+	long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (numProcessors > 0) ? (unsigned int)numProcessors : 1;
+#endif /* _WIN32 */
+}
+
+} // namespace DromeCore
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+#include <DromeCore/LinearAllocator.h>
+
+using namespace std;
+
+namespace DromeCore {
+
+const size_t LinearAllocator::DEFAULT_ALIGNMENT;
+const size_t LinearAllocator::DEFAULT_BLOCK_SIZE;
+
+LinearAllocator::LinearAllocator(size_t blockSize)
+{
+	m_blockSize = blockSize;
+	m_currentBlock = 0;
+	m_offset = 0;
+	m_numBytes = 0;
+	m_peakNumBytes = 0;
+}
+
+LinearAllocator::~LinearAllocator()
+{
+	for(size_t i = 0; i < m_blocks.size(); ++i)
+		free(m_blocks[i].data);
+}
+
+void *
+LinearAllocator::allocateFromNextBlock(size_t size, size_t alignment)
+{
+	// use the following blocks, which are free after a rewind
+	while(m_currentBlock + 1 < m_blocks.size()) {
+		++m_currentBlock;
+		m_offset = 0;
+
+		const Block &block = m_blocks[m_currentBlock];
+		size_t start = (alignment - (size_t)block.data % alignment) % alignment;
+		if(start <= block.size && size <= block.size - start) {
+			m_offset = start + size;
+			m_numBytes += size;
+			return block.data + start;
+		}
+	}
+
+	// add a block large enough for the allocation
+	Block block;
+	block.size = (size + alignment > m_blockSize) ? size + alignment : m_blockSize;
+	block.data = (char *)malloc(block.size);
+	if(block.data == NULL)
+		throw bad_alloc();
+	m_blocks.push_back(block);
+	m_currentBlock = m_blocks.size() - 1;
+
+	size_t start = (alignment - (size_t)block.data % alignment) % alignment;
+	m_offset = start + size;
+	m_numBytes += size;
+	return block.data + start;
+}
+
+LinearAllocator::Marker
+LinearAllocator::getMarker() const
+{
+	Marker marker;
+	marker.block = m_currentBlock;
+	marker.offset = m_offset;
+	marker.numBytes = m_numBytes;
+
+	return marker;
+}
+
+void
+LinearAllocator::rewind(const Marker &marker)
+{
+	if(m_numBytes > m_peakNumBytes)
+		m_peakNumBytes = m_numBytes;
+
+	m_currentBlock = marker.block;
+	m_offset = marker.offset;
+	m_numBytes = marker.numBytes;
+}
+
+void
+LinearAllocator::reset()
+{
+	if(m_numBytes > m_peakNumBytes)
+		m_peakNumBytes = m_numBytes;
+
+	// replace several blocks with one that holds them all, which is allocated when next needed
+	if(m_blocks.size() > 1) {
+		m_blockSize = getCapacity();
+		for(size_t i = 0; i < m_blocks.size(); ++i)
+			free(m_blocks[i].data);
+		m_blocks.clear();
+	}
+
+	m_currentBlock = 0;
+	m_offset = 0;
+	m_numBytes = 0;
+}
+
+size_t
+LinearAllocator::getCapacity() const
+{
+	size_t capacity = 0;
+	for(size_t i = 0; i < m_blocks.size(); ++i)
+		capacity += m_blocks[i].size;
+
+	return capacity;
+}
+
+LinearAllocator &
+LinearAllocator::getFrameAllocator()
+{
+	static LinearAllocator frameAllocator;
+	return frameAllocator;
+}
+
+} // namespace DromeCore
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+#include <new>
+#include <DromeCore/ObjectPool.h>
+#include "Threading.h"
+
+using namespace std;
+
+namespace DromeCore {
+
+const size_t ObjectPool::MAX_POOLED_SIZE;
+
+// block sizes are multiples of this, which keeps blocks aligned for any type
+static const size_t SIZE_CLASS_GRANULARITY = 16;
+static const size_t NUM_SIZE_CLASSES = ObjectPool::MAX_POOLED_SIZE / SIZE_CLASS_GRANULARITY;
+
+static const size_t SLAB_SIZE = 64 * 1024;
+
+// free blocks kept by each thread for each size class
+static const int THREAD_CACHE_SIZE = 64;
+
+// free blocks moved at once between a thread and its size class
+static const int THREAD_CACHE_BATCH = 32;
+
+// allocation counters of one pool; each thread has its own counters so
+// they're never contended, and they are summed when read. they're still
+// updated atomically, since getStatistics() reads them from other threads
+class ObjectCounts
+{
+	public:
+		volatile int numObjects;
+		volatile int numBytes;
+		volatile int numAllocations;
+
+		ObjectCounts() { numObjects = 0; numBytes = 0; numAllocations = 0; }
+};
+
+// the free blocks of one size, shared by all threads and pools
+class SizeClass
+{
+	public:
+		Mutex mutex;
+		size_t blockSize;
+		void *freeBlocks;
+
+		SizeClass() { blockSize = 0; freeBlocks = NULL; }
+};
+
+// the free blocks and counters of one thread
+class ThreadCache
+{
+	public:
+		void *freeBlocks[NUM_SIZE_CLASSES];
+		int numFreeBlocks[NUM_SIZE_CLASSES];
+
+		// counters of each pool, indexed by the pool's index
+		vector <ObjectCounts> counts;
+
+		ThreadCache *prev;
+		ThreadCache *next;
+
+		ThreadCache();
+		~ThreadCache();
+
+		ObjectCounts &
+		getCounts(unsigned int poolIndex)
+		{
+			if(poolIndex >= counts.size())
+				resizeCounts(poolIndex + 1);
+			return counts[poolIndex];
+		}
+
+		void resizeCounts(size_t size);
+		void refill(size_t sizeClass);
+		void flush(size_t sizeClass, int numBlocks);
+};
+
+// state shared by all pools; never freed, so objects can still be deleted while the program exits
+class PoolState
+{
+	public:
+		SizeClass sizeClasses[NUM_SIZE_CLASSES];
+
+		// protects the lists of pools and thread caches, and the size of each thread's counters
+		Mutex mutex;
+
+		ObjectPool *firstPool;
+		unsigned int numPools;
+
+		ThreadCache *firstThreadCache;
+
+		// counters of threads that have exited
+		vector <ObjectCounts> exitedCounts;
+
+		PoolState()
+		{
+			for(size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+				sizeClasses[i].blockSize = (i + 1) * SIZE_CLASS_GRANULARITY;
+			firstPool = NULL;
+			numPools = 0;
+			firstThreadCache = NULL;
+		}
+};
+
+static PoolState *poolState = NULL;
+
+// the calling thread's cache; the thread storage key below only deletes it when the thread exits
+#ifdef _MSC_VER
+static __declspec(thread) ThreadCache *currentThreadCache = NULL;
+#else
+static __thread ThreadCache *currentThreadCache = NULL;
+#endif /* _MSC_VER */
+
+static void
+deleteThreadCache(void *threadCache)
+{
+	currentThreadCache = NULL;
+	delete (ThreadCache *)threadCache;
+}
+
+#ifdef _WIN32
+static DWORD threadCacheIndex;
+static INIT_ONCE poolStateOnce = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI
+deleteThreadCacheCallback(void *threadCache)
+{
+	deleteThreadCache(threadCache);
+}
+
+static BOOL CALLBACK
+initPoolState(PINIT_ONCE, void *, void **)
+{
+	poolState = new PoolState();
+	threadCacheIndex = FlsAlloc(deleteThreadCacheCallback);
+	return TRUE;
+}
+
+static PoolState &
+getPoolState()
+{
+	InitOnceExecuteOnce(&poolStateOnce, initPoolState, NULL, NULL);
+	return *poolState;
+}
+
+static void
+setThreadCacheDeleter(ThreadCache *threadCache)
+{
+	FlsSetValue(threadCacheIndex, threadCache);
+}
+#else
+static pthread_key_t threadCacheKey;
+static pthread_once_t poolStateOnce = PTHREAD_ONCE_INIT;
+
+static void
+initPoolState()
+{
+	poolState = new PoolState();
+	pthread_key_create(&threadCacheKey, deleteThreadCache);
+}
+
+static PoolState &
+getPoolState()
+{
+	pthread_once(&poolStateOnce, initPoolState);
+	return *poolState;
+}
+
+static void
+setThreadCacheDeleter(ThreadCache *threadCache)
+{
+	pthread_setspecific(threadCacheKey, threadCache);
+}
+#endif /* _WIN32 */
+
+static inline ThreadCache &
+getThreadCache()
+{
+	if(currentThreadCache == NULL) {
+		getPoolState();
+		currentThreadCache = new ThreadCache();
+		setThreadCacheDeleter(currentThreadCache);
+	}
+
+	return *currentThreadCache;
+}
+
+ThreadCache::ThreadCache()
+{
+	for(size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+		freeBlocks[i] = NULL;
+		numFreeBlocks[i] = 0;
+	}
+
+	PoolState &state = getPoolState();
+	state.mutex.lock();
+	prev = NULL;
+	next = state.firstThreadCache;
+	if(next != NULL)
+		next->prev = this;
+	state.firstThreadCache = this;
+	state.mutex.unlock();
+}
+
+ThreadCache::~ThreadCache()
+{
+	PoolState &state = getPoolState();
+
+	// keep the counters of the exiting thread, since its objects may outlive it
+	state.mutex.lock();
+	if(state.exitedCounts.size() < counts.size())
+		state.exitedCounts.resize(counts.size());
+	for(size_t i = 0; i < counts.size(); ++i) {
+		state.exitedCounts[i].numObjects += counts[i].numObjects;
+		state.exitedCounts[i].numBytes += counts[i].numBytes;
+		state.exitedCounts[i].numAllocations += counts[i].numAllocations;
+	}
+
+	if(prev != NULL)
+		prev->next = next;
+	else
+		state.firstThreadCache = next;
+	if(next != NULL)
+		next->prev = prev;
+	state.mutex.unlock();
+
+	for(size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+		flush(i, numFreeBlocks[i]);
+}
+
+void
+ThreadCache::resizeCounts(size_t size)
+{
+	// other threads may be summing the counters
+	PoolState &state = getPoolState();
+	state.mutex.lock();
+	counts.resize(size);
+	state.mutex.unlock();
+}
+
+void
+ThreadCache::refill(size_t sizeClass)
+{
+	SizeClass &shared = getPoolState().sizeClasses[sizeClass];
+	shared.mutex.lock();
+
+	// carve a new slab into blocks when none are free
+	if(shared.freeBlocks == NULL) {
+		char *slab = (char *)malloc(SLAB_SIZE);
+		if(slab == NULL) {
+			shared.mutex.unlock();
+			throw bad_alloc();
+		}
+
+		size_t numBlocks = SLAB_SIZE / shared.blockSize;
+		for(size_t i = 0; i < numBlocks; ++i) {
+			void *block = slab + i * shared.blockSize;
+			*(void **)block = shared.freeBlocks;
+			shared.freeBlocks = block;
+		}
+	}
+
+	while(shared.freeBlocks != NULL && numFreeBlocks[sizeClass] < THREAD_CACHE_BATCH) {
+		void *block = shared.freeBlocks;
+		shared.freeBlocks = *(void **)block;
+		*(void **)block = freeBlocks[sizeClass];
+		freeBlocks[sizeClass] = block;
+		++numFreeBlocks[sizeClass];
+	}
+
+	shared.mutex.unlock();
+}
+
+void
+ThreadCache::flush(size_t sizeClass, int numBlocks)
+{
+	if(numBlocks == 0)
+		return;
+
+	SizeClass &shared = getPoolState().sizeClasses[sizeClass];
+	shared.mutex.lock();
+
+	for(int i = 0; i < numBlocks; ++i) {
+		void *block = freeBlocks[sizeClass];
+		freeBlocks[sizeClass] = *(void **)block;
+		*(void **)block = shared.freeBlocks;
+		shared.freeBlocks = block;
+	}
+	numFreeBlocks[sizeClass] -= numBlocks;
+
+	shared.mutex.unlock();
+}
+
+ObjectPool::ObjectPool(const char *name)
+{
+	m_name = name;
+
+	PoolState &state = getPoolState();
+	state.mutex.lock();
+	m_index = state.numPools++;
+	m_next = state.firstPool;
+	state.firstPool = this;
+	state.mutex.unlock();
+}
+
+void *
+ObjectPool::allocate(size_t size)
+{
+	if(size == 0)
+		size = 1;
+
+	ThreadCache &threadCache = getThreadCache();
+	void *block;
+
+	if(size > MAX_POOLED_SIZE) {
+		block = ::operator new(size);
+	} else {
+		size_t sizeClass = (size - 1) / SIZE_CLASS_GRANULARITY;
+		if(threadCache.freeBlocks[sizeClass] == NULL)
+			threadCache.refill(sizeClass);
+
+		block = threadCache.freeBlocks[sizeClass];
+		threadCache.freeBlocks[sizeClass] = *(void **)block;
+		--threadCache.numFreeBlocks[sizeClass];
+	}
+
+	ObjectCounts &counts = threadCache.getCounts(m_index);
+	atomicAdd(&counts.numObjects, 1);
+	atomicAdd(&counts.numBytes, (int)size);
+	atomicAdd(&counts.numAllocations, 1);
+
+	return block;
+}
+
+void
+ObjectPool::deallocate(void *ptr, size_t size)
+{
+	if(ptr == NULL)
+		return;
+	if(size == 0)
+		size = 1;
+
+	ThreadCache &threadCache = getThreadCache();
+
+	if(size > MAX_POOLED_SIZE) {
+		::operator delete(ptr);
+	} else {
+		// blocks freed by another thread than the one that allocated them join this thread's cache
+		size_t sizeClass = (size - 1) / SIZE_CLASS_GRANULARITY;
+		*(void **)ptr = threadCache.freeBlocks[sizeClass];
+		threadCache.freeBlocks[sizeClass] = ptr;
+		if(++threadCache.numFreeBlocks[sizeClass] > THREAD_CACHE_SIZE)
+			threadCache.flush(sizeClass, THREAD_CACHE_BATCH);
+	}
+
+	ObjectCounts &counts = threadCache.getCounts(m_index);
+	atomicAdd(&counts.numObjects, -1);
+	atomicAdd(&counts.numBytes, -(int)size);
+}
+
+void
+ObjectPool::getStatistics(int &numObjects, int &numBytes, int &numAllocations) const
+{
+	PoolState &state = getPoolState();
+	state.mutex.lock();
+
+	numObjects = 0;
+	numBytes = 0;
+	numAllocations = 0;
+	if(m_index < state.exitedCounts.size()) {
+		numObjects = state.exitedCounts[m_index].numObjects;
+		numBytes = state.exitedCounts[m_index].numBytes;
+		numAllocations = state.exitedCounts[m_index].numAllocations;
+	}
+
+	// counters of running threads may be a moment out of date
+	for(ThreadCache *threadCache = state.firstThreadCache; threadCache != NULL; threadCache = threadCache->next) {
+		if(m_index < threadCache->counts.size()) {
+			ObjectCounts &counts = threadCache->counts[m_index];
+			numObjects += atomicLoad(&counts.numObjects);
+			numBytes += atomicLoad(&counts.numBytes);
+			numAllocations += atomicLoad(&counts.numAllocations);
+		}
+	}
+
+	state.mutex.unlock();
+}
+
+int
+ObjectPool::getNumObjects() const
+{
+	int numObjects, numBytes, numAllocations;
+	getStatistics(numObjects, numBytes, numAllocations);
+	return numObjects;
+}
+
+int
+ObjectPool::getNumBytes() const
+{
+	int numObjects, numBytes, numAllocations;
+	getStatistics(numObjects, numBytes, numAllocations);
+	return numBytes;
+}
+
+int
+ObjectPool::getNumAllocations() const
+{
+	int numObjects, numBytes, numAllocations;
+	getStatistics(numObjects, numBytes, numAllocations);
+	return numAllocations;
+}
+
+void
+ObjectPool::getPools(vector <const ObjectPool *> &pools)
+{
+	PoolState &state = getPoolState();
+	state.mutex.lock();
+	for(const ObjectPool *pool = state.firstPool; pool != NULL; pool = pool->m_next)
+		pools.push_back(pool);
+	state.mutex.unlock();
+}
+
+} // namespace DromeCore
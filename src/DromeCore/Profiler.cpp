@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <vector>
+#include <DromeCore/Exception.h>
+#include <DromeCore/Profiler.h>
+#include <DromeCore/Util.h>
+#include "Threading.h"
+
+using namespace std;
+
+namespace DromeCore {
+
+const unsigned int Profiler::EVENTS_PER_THREAD;
+
+class ProfilerEvent
+{
+	public:
+		const char *name;
+		uint64_t start, end;
+};
+
+// the zones recorded by one thread
+class ProfilerThread
+{
+	public:
+		unsigned int id;
+
+		// protects the ring buffer, which is read by other threads
+		Mutex mutex;
+		vector <ProfilerEvent> events;
+		uint64_t numEvents;
+
+		// zones that have been started but not ended
+		vector <ProfilerEvent> openZones;
+};
+
+static volatile int enabled = 0;
+
+static Mutex threadsMutex;
+static vector <ProfilerThread *> threads;
+
+// thread buffers are kept after their threads exit so that
+// their zones can still be written out
+static ProfilerThread *
+createProfilerThread()
+{
+	ProfilerThread *thread = new ProfilerThread();
+	thread->events.resize(Profiler::EVENTS_PER_THREAD);
+	thread->numEvents = 0;
+
+	threadsMutex.lock();
+	thread->id = (unsigned int)threads.size();
+	threads.push_back(thread);
+	threadsMutex.unlock();
+
+	return thread;
+}
+
+#ifdef _WIN32
+static DWORD profilerThreadIndex;
+static INIT_ONCE profilerThreadOnce = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK
+initProfilerThread(PINIT_ONCE, void *, void **)
+{
+	profilerThreadIndex = TlsAlloc();
+	return TRUE;
+}
+
+static ProfilerThread *
+getProfilerThread()
+{
+	InitOnceExecuteOnce(&profilerThreadOnce, initProfilerThread, NULL, NULL);
+
+	ProfilerThread *thread = (ProfilerThread *)TlsGetValue(profilerThreadIndex);
+	if(thread == NULL) {
+		thread = createProfilerThread();
+		TlsSetValue(profilerThreadIndex, thread);
+	}
+
+	return thread;
+}
+#else
+static pthread_key_t profilerThreadKey;
+static pthread_once_t profilerThreadOnce = PTHREAD_ONCE_INIT;
+
+static void
+initProfilerThread()
+{
+	pthread_key_create(&profilerThreadKey, NULL);
+}
+
+static ProfilerThread *
+getProfilerThread()
+{
+	pthread_once(&profilerThreadOnce, initProfilerThread);
+
+	ProfilerThread *thread = (ProfilerThread *)pthread_getspecific(profilerThreadKey);
+	if(thread == NULL) {
+		thread = createProfilerThread();
+		pthread_setspecific(profilerThreadKey, thread);
+	}
+
+	return thread;
+}
+#endif /* _WIN32 */
+
+static void
+appendEscaped(string &s, const char *text)
+{
+	for(; *text != '\0'; ++text) {
+		if(*text == '"' || *text == '\\') {
+			s += '\\';
+			s += *text;
+		} else if((unsigned char)*text < 0x20) {
+			char buffer[8];
+			sprintf(buffer, "\\u%04x", (unsigned int)(unsigned char)*text);
+			s += buffer;
+		} else {
+			s += *text;
+		}
+	}
+}
+
+bool
+Profiler::isEnabled()
+{
+	return enabled != 0;
+}
+
+void
+Profiler::setEnabled(bool value)
+{
+	enabled = value ? 1 : 0;
+}
+
+bool
+Profiler::beginZone(const char *name)
+{
+	if(!enabled)
+		return false;
+
+	ProfilerEvent zone;
+	zone.name = name;
+	zone.start = getNanoseconds();
+	zone.end = 0;
+
+	getProfilerThread()->openZones.push_back(zone);
+	return true;
+}
+
+void
+Profiler::endZone()
+{
+	uint64_t end = getNanoseconds();
+
+	ProfilerThread *thread = getProfilerThread();
+	if(thread->openZones.empty())
+		throw Exception("Profiler::endZone(): No zone has been started");
+
+	ProfilerEvent zone = thread->openZones.back();
+	thread->openZones.pop_back();
+	zone.end = end;
+
+	// overwrite the oldest zone once the buffer is full
+	thread->mutex.lock();
+	thread->events[thread->numEvents % EVENTS_PER_THREAD] = zone;
+	++thread->numEvents;
+	thread->mutex.unlock();
+}
+
+void
+Profiler::clear()
+{
+	threadsMutex.lock();
+	for(unsigned int i = 0; i < threads.size(); ++i) {
+		threads[i]->mutex.lock();
+		threads[i]->numEvents = 0;
+		threads[i]->mutex.unlock();
+	}
+	threadsMutex.unlock();
+}
+
+string
+Profiler::getChromeTrace()
+{
+	string trace = "{\"traceEvents\":[";
+	bool first = true;
+
+	threadsMutex.lock();
+
+	// make timestamps relative to the earliest recorded zone
+	uint64_t origin = 0;
+	bool haveOrigin = false;
+	for(unsigned int i = 0; i < threads.size(); ++i) {
+		ProfilerThread *thread = threads[i];
+		thread->mutex.lock();
+		unsigned int numEvents = (thread->numEvents < EVENTS_PER_THREAD) ? (unsigned int)thread->numEvents : EVENTS_PER_THREAD;
+		for(unsigned int j = 0; j < numEvents; ++j) {
+			if(!haveOrigin || thread->events[j].start < origin) {
+				origin = thread->events[j].start;
+				haveOrigin = true;
+			}
+		}
+		thread->mutex.unlock();
+	}
+
+	for(unsigned int i = 0; i < threads.size(); ++i) {
+		ProfilerThread *thread = threads[i];
+		thread->mutex.lock();
+
+		// write the zones from oldest to newest
+		uint64_t firstEvent = (thread->numEvents > EVENTS_PER_THREAD) ? thread->numEvents - EVENTS_PER_THREAD : 0;
+		for(uint64_t j = firstEvent; j < thread->numEvents; ++j) {
+			const ProfilerEvent &event = thread->events[j % EVENTS_PER_THREAD];
+
+			char buffer[128];
+			sprintf(buffer, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			        thread->id, (double)(event.start - origin) / 1000.0,
+			        (double)(event.end - event.start) / 1000.0);
+
+			trace += first ? "{\"name\":\"" : ",{\"name\":\"";
+			appendEscaped(trace, event.name);
+			trace += buffer;
+			first = false;
+		}
+
+		thread->mutex.unlock();
+	}
+
+	threadsMutex.unlock();
+
+	trace += "],\"displayTimeUnit\":\"ns\"}";
+	return trace;
+}
+
+void
+Profiler::writeChromeTrace(const char *filename)
+{
+	string trace = getChromeTrace();
+
+	FILE *fp = fopen(filename, "wb");
+	if(!fp)
+		throw Exception(string("Profiler::writeChromeTrace(): Unable to open file ") + filename);
+
+	size_t written = fwrite(trace.data(), 1, trace.size(), fp);
+	fclose(fp);
+
+	if(written != trace.size())
+		throw Exception(string("Profiler::writeChromeTrace(): Unable to write file ") + filename);
+}
+
+} // namespace DromeCore
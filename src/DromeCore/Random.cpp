@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <DromeCore/Random.h>
+#include "Threading.h"
+
+using namespace DromeMath;
+
+namespace DromeCore {
+
+// number of vectors generated at a time by fillUnitVectors()
+static const unsigned int FILL_BLOCK_SIZE = 64;
+
+static const float TWO_PI = 6.28318530718f;
+
+Random::Random(uint64_t seedValue, uint64_t stream)
+{
+	seed(seedValue, stream);
+}
+
+void
+Random::seed(uint64_t seedValue, uint64_t stream)
+{
+	m_state = 0;
+	m_increment = (stream << 1) | 1;
+	nextUInt();
+	m_state += seedValue;
+	nextUInt();
+}
+
+Random
+Random::split()
+{
+	uint64_t seedValue = ((uint64_t)nextUInt() << 32) | nextUInt();
+	uint64_t stream = ((uint64_t)nextUInt() << 32) | nextUInt();
+
+	return Random(seedValue, stream);
+}
+
+uint32_t
+Random::nextUInt(uint32_t bound)
+{
+	// scale a 32-bit value to the range with a multiplication, rejecting
+	// the few values that would make some results more likely than others
+	uint64_t product = (uint64_t)nextUInt() * bound;
+	uint32_t low = (uint32_t)product;
+	if(low < bound) {
+		uint32_t threshold = (0u - bound) % bound;
+		while(low < threshold) {
+			product = (uint64_t)nextUInt() * bound;
+			low = (uint32_t)product;
+		}
+	}
+
+	return (uint32_t)(product >> 32);
+}
+
+Vector3
+Random::nextUnitVector()
+{
+	float z = nextFloat(-1.0f, 1.0f);
+	float angle = nextFloat(0.0f, TWO_PI);
+	float radius = sqrtf(1.0f - z * z);
+
+	return Vector3(radius * cosf(angle), radius * sinf(angle), z);
+}
+
+void
+Random::fillUInts(uint32_t *values, unsigned int numValues)
+{
+	Random random = *this;
+
+	for(unsigned int i = 0; i < numValues; ++i)
+		values[i] = random.nextUInt();
+
+	*this = random;
+}
+
+void
+Random::fillFloats(float *values, unsigned int numValues, float min, float max)
+{
+	// keep the state in a local so that it stays in a register
+	Random random = *this;
+	float range = max - min;
+
+	// round the same way as nextFloat(min, max); the signed
+	// conversion is exact for 24-bit values and vectorizes better
+	for(unsigned int i = 0; i < numValues; ++i)
+		values[i] = min + range * ((float)(int32_t)(random.nextUInt() >> 8) * (1.0f / 16777216.0f));
+
+	*this = random;
+}
+
+void
+Random::fillUnitVectors(Vector3 *vectors, unsigned int numVectors)
+{
+	for(unsigned int i = 0; i < numVectors; ++i)
+		vectors[i] = nextUnitVector();
+}
+
+void
+Random::fillUnitVectors(float *x, float *y, float *z, unsigned int numVectors)
+{
+	float angles[FILL_BLOCK_SIZE];
+
+	for(unsigned int first = 0; first < numVectors; first += FILL_BLOCK_SIZE) {
+		unsigned int count = numVectors - first;
+		if(count > FILL_BLOCK_SIZE)
+			count = FILL_BLOCK_SIZE;
+
+		// pick a height and an angle around the z axis for each vector
+		fillFloats(z + first, count, -1.0f, 1.0f);
+		fillFloats(angles, count, 0.0f, TWO_PI);
+
+		for(unsigned int i = 0; i < count; ++i) {
+			float radius = sqrtf(1.0f - z[first + i] * z[first + i]);
+			x[first + i] = radius * cosf(angles[i]);
+			y[first + i] = radius * sinf(angles[i]);
+		}
+	}
+}
+
+/*
+ * Per-thread generators
+ */
+static volatile int numThreadRandoms = 0;
+
+static Random *
+createThreadRandom()
+{
+	// give each thread its own stream
+	int stream = atomicAdd(&numThreadRandoms, 1);
+
+	return new Random(0x853c49e6748fea9bULL, (uint64_t)stream);
+}
+
+#ifdef _WIN32
+static DWORD threadRandomIndex;
+static INIT_ONCE threadRandomOnce = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI
+deleteThreadRandom(void *random)
+{
+	delete (Random *)random;
+}
+
+static BOOL CALLBACK
+initThreadRandom(PINIT_ONCE, void *, void **)
+{
+	threadRandomIndex = FlsAlloc(deleteThreadRandom);
+	return TRUE;
+}
+
+Random &
+Random::getThreadRandom()
+{
+	InitOnceExecuteOnce(&threadRandomOnce, initThreadRandom, NULL, NULL);
+
+	Random *random = (Random *)FlsGetValue(threadRandomIndex);
+	if(random == NULL) {
+		random = createThreadRandom();
+		FlsSetValue(threadRandomIndex, random);
+	}
+
+	return *random;
+}
+#else
+static pthread_key_t threadRandomKey;
+static pthread_once_t threadRandomOnce = PTHREAD_ONCE_INIT;
+
+static void
+deleteThreadRandom(void *random)
+{
+	delete (Random *)random;
+}
+
+static void
+initThreadRandom()
+{
+	pthread_key_create(&threadRandomKey, deleteThreadRandom);
+}
+
+Random &
+Random::getThreadRandom()
+{
+	pthread_once(&threadRandomOnce, initThreadRandom);
+
+	Random *random = (Random *)pthread_getspecific(threadRandomKey);
+	if(random == NULL) {
+		random = createThreadRandom();
+		pthread_setspecific(threadRandomKey, random);
+	}
+
+	return *random;
+}
+#endif /* _WIN32 */
+
+} // namespace DromeCore
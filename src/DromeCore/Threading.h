@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMECORE_THREADING_H__
+#define __DROMECORE_THREADING_H__
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif /* _WIN32 */
+
+namespace DromeCore {
+
+/*
+ * Threading primitives shared by the classes of DromeCore that use threads.
+ */
+static inline int
+atomicAdd(volatile int *value, int amount)
+{
+#ifdef _WIN32
+	return InterlockedExchangeAdd((volatile LONG *)value, amount) + amount;
+#else
+	return __sync_add_and_fetch(value, amount);
+#endif /* _WIN32 */
+}
+
+static inline int
+atomicLoad(volatile int *value)
+{
+	return atomicAdd(value, 0);
+}
+
+class Mutex
+{
+	private:
+		Mutex(const Mutex &);
+		void operator = (const Mutex &);
+
+	public:
+#ifdef _WIN32
+		CRITICAL_SECTION mutex;
+
+		Mutex() { InitializeCriticalSection(&mutex); }
+		~Mutex() { DeleteCriticalSection(&mutex); }
+		void lock() { EnterCriticalSection(&mutex); }
+		void unlock() { LeaveCriticalSection(&mutex); }
+#else
+		pthread_mutex_t mutex;
+
+		Mutex() { pthread_mutex_init(&mutex, NULL); }
+		~Mutex() { pthread_mutex_destroy(&mutex); }
+		void lock() { pthread_mutex_lock(&mutex); }
+		void unlock() { pthread_mutex_unlock(&mutex); }
+#endif /* _WIN32 */
+};
+
+class Condition
+{
+	private:
+		Condition(const Condition &);
+		void operator = (const Condition &);
+
+	public:
+#ifdef _WIN32
+		CONDITION_VARIABLE condition;
+
+		Condition() { InitializeConditionVariable(&condition); }
+		~Condition() { }
+		void wait(Mutex &mutex) { SleepConditionVariableCS(&condition, &mutex.mutex, INFINITE); }
+		void signal() { WakeConditionVariable(&condition); }
+		void broadcast() { WakeAllConditionVariable(&condition); }
+#else
+		pthread_cond_t condition;
+
+		Condition() { pthread_cond_init(&condition, NULL); }
+		~Condition() { pthread_cond_destroy(&condition); }
+		void wait(Mutex &mutex) { pthread_cond_wait(&condition, &mutex.mutex); }
+		void signal() { pthread_cond_signal(&condition); }
+		void broadcast() { pthread_cond_broadcast(&condition); }
+#endif /* _WIN32 */
+};
+
+} // namespace DromeCore
+
+#endif /* __DROMECORE_THREADING_H__ */
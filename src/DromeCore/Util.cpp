@@ -24,12 +24,14 @@
  */
 
 #include <cstring>
-#ifdef _WIN32
+#if defined(_WIN32)
 	#include <windows.h>
+#elif defined(__APPLE__)
+	#include <mach/mach_time.h>
 #else
-	#include <stdlib.h>
-	#include <sys/time.h>
-#endif /* _WIN32 */
+	#include <time.h>
+#endif
+#include <DromeCore/Random.h>
 #include <DromeCore/Util.h>
 
 namespace DromeCore {
@@ -43,17 +45,13 @@ randomUChar()
 unsigned int
 randomUInt()
 {
-#ifndef _WIN32
-	return (unsigned int)random();
-#else
-	return rand();
-#endif /* _WIN32 */
+	return Random::getThreadRandom().nextUInt();
 }
 
 float
 randomFloat(float min, float max)
 {
-	return min + (max - min) * ((float)randomUInt() / (float)RAND_MAX);
+	return Random::getThreadRandom().nextFloat(min, max);
 }
 
 int
@@ -69,31 +67,38 @@ strCaseCmp(const char *s1, const char *s2)
 long
 getTicks()
 {
-	static bool first_run = true;
+	static uint64_t start = getNanoseconds();
+
+	return (long)((getNanoseconds() - start) / 1000000);
+}
+
+uint64_t
+getNanoseconds()
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency;
+	if(frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
 
-#ifndef _WIN32
-	static struct timeval start;
-	struct timeval t;
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
 
-	gettimeofday(&t, NULL);
-	if(first_run) {
-		start.tv_sec = t.tv_sec;
-		start.tv_usec = t.tv_usec;
-		first_run = false;
-	}
+	// split the conversion so that it doesn't overflow
+	uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+	uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+	return seconds * 1000000000 + remainder * 1000000000 / (uint64_t)frequency.QuadPart;
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t timebase;
+	if(timebase.denom == 0)
+		mach_timebase_info(&timebase);
 
-	return ((t.tv_sec - start.tv_sec) * 1000) + (t.tv_usec / 1000);
+	return mach_absolute_time() * timebase.numer / timebase.denom;
 #else
-	long start;
-	long t = (long)GetTickCount();
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
 
-	if(first_run) {
-		start = t;
-		first_run = false;
-	}
-
-	return t - start;
-#endif /* _WIN32 */
+	return (uint64_t)t.tv_sec * 1000000000 + (uint64_t)t.tv_nsec;
+#endif
 }
 
 } // namespace DromeCore
@@ -203,10 +203,20 @@ CubeMesh::CubeMesh(const Vector3 &scale, float sScale, float tScale)
 		m_commands.push_back(cmd);
 	}
 
-	// create vertex buffers
-	m_vertices = VertexBuffer::create(&(verts[0]), (unsigned int)verts.size());
-	m_texCoords = VertexBuffer::create(&(texCoords[0]), (unsigned int)texCoords.size());
-	m_tangentSpace = VertexBuffer::create(&(tangentSpace[0]), (unsigned int)tangentSpace.size());
+	// interleave the vertex attributes and create the vertex buffer
+	vector<MeshVertex> vertices(verts.size());
+	for(unsigned int i = 0; i < vertices.size(); ++i) {
+		vertices[i].position = verts[i];
+		vertices[i].s = texCoords[i * 2 + 0];
+		vertices[i].t = texCoords[i * 2 + 1];
+		vertices[i].tangent = tangentSpace[i * 3 + 0];
+		vertices[i].binormal = tangentSpace[i * 3 + 1];
+		vertices[i].normal = tangentSpace[i * 3 + 2];
+	}
+	setVertices(vertices);
+
+	// draw the whole mesh with a single call
+	bake();
 }
 
 RefPtr <CubeMesh>
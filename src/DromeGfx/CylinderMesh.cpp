@@ -38,9 +38,7 @@ CylinderMesh::CylinderMesh(unsigned int divisions)
 	if(divisions < 1)
 		throw Exception("CylinderMesh::CylinderMesh(): Invalid number of divisions (%u)");
 
-	vector<Vector3> verts;
-	vector<float> texCoords;
-	vector<Vector3> tangentSpace;
+	vector<MeshVertex> verts;
 
 	// calculate vertices and texture coordinates
 	for(unsigned int i = 0; i <= divisions; ++i) {
@@ -49,19 +47,19 @@ CylinderMesh::CylinderMesh(unsigned int divisions)
 		Vector3 bitangent = Vector3(0.0f, 0.0f, -1.0f);
 		Vector3 normal = Vector3(cosf(degToRad(r)), sinf(degToRad(r)), 0.0f);
 
-		verts.push_back(Vector3(normal.x, normal.y, 1.0f));
-		texCoords.push_back((float)i / (float)divisions);
-		texCoords.push_back(0.0f);
-		tangentSpace.push_back(tangent);
-		tangentSpace.push_back(bitangent);
-		tangentSpace.push_back(normal);
+		MeshVertex v;
+		v.tangent = tangent;
+		v.binormal = bitangent;
+		v.normal = normal;
 
-		verts.push_back(Vector3(normal.x, normal.y, -1.0f));
-		texCoords.push_back((float)i / (float)divisions);
-		texCoords.push_back(1.0f);
-		tangentSpace.push_back(tangent);
-		tangentSpace.push_back(bitangent);
-		tangentSpace.push_back(normal);
+		v.position = Vector3(normal.x, normal.y, 1.0f);
+		v.s = (float)i / (float)divisions;
+		v.t = 0.0f;
+		verts.push_back(v);
+
+		v.position = Vector3(normal.x, normal.y, -1.0f);
+		v.t = 1.0f;
+		verts.push_back(v);
 	}
 
 	// create command for rendering
@@ -70,10 +68,11 @@ CylinderMesh::CylinderMesh(unsigned int divisions)
 		cmd->indices[i] = i;
 	m_commands.insert(m_commands.end(), cmd);
 
-	// create vertex buffers
-	m_vertices = VertexBuffer::create(&(verts[0]), (unsigned int)verts.size());
-	m_texCoords = VertexBuffer::create(&(texCoords[0]), (unsigned int)texCoords.size());
-	m_tangentSpace = VertexBuffer::create(&(tangentSpace[0]), (unsigned int)tangentSpace.size());
+	// create vertex buffer
+	setVertices(verts);
+
+	// draw the whole mesh with a single call
+	bake();
 }
 
 RefPtr <CylinderMesh>
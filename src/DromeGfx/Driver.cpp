@@ -25,8 +25,11 @@
 
 #include <cstdio>
 #include <string>
+#include <DromeCore/Exception.h>
+#include <DromeCore/LinearAllocator.h>
 #include <DromeGfx/Driver.h>
 #include <DromeGfx/DriverGL.h>
+#include <DromeGfx/Mesh.h>
 #include <DromeMath/Util.h>
 
 using namespace DromeCore;
@@ -34,6 +37,21 @@ using namespace DromeMath;
 
 namespace DromeGfx {
 
+// only changed at startup, so it doesn't need to be atomic
+static bool glEnabled = true;
+
+void
+GfxDriver::setGLEnabled(bool enabled)
+{
+	glEnabled = enabled;
+}
+
+bool
+GfxDriver::isGLEnabled()
+{
+	return glEnabled;
+}
+
 void
 GfxDriver::setProjectionMatrix(int windowWidth, int windowHeight)
 {
@@ -41,11 +59,63 @@ GfxDriver::setProjectionMatrix(int windowWidth, int windowHeight)
 }
 
 void
-GfxDriver::bindTexture(RefPtr <Texture> texture)
+GfxDriver::pushProjectionMatrix()
+{
+	m_projectionMatrixStack.push_back(getProjectionMatrix());
+}
+
+void
+GfxDriver::popProjectionMatrix()
+{
+	if(m_projectionMatrixStack.empty())
+		throw Exception("GfxDriver::popProjectionMatrix(): Matrix stack is empty");
+
+	setProjectionMatrix(m_projectionMatrixStack.back());
+	m_projectionMatrixStack.pop_back();
+}
+
+void
+GfxDriver::pushModelViewMatrix()
+{
+	m_modelViewMatrixStack.push_back(getModelViewMatrix());
+}
+
+void
+GfxDriver::popModelViewMatrix()
+{
+	if(m_modelViewMatrixStack.empty())
+		throw Exception("GfxDriver::popModelViewMatrix(): Matrix stack is empty");
+
+	setModelViewMatrix(m_modelViewMatrixStack.back());
+	m_modelViewMatrixStack.pop_back();
+}
+
+void
+GfxDriver::bindTexture(const RefPtr <Texture> &texture)
 {
 	bindTexture(0, texture);
 }
 
+void
+GfxDriver::drawMeshInstanced(const Mesh *mesh, const Matrix4 *transforms,
+                             unsigned int numInstances)
+{
+	Matrix4 modelView = getModelViewMatrix();
+
+	// compute all of the modelview matrices at once
+	LinearAllocator &frameAllocator = LinearAllocator::getFrameAllocator();
+	LinearAllocatorScope scope(frameAllocator);
+	Matrix4 *modelViews = frameAllocator.allocateArray <Matrix4> (numInstances);
+	Matrix4::multiply(modelView, transforms, modelViews, numInstances);
+
+	for(unsigned int i = 0; i < numInstances; ++i) {
+		setModelViewMatrix(modelViews[i]);
+		drawMesh(mesh);
+	}
+
+	setModelViewMatrix(modelView);
+}
+
 GfxDriver *
 GfxDriver::create()
 {
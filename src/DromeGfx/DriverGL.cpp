@@ -23,9 +23,13 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdio>
+#include <cstring>
 #include <DromeCore/Exception.h>
+#include <DromeCore/Profiler.h>
 #include <DromeGfx/OpenGL.h>
 #include <DromeGfx/DriverGL.h>
+#include <DromeGfx/Mesh.h>
 
 using namespace std;
 using namespace DromeCore;
@@ -33,6 +37,13 @@ using namespace DromeMath;
 
 namespace DromeGfx {
 
+// the legacy Mac OS X headers only declare the
+// ARB versions of the instanced drawing functions
+#if defined(APPLE) && !defined(GLES)
+	#define glDrawElementsInstanced glDrawElementsInstancedARB
+	#define glVertexAttribDivisor glVertexAttribDivisorARB
+#endif
+
 /*
  * OpenGL Extensions
  */
@@ -115,6 +126,43 @@ GfxDriverGL::GfxDriverGL()
 {
 	loadExtensions();
 
+	m_viewportWidth = 0;
+	m_viewportHeight = 0;
+
+	// initialize the cached modes with values that don't match any
+	// valid mode so that the first call to each setter reaches GL;
+	// every bool is a valid state, so those are set explicitly below
+	m_depthMode = (DepthMode)-1;
+	m_blendMode = (BlendMode)-1;
+	m_cullFace = (CullFace)-1;
+	m_savedDepthWritesEnabled = true;
+	m_savedDepthMode = DEPTH_MODE_LESS_OR_EQUAL;
+
+	// the remaining cached state matches the initial GL state
+	m_matrixMode = GL_MODELVIEW;
+	m_activeTextureUnit = 0;
+	m_clientActiveTextureUnit = 0;
+	for(unsigned int i = 0; i < NUM_CLIENT_ARRAYS; ++i)
+		m_clientArrays[i] = false;
+
+	m_2DEnabled = false;
+	m_spriteBatch = SpriteBatch::create();
+
+	// instanced arrays are core since OpenGL 3.3
+	m_instancingSupported = false;
+#ifndef GLES
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int major = 0, minor = 0;
+	if(version && sscanf(version, "%d.%d", &major, &minor) == 2)
+		m_instancingSupported = (major > 3 || (major == 3 && minor >= 3));
+#ifdef APPLE
+	// legacy contexts report OpenGL 2.1, but may provide the ARB extensions
+	const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+	if(extensions && strstr(extensions, "GL_ARB_instanced_arrays") && strstr(extensions, "GL_ARB_draw_instanced"))
+		m_instancingSupported = true;
+#endif /* APPLE */
+#endif /* GLES */
+
 	// clear buffers
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 #ifdef GLES
@@ -124,10 +172,17 @@ GfxDriverGL::GfxDriverGL()
 #endif /* GLES */
 	clearBuffers();
 
+	// fill polygons and enable depth writes
+#ifndef GLES
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+#endif /* GLES */
+	m_wireframe = false;
+	glDepthMask(GL_TRUE);
+	m_depthWritesEnabled = true;
+
 	// set default blending and depth modes
 	glEnable(GL_BLEND);
 	setBlendMode(BLEND_MODE_ALPHA);
-	setDepthWritesEnabled(true);
 	setDepthMode(DEPTH_MODE_LESS_OR_EQUAL);
 
 	// enable backface culling
@@ -135,7 +190,6 @@ GfxDriverGL::GfxDriverGL()
 	glFrontFace(GL_CCW);
 
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_TEXTURE_2D);
 
 	flush();
@@ -145,15 +199,120 @@ GfxDriverGL::~GfxDriverGL()
 {
 }
 
+/**
+ * Updates the statistics for a state change.
+ * @param changed Whether the requested state differs from the cached state.
+ * @return The value of changed.
+ */
+bool
+GfxDriverGL::checkStateChange(bool changed)
+{
+	if(changed)
+		++m_stats.numStateChanges;
+	else
+		++m_stats.numElidedStateChanges;
+
+	return changed;
+}
+
+void
+GfxDriverGL::setMatrixMode(unsigned int mode)
+{
+	if(checkStateChange(mode != m_matrixMode)) {
+		glMatrixMode(mode);
+		m_matrixMode = mode;
+	}
+}
+
+void
+GfxDriverGL::setActiveTextureUnit(unsigned int textureUnit)
+{
+	if(checkStateChange(textureUnit != m_activeTextureUnit)) {
+		glActiveTexture(GL_TEXTURE0 + textureUnit);
+		m_activeTextureUnit = textureUnit;
+	}
+}
+
+void
+GfxDriverGL::setClientActiveTextureUnit(unsigned int textureUnit)
+{
+	if(checkStateChange(textureUnit != m_clientActiveTextureUnit)) {
+		glClientActiveTexture(GL_TEXTURE0 + textureUnit);
+		m_clientActiveTextureUnit = textureUnit;
+	}
+}
+
+void
+GfxDriverGL::setClientArrayEnabled(ClientArray array, bool enabled)
+{
+	if(!checkStateChange(enabled != m_clientArrays[array]))
+		return;
+
+	GLenum glArray;
+	switch(array) {
+		default:
+			throw Exception("GfxDriverGL::setClientArrayEnabled(): Invalid client array");
+			break;
+		case CLIENT_ARRAY_VERTEX:
+			glArray = GL_VERTEX_ARRAY;
+			break;
+		case CLIENT_ARRAY_NORMAL:
+			glArray = GL_NORMAL_ARRAY;
+			break;
+		case CLIENT_ARRAY_COLOR:
+			glArray = GL_COLOR_ARRAY;
+			break;
+		case CLIENT_ARRAY_TEXCOORD0:
+		case CLIENT_ARRAY_TEXCOORD1:
+		case CLIENT_ARRAY_TEXCOORD2:
+			// texture coordinate arrays are selected by the client active texture unit
+			setClientActiveTextureUnit(array - CLIENT_ARRAY_TEXCOORD0);
+			glArray = GL_TEXTURE_COORD_ARRAY;
+			break;
+	}
+
+	if(enabled)
+		glEnableClientState(glArray);
+	else
+		glDisableClientState(glArray);
+
+	m_clientArrays[array] = enabled;
+}
+
+void
+GfxDriverGL::bindArrayBuffer(const RefPtr <VertexBuffer> &buffer)
+{
+	if(checkStateChange(buffer != m_arrayBuffer)) {
+		glBindBuffer(GL_ARRAY_BUFFER, buffer.isSet() ? buffer->getId() : 0);
+		m_arrayBuffer = buffer;
+	}
+}
+
+void
+GfxDriverGL::bindElementBuffer(const RefPtr <IndexBuffer> &buffer)
+{
+	if(checkStateChange(buffer != m_elementBuffer)) {
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.isSet() ? buffer->getId() : 0);
+		m_elementBuffer = buffer;
+	}
+}
+
 void
 GfxDriverGL::flush()
 {
+	flushSprites();
 	glFinish();
+
+	// start counting the next frame
+	m_lastFrameStats = m_stats;
+	m_stats.reset();
 }
 
 void
 GfxDriverGL::clearBuffers()
 {
+	flushSprites();
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
@@ -163,7 +322,13 @@ GfxDriverGL::setWireframe(bool enabled)
 #ifdef GLES
 	throw Exception("GfxDriverGL::setWireframe(): Function not supported on this platform");
 #else
+	if(!checkStateChange(enabled != m_wireframe))
+		return;
+
+	flushSprites();
+
 	glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+	m_wireframe = enabled;
 #endif /* GLES */
 }
 
@@ -176,6 +341,11 @@ GfxDriverGL::getDepthWritesEnabled() const
 void
 GfxDriverGL::setDepthWritesEnabled(bool value)
 {
+	if(!checkStateChange(value != m_depthWritesEnabled))
+		return;
+
+	flushSprites();
+
 	glDepthMask(value);
 	m_depthWritesEnabled = value;
 }
@@ -189,6 +359,11 @@ GfxDriverGL::getDepthMode() const
 void
 GfxDriverGL::setDepthMode(DepthMode value)
 {
+	if(!checkStateChange(value != m_depthMode))
+		return;
+
+	flushSprites();
+
 	switch(value) {
 		default:
 			throw Exception("Unsupported depth mode");
@@ -218,6 +393,11 @@ GfxDriverGL::getBlendMode() const
 void
 GfxDriverGL::setBlendMode(BlendMode value)
 {
+	if(!checkStateChange(value != m_blendMode))
+		return;
+
+	flushSprites();
+
 	switch(value) {
 		default:
 			throw Exception("Unsupported depth mode");
@@ -236,6 +416,11 @@ GfxDriverGL::setBlendMode(BlendMode value)
 void
 GfxDriverGL::setCullFace(CullFace value)
 {
+	if(!checkStateChange(value != m_cullFace))
+		return;
+
+	flushSprites();
+
 	switch(value) {
 		default:
 			glDisable(GL_CULL_FACE);
@@ -249,6 +434,8 @@ GfxDriverGL::setCullFace(CullFace value)
 			glCullFace(GL_FRONT);
 			break;
 	}
+
+	m_cullFace = value;
 }
 
 /*
@@ -257,55 +444,65 @@ GfxDriverGL::setCullFace(CullFace value)
 Matrix4
 GfxDriverGL::getProjectionMatrix() const
 {
-	float m[16];
-	glGetFloatv(GL_PROJECTION_MATRIX, m);
-
-	return Matrix4(m);
+	return m_projectionMatrix;
 }
 
 void
 GfxDriverGL::setProjectionMatrix(const Matrix4 &value)
 {
-	glMatrixMode(GL_PROJECTION);
+	if(!checkStateChange(value != m_projectionMatrix))
+		return;
+
+	flushSprites();
+
+	setMatrixMode(GL_PROJECTION);
 	glLoadMatrixf(value.getData());
-	glMatrixMode(GL_MODELVIEW);
+	m_projectionMatrix = value;
 }
 
 Matrix4
 GfxDriverGL::getModelViewMatrix() const
 {
-	float m[16];
-	glGetFloatv(GL_MODELVIEW_MATRIX, m);
-
-	return Matrix4(m);
+	return m_modelViewMatrix;
 }
 
 void
 GfxDriverGL::setModelViewMatrix(const Matrix4 &value)
 {
+	if(!checkStateChange(value != m_modelViewMatrix))
+		return;
+
+	flushSprites();
+
+	setMatrixMode(GL_MODELVIEW);
 	glLoadMatrixf(value.getData());
+	m_modelViewMatrix = value;
 }
 
 Matrix4
 GfxDriverGL::getTextureMatrix() const
 {
-	float m[16];
-	glGetFloatv(GL_TEXTURE_MATRIX, m);
-
-	return Matrix4(m);
+	return m_textureMatrix;
 }
 
 void
 GfxDriverGL::setTextureMatrix(const Matrix4 &value)
 {
-	glMatrixMode(GL_TEXTURE);
+	if(!checkStateChange(value != m_textureMatrix))
+		return;
+
+	flushSprites();
+
+	setMatrixMode(GL_TEXTURE);
 	glLoadMatrixf(value.getData());
-	glMatrixMode(GL_MODELVIEW);
+	m_textureMatrix = value;
 }
 
 void
 GfxDriverGL::setViewportDimensions(int width, int height)
 {
+	flushSprites();
+
 	m_viewportWidth = width;
 	m_viewportHeight = height;
 	glViewport(0, 0, width, height);
@@ -314,47 +511,74 @@ GfxDriverGL::setViewportDimensions(int width, int height)
 void
 GfxDriverGL::enable2D()
 {
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glLoadIdentity();
-	glMatrixMode(GL_PROJECTION);
-	glPushMatrix();
-	glLoadIdentity();
-	glLoadMatrixf(Matrix4::orthographic(0.0f, m_viewportWidth, m_viewportHeight, 0.0f).getData());
-	glDisable(GL_DEPTH_TEST);
-	glDepthMask(GL_FALSE);
+	pushModelViewMatrix();
+	pushProjectionMatrix();
+	setModelViewMatrix(Matrix4());
+	setProjectionMatrix(Matrix4::orthographic(0.0f, m_viewportWidth, m_viewportHeight, 0.0f));
+
+	m_savedDepthMode = m_depthMode;
+	m_savedDepthWritesEnabled = m_depthWritesEnabled;
+	setDepthMode(DEPTH_MODE_NONE);
+	setDepthWritesEnabled(false);
+
+	m_2DEnabled = true;
 }
 
 void
 GfxDriverGL::disable2D()
 {
-	glMatrixMode(GL_PROJECTION);
-	glPopMatrix();
-	glMatrixMode(GL_MODELVIEW);
-	glPopMatrix();
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
+	flushSprites();
+
+	popProjectionMatrix();
+	popModelViewMatrix();
+
+	setDepthMode(m_savedDepthMode);
+	setDepthWritesEnabled(m_savedDepthWritesEnabled);
+
+	m_2DEnabled = false;
 }
 
 void
-GfxDriverGL::bindTexture(uint8_t textureUnit, RefPtr <Texture> texture)
+GfxDriverGL::setTexture(unsigned int textureUnit, const RefPtr <Texture> &texture)
 {
-	glActiveTexture(GL_TEXTURE0 + textureUnit);
-
-	if(!texture) {
-		glBindTexture(GL_TEXTURE_2D, 0);
+	if(texture == m_textures[textureUnit]) {
+		++m_stats.numElidedStateChanges;
+		++m_stats.numElidedTextureBinds;
 		return;
 	}
 
-	glBindTexture(GL_TEXTURE_2D, texture->getId());
+	++m_stats.numStateChanges;
+	++m_stats.numTextureBinds;
+
+	setActiveTextureUnit(textureUnit);
+	glBindTexture(GL_TEXTURE_2D, texture.isSet() ? texture->getId() : 0);
+	m_textures[textureUnit] = texture;
+}
+
+void
+GfxDriverGL::bindTexture(uint8_t textureUnit, const RefPtr <Texture> &texture)
+{
+	if(textureUnit >= MAX_TEXTURE_UNITS)
+		throw Exception("GfxDriverGL::bindTexture(): Invalid texture unit");
+
+	// pending sprites change the binding of the first texture unit
+	flushSprites();
+	setTexture(textureUnit, texture);
 }
 
 void
-GfxDriverGL::bindFramebuffer(RefPtr <Framebuffer> framebuffer)
+GfxDriverGL::bindFramebuffer(const RefPtr <Framebuffer> &framebuffer)
 {
 #ifdef GLES
-	throw Exception("GfxDriverGL::bindFramebuffer(): Function not supported on this platform");
+	// the default framebuffer is always bound
+	if(framebuffer.isSet())
+		throw Exception("GfxDriverGL::bindFramebuffer(): Function not supported on this platform");
 #else
+	if(!checkStateChange(framebuffer != m_framebuffer))
+		return;
+
+	flushSprites();
+
 	if(!framebuffer) {
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		glViewport(0, 0, m_viewportWidth, m_viewportHeight);
@@ -362,21 +586,30 @@ GfxDriverGL::bindFramebuffer(RefPtr <Framebuffer> framebuffer)
 		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->getFramebufferId());
 		glViewport(0, 0, framebuffer->getWidth(), framebuffer->getHeight());
 	}
+
+	m_framebuffer = framebuffer;
 #endif /* GLES */
 }
 
 void
-GfxDriverGL::bindShaderProgram(RefPtr <ShaderProgram> shaderProgram)
+GfxDriverGL::bindShaderProgram(const RefPtr <ShaderProgram> &shaderProgram)
 {
 #ifdef GLES
-	throw Exception("GfxDriverGL::bindShaderProgram(): Function not supported on this platform");
+	// the fixed-function pipeline is always in use
+	if(shaderProgram.isSet())
+		throw Exception("GfxDriverGL::bindShaderProgram(): Function not supported on this platform");
 #else
-	if(!shaderProgram) {
-		glUseProgram(0);
+	if(shaderProgram == m_shaderProgram) {
+		++m_stats.numElidedStateChanges;
+		++m_stats.numElidedShaderProgramBinds;
 		return;
 	}
 
-	glUseProgram(shaderProgram->getId());
+	++m_stats.numStateChanges;
+	++m_stats.numShaderProgramBinds;
+
+	glUseProgram(shaderProgram.isSet() ? shaderProgram->getId() : 0);
+	m_shaderProgram = shaderProgram;
 #endif /* GLES */
 }
 
@@ -384,50 +617,231 @@ GfxDriverGL::bindShaderProgram(RefPtr <ShaderProgram> shaderProgram)
  * Rendering functions
  */
 void
-GfxDriverGL::drawPic(RefPtr <Texture> texture, Color color,
-                     const Rect2i &src, const Rect2i &dest)
+GfxDriverGL::flushSprites()
 {
-	GfxDriver::bindTexture(texture);
+	if(m_spriteBatch->isEmpty())
+		return;
 
-	glColor4ub(color.r, color.g, color.b, color.a);
+	m_spriteBatch->sort();
 
-	short verts[] = {
-		dest.min.x, dest.min.y,
-		dest.min.x, dest.max.y,
-		dest.max.x, dest.min.y,
-		dest.max.x, dest.max.y,
-	};
+	// upload all quads at once; setBoundData() orphans the previous
+	// contents, so this doesn't wait for the last frame's draws
+	const float *data = (const float *)m_spriteBatch->getVertices();
+	int size = (int)(m_spriteBatch->getNumVertices() * sizeof(SpriteVertex) / sizeof(float));
+	if(!m_spriteBuffer) {
+		m_spriteBuffer = VertexBuffer::create(data, size, VERTEX_BUFFER_USAGE_STREAM);
+		bindArrayBuffer(m_spriteBuffer);
+	} else {
+		bindArrayBuffer(m_spriteBuffer);
+		m_spriteBuffer->setBoundData(data, size);
+	}
 
-	if(!texture) {
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(2, GL_SHORT, 0, verts);
+	setClientArrayEnabled(CLIENT_ARRAY_NORMAL, false);
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD1, false);
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD2, false);
+	setClientArrayEnabled(CLIENT_ARRAY_VERTEX, true);
+	setClientArrayEnabled(CLIENT_ARRAY_COLOR, true);
 
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glVertexPointer(2, GL_FLOAT, sizeof(SpriteVertex), 0);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SpriteVertex), (void *)(sizeof(float) * 4));
+	setClientActiveTextureUnit(0);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteVertex), (void *)(sizeof(float) * 2));
 
-		glVertexPointer(2, GL_SHORT, 0, 0);
-		glDisableClientState(GL_VERTEX_ARRAY);
-	} else {
-		float texCoords[] = {
-			(float)src.min.x / (float)texture->getWidth(), (float)src.min.y / (float)texture->getHeight(),
-			(float)src.min.x / (float)texture->getWidth(), (float)src.max.y / (float)texture->getHeight(),
-			(float)src.max.x / (float)texture->getWidth(), (float)src.min.y / (float)texture->getHeight(),
-			(float)src.max.x / (float)texture->getWidth(), (float)src.max.y / (float)texture->getHeight()
-		};
+	// draw each range of quads that uses the same texture
+	for(unsigned int i = 0; i < m_spriteBatch->getNumBatches(); ++i) {
+		const SpriteBatch::Batch &batch = m_spriteBatch->getBatch(i);
 
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(2, GL_SHORT, 0, verts);
+		setTexture(0, batch.texture);
+		setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD0, batch.texture.isSet());
 
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDrawArrays(GL_TRIANGLES, batch.firstVertex, batch.numVertices);
+		++m_stats.numDrawCalls;
+	}
+
+	// the current color is undefined after drawing with a color array
+	setClientArrayEnabled(CLIENT_ARRAY_COLOR, false);
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+	m_spriteBatch->clear();
+}
+
+void
+GfxDriverGL::drawPic(const RefPtr <Texture> &texture, Color color,
+                     const Rect2i &src, const Rect2i &dest)
+{
+	ProfilerZone zone("GfxDriverGL::drawPic");
+
+	m_spriteBatch->addQuad(texture, color, src, dest);
+
+	// pictures are only batched in 2D mode
+	if(!m_2DEnabled)
+		flushSprites();
+}
+
+void
+GfxDriverGL::drawPrimitives(PrimitiveType type, unsigned int numVertices,
+                            const Vector3 *vertices, const float *texCoords,
+                            const Color *colors)
+{
+	flushSprites();
+
+	// the arrays are in client memory
+	bindArrayBuffer(VertexBuffer::none());
+
+	setClientArrayEnabled(CLIENT_ARRAY_VERTEX, true);
+	setClientArrayEnabled(CLIENT_ARRAY_NORMAL, false);
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD1, false);
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD2, false);
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD0, texCoords != 0);
+	setClientArrayEnabled(CLIENT_ARRAY_COLOR, colors != 0);
+
+	glVertexPointer(3, GL_FLOAT, sizeof(Vector3), vertices);
+	setClientActiveTextureUnit(0);
+	if(texCoords)
 		glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+	if(colors)
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Color), colors);
+	else
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+	glDrawArrays(primitiveTypeToGL(type), 0, numVertices);
+	++m_stats.numDrawCalls;
+
+	// the current color is undefined after drawing with a color array
+	if(colors) {
+		setClientArrayEnabled(CLIENT_ARRAY_COLOR, false);
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	}
+}
 
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+/**
+ * Sets up the vertex arrays for drawing a mesh.
+ */
+void
+GfxDriverGL::setMeshArrays(const Mesh *mesh)
+{
+	const VertexLayout &layout = mesh->getVertexLayout();
+	GLsizei stride = layout.getStride();
+
+	// all attributes come from the same interleaved buffer
+	bindArrayBuffer(mesh->getVertexBuffer());
+
+	setClientArrayEnabled(CLIENT_ARRAY_COLOR, false);
+	setClientArrayEnabled(CLIENT_ARRAY_VERTEX, true);
+	glVertexPointer(3, GL_FLOAT, stride, (void *)(size_t)layout.getOffset(VERTEX_ATTRIBUTE_POSITION));
+
+	// use texture unit 1 for tangents
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD1, layout.hasAttribute(VERTEX_ATTRIBUTE_TANGENT));
+	if(layout.hasAttribute(VERTEX_ATTRIBUTE_TANGENT)) {
+		setClientActiveTextureUnit(1);
+		glTexCoordPointer(3, GL_FLOAT, stride, (void *)(size_t)layout.getOffset(VERTEX_ATTRIBUTE_TANGENT));
+	}
+
+	// use texture unit 2 for binormals
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD2, layout.hasAttribute(VERTEX_ATTRIBUTE_BINORMAL));
+	if(layout.hasAttribute(VERTEX_ATTRIBUTE_BINORMAL)) {
+		setClientActiveTextureUnit(2);
+		glTexCoordPointer(3, GL_FLOAT, stride, (void *)(size_t)layout.getOffset(VERTEX_ATTRIBUTE_BINORMAL));
+	}
+
+	// normals
+	setClientArrayEnabled(CLIENT_ARRAY_NORMAL, layout.hasAttribute(VERTEX_ATTRIBUTE_NORMAL));
+	if(layout.hasAttribute(VERTEX_ATTRIBUTE_NORMAL))
+		glNormalPointer(GL_FLOAT, stride, (void *)(size_t)layout.getOffset(VERTEX_ATTRIBUTE_NORMAL));
+
+	// texture coordinates
+	setClientArrayEnabled(CLIENT_ARRAY_TEXCOORD0, layout.hasAttribute(VERTEX_ATTRIBUTE_TEXCOORD));
+	setClientActiveTextureUnit(0);
+	if(layout.hasAttribute(VERTEX_ATTRIBUTE_TEXCOORD))
+		glTexCoordPointer(2, GL_FLOAT, stride, (void *)(size_t)layout.getOffset(VERTEX_ATTRIBUTE_TEXCOORD));
+}
+
+/**
+ * Draws the commands of a mesh whose vertex arrays have been set up with setMeshArrays().
+ * @param numInstances The number of instances to draw, or 0 to draw without instancing.
+ */
+void
+GfxDriverGL::drawMeshCommands(const Mesh *mesh, unsigned int numInstances)
+{
+	// use indices from the mesh's index buffer if
+	// it has one or from client memory otherwise
+	const RefPtr <IndexBuffer> &indexBuffer = mesh->getIndexBuffer();
+	bindElementBuffer(indexBuffer);
+	for(unsigned int i = 0; i < mesh->getNumCommands(); i++) {
+		const Mesh::Command *cmd = mesh->getCommand(i);
+		const void *indices = cmd->indices;
+		if(indexBuffer.isSet())
+			indices = (const void *)(sizeof(unsigned short) * cmd->firstIndex);
+
+#ifdef GLES
+		glDrawElements(primitiveTypeToGL(cmd->type), cmd->numIndices, GL_UNSIGNED_SHORT, indices);
+#else
+		if(numInstances > 0)
+			glDrawElementsInstanced(primitiveTypeToGL(cmd->type), cmd->numIndices, GL_UNSIGNED_SHORT, indices, numInstances);
+		else
+			glDrawElements(primitiveTypeToGL(cmd->type), cmd->numIndices, GL_UNSIGNED_SHORT, indices);
+#endif /* GLES */
+		++m_stats.numDrawCalls;
+	}
+}
+
+void
+GfxDriverGL::drawMesh(const Mesh *mesh)
+{
+	flushSprites();
+
+	setMeshArrays(mesh);
+	drawMeshCommands(mesh, 0);
+}
 
-		glTexCoordPointer(2, GL_FLOAT, 0, 0);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+void
+GfxDriverGL::drawMeshInstanced(const Mesh *mesh, const Matrix4 *transforms,
+                               unsigned int numInstances)
+{
+	flushSprites();
 
-		glVertexPointer(2, GL_SHORT, 0, 0);
-		glDisableClientState(GL_VERTEX_ARRAY);
+#ifdef GLES
+	GfxDriver::drawMeshInstanced(mesh, transforms, numInstances);
+#else
+	// hardware instancing needs a shader program that reads the
+	// instance transforms from the instanceMatrix attribute
+	int location = -1;
+	if(m_instancingSupported && m_shaderProgram.isSet())
+		location = m_shaderProgram->getInstanceMatrixLocation();
+	if(location < 0) {
+		GfxDriver::drawMeshInstanced(mesh, transforms, numInstances);
+		return;
 	}
+
+	if(numInstances == 0)
+		return;
+
+	setMeshArrays(mesh);
+
+	// upload the transforms, orphaning the previous contents of the buffer
+	int size = (int)numInstances * 16;
+	if(!m_instanceBuffer) {
+		m_instanceBuffer = VertexBuffer::create((const float *)transforms, size, VERTEX_BUFFER_USAGE_STREAM);
+		bindArrayBuffer(m_instanceBuffer);
+	} else {
+		bindArrayBuffer(m_instanceBuffer);
+		m_instanceBuffer->setBoundData((const float *)transforms, size);
+	}
+
+	// a mat4 attribute occupies four consecutive locations, one per column
+	for(int i = 0; i < 4; ++i) {
+		glEnableVertexAttribArray(location + i);
+		glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4), (void *)(sizeof(float) * 4 * i));
+		glVertexAttribDivisor(location + i, 1);
+	}
+
+	drawMeshCommands(mesh, numInstances);
+
+	for(int i = 0; i < 4; ++i) {
+		glVertexAttribDivisor(location + i, 0);
+		glDisableVertexAttribArray(location + i);
+	}
+#endif /* GLES */
 }
 
 } // namespace DromeGfx
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <DromeCore/Exception.h>
+#include <DromeGfx/DriverRecorder.h>
+#include <DromeGfx/Mesh.h>
+
+using namespace DromeCore;
+using namespace DromeMath;
+
+namespace DromeGfx {
+
+GfxDriverRecorder::GfxDriverRecorder()
+{
+	m_viewportWidth = 0;
+	m_viewportHeight = 0;
+	m_wireframe = false;
+
+	// use the same defaults as GfxDriverGL
+	m_depthWritesEnabled = true;
+	m_depthMode = DEPTH_MODE_LESS_OR_EQUAL;
+	m_blendMode = BLEND_MODE_ALPHA;
+	m_cullFace = CULL_FACE_BACK;
+
+	clear();
+}
+
+GfxDriverRecorder::~GfxDriverRecorder()
+{
+}
+
+void
+GfxDriverRecorder::record(GfxCommandType type, bool redundant, uint32_t value,
+                          const void *object)
+{
+	GfxCommand cmd;
+	cmd.type = type;
+	cmd.redundant = redundant;
+	cmd.value = value;
+	cmd.object = object;
+	m_commands.push_back(cmd);
+
+	++m_commandCounts[type];
+	if(redundant)
+		++m_numRedundantCommands;
+}
+
+void
+GfxDriverRecorder::clear()
+{
+	// clear() keeps the allocated capacity, so recording
+	// the following frames doesn't allocate any memory
+	m_commands.clear();
+
+	for(unsigned int i = 0; i < NUM_GFX_COMMANDS; ++i)
+		m_commandCounts[i] = 0;
+	m_numRedundantCommands = 0;
+	m_numFrames = 0;
+}
+
+void
+GfxDriverRecorder::flush()
+{
+	record(GFX_COMMAND_FLUSH);
+	++m_numFrames;
+}
+
+void
+GfxDriverRecorder::clearBuffers()
+{
+	record(GFX_COMMAND_CLEAR_BUFFERS);
+}
+
+void
+GfxDriverRecorder::setWireframe(bool enabled)
+{
+	record(GFX_COMMAND_SET_WIREFRAME, enabled == m_wireframe, enabled);
+	m_wireframe = enabled;
+}
+
+bool
+GfxDriverRecorder::getDepthWritesEnabled() const
+{
+	return m_depthWritesEnabled;
+}
+
+void
+GfxDriverRecorder::setDepthWritesEnabled(bool value)
+{
+	record(GFX_COMMAND_SET_DEPTH_WRITES_ENABLED, value == m_depthWritesEnabled, value);
+	m_depthWritesEnabled = value;
+}
+
+DepthMode
+GfxDriverRecorder::getDepthMode() const
+{
+	return m_depthMode;
+}
+
+void
+GfxDriverRecorder::setDepthMode(DepthMode value)
+{
+	record(GFX_COMMAND_SET_DEPTH_MODE, value == m_depthMode, value);
+	m_depthMode = value;
+}
+
+BlendMode
+GfxDriverRecorder::getBlendMode() const
+{
+	return m_blendMode;
+}
+
+void
+GfxDriverRecorder::setBlendMode(BlendMode value)
+{
+	record(GFX_COMMAND_SET_BLEND_MODE, value == m_blendMode, value);
+	m_blendMode = value;
+}
+
+void
+GfxDriverRecorder::setCullFace(CullFace value)
+{
+	record(GFX_COMMAND_SET_CULL_FACE, value == m_cullFace, value);
+	m_cullFace = value;
+}
+
+/*
+ * Matrix functions
+ */
+Matrix4
+GfxDriverRecorder::getProjectionMatrix() const
+{
+	return m_projectionMatrix;
+}
+
+void
+GfxDriverRecorder::setProjectionMatrix(const Matrix4 &value)
+{
+	record(GFX_COMMAND_SET_PROJECTION_MATRIX, value == m_projectionMatrix);
+	m_projectionMatrix = value;
+}
+
+Matrix4
+GfxDriverRecorder::getModelViewMatrix() const
+{
+	return m_modelViewMatrix;
+}
+
+void
+GfxDriverRecorder::setModelViewMatrix(const Matrix4 &value)
+{
+	record(GFX_COMMAND_SET_MODELVIEW_MATRIX, value == m_modelViewMatrix);
+	m_modelViewMatrix = value;
+}
+
+Matrix4
+GfxDriverRecorder::getTextureMatrix() const
+{
+	return m_textureMatrix;
+}
+
+void
+GfxDriverRecorder::setTextureMatrix(const Matrix4 &value)
+{
+	record(GFX_COMMAND_SET_TEXTURE_MATRIX, value == m_textureMatrix);
+	m_textureMatrix = value;
+}
+
+void
+GfxDriverRecorder::setViewportDimensions(int width, int height)
+{
+	record(GFX_COMMAND_SET_VIEWPORT_DIMENSIONS, width == m_viewportWidth && height == m_viewportHeight);
+	m_viewportWidth = width;
+	m_viewportHeight = height;
+}
+
+void
+GfxDriverRecorder::enable2D()
+{
+	record(GFX_COMMAND_ENABLE_2D);
+
+	pushModelViewMatrix();
+	pushProjectionMatrix();
+	setModelViewMatrix(Matrix4());
+	setProjectionMatrix(Matrix4::orthographic(0.0f, m_viewportWidth, m_viewportHeight, 0.0f));
+}
+
+void
+GfxDriverRecorder::disable2D()
+{
+	record(GFX_COMMAND_DISABLE_2D);
+
+	popProjectionMatrix();
+	popModelViewMatrix();
+}
+
+void
+GfxDriverRecorder::bindTexture(uint8_t textureUnit, const RefPtr <Texture> &texture)
+{
+	if(textureUnit >= MAX_TEXTURE_UNITS)
+		throw Exception("GfxDriverRecorder::bindTexture(): Invalid texture unit");
+
+	record(GFX_COMMAND_BIND_TEXTURE, texture == m_textures[textureUnit], textureUnit, texture.get());
+	m_textures[textureUnit] = texture;
+}
+
+void
+GfxDriverRecorder::bindFramebuffer(const RefPtr <Framebuffer> &framebuffer)
+{
+	record(GFX_COMMAND_BIND_FRAMEBUFFER, framebuffer == m_framebuffer, 0, framebuffer.get());
+	m_framebuffer = framebuffer;
+}
+
+void
+GfxDriverRecorder::bindShaderProgram(const RefPtr <ShaderProgram> &shaderProgram)
+{
+	record(GFX_COMMAND_BIND_SHADER_PROGRAM, shaderProgram == m_shaderProgram, 0, shaderProgram.get());
+	m_shaderProgram = shaderProgram;
+}
+
+/*
+ * Rendering functions
+ */
+void
+GfxDriverRecorder::drawPic(const RefPtr <Texture> &texture, Color color,
+                           const Rect2i & /*src*/, const Rect2i & /*dest*/)
+{
+	// drawPic binds the texture to the first texture unit
+	GfxDriver::bindTexture(texture);
+
+	record(GFX_COMMAND_DRAW_PIC, false, color.toUInt32(), texture.get());
+}
+
+void
+GfxDriverRecorder::drawPrimitives(PrimitiveType /*type*/, unsigned int numVertices,
+                                  const Vector3 * /*vertices*/, const float * /*texCoords*/,
+                                  const Color * /*colors*/)
+{
+	record(GFX_COMMAND_DRAW_PRIMITIVES, false, numVertices);
+}
+
+void
+GfxDriverRecorder::drawMesh(const Mesh *mesh)
+{
+	uint32_t numIndices = 0;
+	for(unsigned int i = 0; i < mesh->getNumCommands(); ++i)
+		numIndices += mesh->getCommand(i)->numIndices;
+
+	record(GFX_COMMAND_DRAW_MESH, false, numIndices, mesh);
+}
+
+void
+GfxDriverRecorder::drawMeshInstanced(const Mesh *mesh, const Matrix4 * /*transforms*/,
+                                     unsigned int numInstances)
+{
+	record(GFX_COMMAND_DRAW_MESH_INSTANCED, false, numInstances, mesh);
+}
+
+} // namespace DromeGfx
@@ -36,6 +36,18 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height, bool depth)
 	m_width = width;
 	m_height = height;
 
+	// without OpenGL, the Texture constructor
+	// doesn't generate a texture either
+	m_framebufferId = 0;
+	if(m_id == 0)
+		return;
+
+	// remember the previous bindings so that the
+	// state cached by the driver stays valid
+	GLint previousTextureId, previousFramebufferId;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTextureId);
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebufferId);
+
 	// bind texture (glGenTextures has already been called
 	// by the Texture class constructor at this point)
 	glBindTexture(GL_TEXTURE_2D, m_id);
@@ -68,13 +80,15 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height, bool depth)
 	else
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_id, 0);
 
-	// bind the main framebuffer again
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	// bind the previous texture and framebuffer again
+	glBindTexture(GL_TEXTURE_2D, previousTextureId);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebufferId);
 }
 
 Framebuffer::~Framebuffer()
 {
-	glDeleteFramebuffers(1, &m_framebufferId);
+	if(m_framebufferId != 0)
+		glDeleteFramebuffers(1, &m_framebufferId);
 }
 
 unsigned int
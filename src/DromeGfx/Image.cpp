@@ -26,7 +26,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <DromeCore/Exception.h>
+#include <DromeCore/ObjectPool.h>
 #include <DromeCore/File.h>
+#include <DromeCore/Profiler.h>
 #include <DromeCore/String.h>
 #include <DromeCore/Util.h>
 #include <DromeGfx/Image.h>
@@ -38,6 +40,20 @@ using namespace DromeCore;
 
 namespace DromeGfx {
 
+static ObjectPool imagePool("Image");
+
+void *
+Image::operator new(size_t size)
+{
+	return imagePool.allocate(size);
+}
+
+void
+Image::operator delete(void *ptr, size_t size)
+{
+	imagePool.deallocate(ptr, size);
+}
+
 /*
  * Image
  */
@@ -200,7 +216,7 @@ Image::scale(unsigned int width, unsigned int height)
 }
 
 void
-Image::copyFrom(RefPtr <Image> image)
+Image::copyFrom(const RefPtr <Image> &image)
 {
 	// get smallest dimensions
 	unsigned int w = image->getWidth();
@@ -220,6 +236,8 @@ Image::copyFrom(RefPtr <Image> image)
 RefPtr <Image>
 Image::create(const string &filename)
 {
+	ProfilerZone zone("Image::create");
+
 	// get file extension position
 	size_t tmp = filename.find_last_of('.');
 	if(tmp == string::npos)
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <DromeCore/Exception.h>
+#include <DromeCore/ObjectPool.h>
+#include <DromeGfx/Driver.h>
+#include <DromeGfx/OpenGL.h>
+#include <DromeGfx/IndexBuffer.h>
+
+using namespace DromeCore;
+
+namespace DromeGfx {
+
+static ObjectPool indexBufferPool("IndexBuffer");
+
+void *
+IndexBuffer::operator new(size_t size)
+{
+	return indexBufferPool.allocate(size);
+}
+
+void
+IndexBuffer::operator delete(void *ptr, size_t size)
+{
+	indexBufferPool.deallocate(ptr, size);
+}
+
+IndexBuffer::IndexBuffer(const unsigned short *data, int size)
+{
+	m_size = size;
+
+	m_id = 0;
+	if(!GfxDriver::isGLEnabled())
+		return;
+
+	// remember the previous binding so that the
+	// state cached by the driver stays valid
+	GLint previousId;
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &previousId);
+
+	glGenBuffers(1, &m_id);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * size, data, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, previousId);
+}
+
+IndexBuffer::~IndexBuffer()
+{
+	if(m_id != 0)
+		glDeleteBuffers(1, &m_id);
+}
+
+unsigned int
+IndexBuffer::getId() const
+{
+	return m_id;
+}
+
+int
+IndexBuffer::getSize() const
+{
+	return m_size;
+}
+
+RefPtr <IndexBuffer>
+IndexBuffer::none()
+{
+	return RefPtr <IndexBuffer> ();
+}
+
+RefPtr <IndexBuffer>
+IndexBuffer::create(const unsigned short *data, int size)
+{
+	return RefPtr <IndexBuffer> (new IndexBuffer(data, size));
+}
+
+} // namespace DromeGfx
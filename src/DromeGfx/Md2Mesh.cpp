@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <DromeCore/Endian.h>
 #include <DromeCore/Exception.h>
+#include <DromeCore/Profiler.h>
 #include <DromeGfx/Md2Mesh.h>
 
 using namespace std;
@@ -74,6 +75,12 @@ struct Md2GlCommandVertex
 
 namespace DromeGfx {
 
+struct Md2MeshVertex
+{
+	Vector3 position;
+	float s, t;
+};
+
 Md2Mesh::Md2Mesh(const char *filePath, const Vector3 &scale)
 {
 	// open file
@@ -91,7 +98,7 @@ Md2Mesh::Md2Mesh(const char *filePath, const Vector3 &scale)
 		*p = littleToNativeInt32(*p);
 	}
 
-	// load vertices
+	// load vertex positions
 	Vector3 *verts = new Vector3[hdr.numVertices];
 	fseek(fp, hdr.offsetFrames, SEEK_SET);
 	//for(int32_t i = 0; i < hdr.numFrames; ++i) {
@@ -106,28 +113,33 @@ Md2Mesh::Md2Mesh(const char *filePath, const Vector3 &scale)
 		}
 
 		// read vertices
+		vector<Md2TriangleVertexByte> vbs(hdr.numVertices);
+		if(hdr.numVertices > 0)
+			fread(&vbs[0], sizeof(Md2TriangleVertexByte), hdr.numVertices, fp);
 		for(int32_t j = 0; j < hdr.numVertices; ++j) {
-			Md2TriangleVertexByte vb;
-			fread(&vb, sizeof(vb), 1, fp);
-
-			verts[j].x = (float)vb.vertex[0] * frame.scale[0] + frame.translate[0];
-			verts[j].y = (float)vb.vertex[1] * frame.scale[1] + frame.translate[1];
-			verts[j].z = (float)vb.vertex[2] * frame.scale[2] + frame.translate[2];
-			verts[j] *= scale;
+			verts[j].x = (float)vbs[j].vertex[0];
+			verts[j].y = (float)vbs[j].vertex[1];
+			verts[j].z = (float)vbs[j].vertex[2];
 		}
 
-		m_vertices = VertexBuffer::create(verts, hdr.numVertices);
+		// decompress the vertices and apply the mesh scale in one batch
+		Vector3 frameScale(frame.scale[0], frame.scale[1], frame.scale[2]);
+		Vector3 frameTranslate(frame.translate[0], frame.translate[1], frame.translate[2]);
+		Matrix4 m = Matrix4::scaling(scale) * Matrix4::translation(frameTranslate) * Matrix4::scaling(frameScale);
+		m.transformPoints(verts, verts, hdr.numVertices);
 	}
-	delete [] verts;
 
-	// load glcommands
-	float *texCoords = new float[hdr.numVertices * 2];
+	// load glcommands; texture coordinates are stored per glcommand
+	// vertex, so each glcommand vertex becomes a separate mesh vertex
+	vector<Md2MeshVertex> meshVerts;
 	fseek(fp, hdr.offsetGlCommands, SEEK_SET);
 	for(int32_t i = 0; i < hdr.numGlCommands; ++i) {
-		// get number of indices
+		// get number of indices; a count of zero ends the list
 		int32_t num;
 		fread(&num, sizeof(num), 1, fp);
 		num = littleToNativeInt32(num);
+		if(num == 0)
+			break;
 
 		// create the command; if the number of indices
 		// from the file is negative, the command is a
@@ -154,35 +166,54 @@ Md2Mesh::Md2Mesh(const char *filePath, const Vector3 &scale)
 
 			if(glcv.vertexIndex < 0 || glcv.vertexIndex >= hdr.numVertices) {
 				delete cmd;
-				delete [] texCoords;
+				delete [] verts;
 				fclose(fp);
 				throw Exception("Md2Mesh::Md2Mesh(): Md2GlCommandVertex has invalid vertex index");
 			}
 
-			// save texture coordinates and vertex index
-			texCoords[glcv.vertexIndex * 2 + 0] = glcv.s;
-			texCoords[glcv.vertexIndex * 2 + 1] = glcv.t;
-			cmd->indices[j] = glcv.vertexIndex;
+			if(meshVerts.size() > 0xffff) {
+				delete cmd;
+				delete [] verts;
+				fclose(fp);
+				throw Exception("Md2Mesh::Md2Mesh(): Too many vertices");
+			}
+
+			// save vertex
+			Md2MeshVertex v;
+			v.position = verts[glcv.vertexIndex];
+			v.s = glcv.s;
+			v.t = glcv.t;
+			cmd->indices[j] = (unsigned short)meshVerts.size();
+			meshVerts.push_back(v);
 		}
 
-		cmd->texCoords = VertexBuffer::create(texCoords, hdr.numVertices * 2);
 		m_commands.push_back(cmd);
 	}
-	delete [] texCoords;
+	delete [] verts;
 
 	fclose(fp);
+
+	// create vertex buffer
+	VertexLayout layout(sizeof(Md2MeshVertex));
+	layout.setAttribute(VERTEX_ATTRIBUTE_POSITION, 0);
+	layout.setAttribute(VERTEX_ATTRIBUTE_TEXCOORD, sizeof(float) * 3);
+	setVertices(meshVerts.empty() ? NULL : &meshVerts[0], (unsigned int)meshVerts.size(), layout);
+
+	// draw the whole mesh with a single call
+	bake();
 }
 
 RefPtr <Md2Mesh>
 Md2Mesh::create(const char *filePath, const Vector3 &scale)
 {
+	ProfilerZone zone("Md2Mesh::create");
 	return RefPtr <Md2Mesh> (new Md2Mesh(filePath, scale));
 }
 
 RefPtr <Md2Mesh>
 Md2Mesh::create(const char *filePath, float scale)
 {
-	return RefPtr <Md2Mesh> (new Md2Mesh(filePath, Vector3(scale, scale, scale)));
+	return create(filePath, Vector3(scale, scale, scale));
 }
 
 } // namespace DromeGfx
@@ -23,15 +23,33 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <vector>
 #include <DromeCore/Exception.h>
+#include <DromeCore/ObjectPool.h>
+#include <DromeCore/Profiler.h>
+#include <DromeGfx/Driver.h>
 #include <DromeGfx/Mesh.h>
-#include <DromeGfx/OpenGL.h>
 
+using namespace std;
 using namespace DromeCore;
 using namespace DromeMath;
 
 namespace DromeGfx {
 
+static ObjectPool meshPool("Mesh");
+
+void *
+Mesh::operator new(size_t size)
+{
+	return meshPool.allocate(size);
+}
+
+void
+Mesh::operator delete(void *ptr, size_t size)
+{
+	meshPool.deallocate(ptr, size);
+}
+
 /*
  * Mesh::Command
  */
@@ -40,6 +58,7 @@ Mesh::Command::Command()
 	type = PRIMITIVE_TYPE_TRIANGLE_STRIP;
 	indices = NULL;
 	numIndices = 0;
+	firstIndex = 0;
 }
 
 Mesh::Command::Command(unsigned int numIndicesParam)
@@ -47,6 +66,7 @@ Mesh::Command::Command(unsigned int numIndicesParam)
 	type = PRIMITIVE_TYPE_TRIANGLE_STRIP;
 	indices = new unsigned short [numIndicesParam];
 	numIndices = numIndicesParam;
+	firstIndex = 0;
 }
 
 Mesh::Command::~Command()
@@ -60,102 +80,125 @@ Mesh::Command::~Command()
  */
 Mesh::Mesh()
 {
-	m_vertexData = NULL;
-	m_tangentSpaceData = NULL;
-
 	m_numVertices = 0;
 }
 
 Mesh::~Mesh()
 {
-	// delete vertex/tangent space data
-	if(m_vertexData)
-		delete [] m_vertexData;
-	if(m_tangentSpaceData)
-		delete [] m_tangentSpaceData;
-
 	// delete commands
 	for(unsigned int i = 0; i < m_commands.size(); i++)
 		delete m_commands[i];
 }
 
 void
-Mesh::render()
+Mesh::setVertices(const void *data, unsigned int numVertices, const VertexLayout &layout)
 {
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glBindBuffer(GL_ARRAY_BUFFER, m_vertices->getId());
-	glVertexPointer(3, GL_FLOAT, 0, 0);
-
-	// use tangent space if available
-	if(m_tangentSpace.isSet()) {
-		// use texture unit 1 for tangents
-		glClientActiveTexture(GL_TEXTURE1);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glBindBuffer(GL_ARRAY_BUFFER, m_tangentSpace->getId());
-		glTexCoordPointer(3, GL_FLOAT, sizeof(float) * 9, 0);
-
-		// use texture unit 2 for binormals
-		glClientActiveTexture(GL_TEXTURE2);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glBindBuffer(GL_ARRAY_BUFFER, m_tangentSpace->getId());
-		glTexCoordPointer(3, GL_FLOAT, sizeof(float) * 9, (void *)(sizeof(float) * 3));
-
-		glClientActiveTexture(GL_TEXTURE0);
-
-		// normals
-		glEnableClientState(GL_NORMAL_ARRAY);
-		glBindBuffer(GL_ARRAY_BUFFER, m_tangentSpace->getId());
-		glNormalPointer(GL_FLOAT, sizeof(float) * 9, (void *)(sizeof(float) * 6));
-	}
+	if(layout.getStride() % sizeof(float) != 0)
+		throw Exception("Mesh::setVertices(): Vertex stride must be a multiple of four bytes");
+	if(!layout.hasAttribute(VERTEX_ATTRIBUTE_POSITION))
+		throw Exception("Mesh::setVertices(): Vertex layout has no position attribute");
+
+	m_vertexBuffer = VertexBuffer::create((const float *)data, (int)(numVertices * layout.getStride() / sizeof(float)));
+	m_vertexLayout = layout;
+	m_numVertices = numVertices;
+}
 
-	// render each command
-	RefPtr <VertexBuffer> lastTexCoords;
-	for(unsigned int i = 0; i < m_commands.size(); i++) {
-		RefPtr <VertexBuffer> texCoords = m_commands[i]->texCoords.isSet() ? m_commands[i]->texCoords : m_texCoords;
-
-		// use texture coordinates if available
-		if(texCoords != lastTexCoords) {
-			if(texCoords.isSet()) {
-				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-				glBindBuffer(GL_ARRAY_BUFFER, texCoords->getId());
-				glTexCoordPointer(2, GL_FLOAT, 0, 0);
-			} else {
-				glTexCoordPointer(2, GL_FLOAT, 0, 0);
-				glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-			}
-		}
+void
+Mesh::setVertices(const std::vector <MeshVertex> &vertices)
+{
+	setVertices(vertices.empty() ? NULL : &vertices[0], (unsigned int)vertices.size(), VertexLayout::meshVertex());
+}
 
-		lastTexCoords = texCoords;
+void
+Mesh::createIndexBuffer()
+{
+	vector <unsigned short> indices;
+	for(unsigned int i = 0; i < m_commands.size(); ++i) {
+		Command *cmd = m_commands[i];
 
-		glDrawElements(primitiveTypeToGL(m_commands[i]->type), m_commands[i]->numIndices, GL_UNSIGNED_SHORT, m_commands[i]->indices);
+		cmd->firstIndex = (unsigned int)indices.size();
+		indices.insert(indices.end(), cmd->indices, cmd->indices + cmd->numIndices);
 	}
 
-	// disable vertex array
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glVertexPointer(3, GL_FLOAT, 0, 0);
-	glDisableClientState(GL_VERTEX_ARRAY);
-
-	// disable the arrays used for the tangent space matrices
-	if(m_tangentSpace.isSet()) {
-		glNormalPointer(GL_FLOAT, 0, 0);
-		glDisableClientState(GL_NORMAL_ARRAY);
+	if(indices.empty())
+		m_indexBuffer = IndexBuffer::none();
+	else
+		m_indexBuffer = IndexBuffer::create(&indices[0], (int)indices.size());
+}
 
-		glClientActiveTexture(GL_TEXTURE2);
-		glTexCoordPointer(3, GL_FLOAT, 0, 0);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+static void
+addTriangle(vector <unsigned short> &indices, unsigned short a, unsigned short b, unsigned short c)
+{
+	// skip degenerate triangles, such as the ones used to join strips
+	if(a == b || b == c || a == c)
+		return;
 
-		glClientActiveTexture(GL_TEXTURE1);
-		glTexCoordPointer(3, GL_FLOAT, 0, 0);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	indices.push_back(a);
+	indices.push_back(b);
+	indices.push_back(c);
+}
 
-		glClientActiveTexture(GL_TEXTURE0);
+void
+Mesh::bake()
+{
+	vector <unsigned short> indices;
+
+	for(unsigned int i = 0; i < m_commands.size(); ++i) {
+		const Command *cmd = m_commands[i];
+		const unsigned short *idx = cmd->indices;
+
+		switch(cmd->type) {
+			default:
+				throw Exception("Mesh::bake(): Only triangle commands can be baked");
+				break;
+			case PRIMITIVE_TYPE_TRIANGLES:
+				for(unsigned int j = 0; j + 2 < cmd->numIndices; j += 3)
+					addTriangle(indices, idx[j], idx[j+1], idx[j+2]);
+				break;
+			case PRIMITIVE_TYPE_TRIANGLE_STRIP:
+				// every other triangle in a strip has reversed winding
+				for(unsigned int j = 0; j + 2 < cmd->numIndices; ++j) {
+					if(j % 2 == 0)
+						addTriangle(indices, idx[j], idx[j+1], idx[j+2]);
+					else
+						addTriangle(indices, idx[j+1], idx[j], idx[j+2]);
+				}
+				break;
+			case PRIMITIVE_TYPE_TRIANGLE_FAN:
+				for(unsigned int j = 1; j + 1 < cmd->numIndices; ++j)
+					addTriangle(indices, idx[0], idx[j], idx[j+1]);
+				break;
+		}
 	}
 
-	// disable texcoord array
-	if(lastTexCoords.isSet()) {
-		glTexCoordPointer(2, GL_FLOAT, 0, 0);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	// replace the commands with a single triangle list
+	for(unsigned int i = 0; i < m_commands.size(); i++)
+		delete m_commands[i];
+	m_commands.clear();
+
+	if(!indices.empty()) {
+		Command *cmd = new Command((unsigned int)indices.size());
+		cmd->type = PRIMITIVE_TYPE_TRIANGLES;
+		for(unsigned int i = 0; i < indices.size(); ++i)
+			cmd->indices[i] = indices[i];
+		m_commands.push_back(cmd);
 	}
+
+	createIndexBuffer();
+}
+
+void
+Mesh::render(GfxDriver *driver)
+{
+	ProfilerZone zone("Mesh::render");
+	driver->drawMesh(this);
+}
+
+void
+Mesh::renderInstanced(GfxDriver *driver, const Matrix4 *transforms, unsigned int numInstances)
+{
+	ProfilerZone zone("Mesh::renderInstanced");
+	driver->drawMeshInstanced(this, transforms, numInstances);
 }
 
 } // namespace DromeGfx
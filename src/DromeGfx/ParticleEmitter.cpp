@@ -23,94 +23,75 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <DromeCore/Util.h>
-#include <DromeGfx/OpenGL.h>
+#include <algorithm>
+#include <DromeCore/LinearAllocator.h>
+#include <DromeMath/Util.h>
 #include <DromeGfx/ParticleEmitter.h>
+#include "ParticleKernels.h"
 
 using namespace DromeCore;
 using namespace DromeMath;
 
 namespace DromeGfx {
 
-/*
- * Particle class
- */
-Particle::Particle()
-{
-	m_done = false;
-
-	m_rotation = 0.0f;
-	m_width = 1.0f;
-	m_height = 1.0f;
-}
-
-void
-Particle::render(GfxDriver *driver)
-{
-	// set modelview matrix for billboarding
-	glPushMatrix();
-	Matrix4 m = driver->getModelViewMatrix().translate(m_position);
-	m = m.removeTranslation().transpose() * m;
-	driver->setModelViewMatrix(m);
-	glRotatef(m_rotation, 0.0f, 0.0f, 1.0f);
-
-	float verts[] = {
-		-m_width, m_height, 0.0f,
-		-m_width, -m_height, 0.0f,
-		m_width, m_height, 0.0f,
-		m_width, -m_height, 0.0f
-	};
-
-	float texCoords[] = {
-		0.0f, 0.0f,
-		0.0f, 1.0f,
-		1.0f, 0.0f,
-		1.0f, 1.0f
-	};
+// rate of change of each particle property per second
+static const float ROTATION_SPEED = 30.0f;
+static const float SIZE_SPEED = -0.25f;
+static const float ALPHA_SPEED = -0.75f;
 
-	glColor4ub(m_color.r, m_color.g, m_color.b, m_color.a);
+// number of particles updated by each job; a multiple of the widest SIMD kernel's width
+static const unsigned int PARTICLE_GRAIN_SIZE = 4096;
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, 0, verts);
+static bool simdEnabled = true;
 
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	glTexCoordPointer(2, GL_FLOAT, 0, 0);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glVertexPointer(3, GL_FLOAT, 0, 0);
-	glDisableClientState(GL_VERTEX_ARRAY);
+static ParticleInstructionSet
+getInstructionSet()
+{
+	static ParticleInstructionSet bestInstructionSet = getBestParticleInstructionSet();
 
-	glPopMatrix();
+	return simdEnabled ? bestInstructionSet : PARTICLE_INSTRUCTION_SET_SCALAR;
 }
 
-void
-Particle::cycle(float secondsElapsed)
+// data shared by the jobs of one cycle
+class ParticleCycleJob
 {
-	m_position += m_velocity * secondsElapsed;
-	m_rotation += 30.0f * secondsElapsed;
-	m_width -= 0.25f * secondsElapsed;
-	m_height -= 0.25f * secondsElapsed;
-
-	float a = m_color.getFloatA() - (0.75f * secondsElapsed);
-	if(a < 0.0f)
-		m_done = true;
-	else
-		m_color.setA(a);
-}
-
-RefPtr <Particle>
-Particle::create()
+	public:
+		ParticleCycleFunction function;
+		ParticleArrays arrays;
+		float secondsElapsed;
+		float rotationDelta, sizeDelta, alphaDelta;
+
+		unsigned int *deadParticles;
+		unsigned int *numDeadInRange;
+};
+
+static void
+cycleParticleRange(void *data, unsigned int first, unsigned int end)
 {
-	return RefPtr <Particle> (new Particle());
+	const ParticleCycleJob *job = (const ParticleCycleJob *)data;
+
+	ParticleArrays arrays;
+	arrays.positionX = job->arrays.positionX + first;
+	arrays.positionY = job->arrays.positionY + first;
+	arrays.positionZ = job->arrays.positionZ + first;
+	arrays.velocityX = job->arrays.velocityX + first;
+	arrays.velocityY = job->arrays.velocityY + first;
+	arrays.velocityZ = job->arrays.velocityZ + first;
+	arrays.rotations = job->arrays.rotations + first;
+	arrays.sizes = job->arrays.sizes + first;
+	arrays.alphas = job->arrays.alphas + first;
+
+	// each range writes its dead indices to its own part of the array
+	unsigned int *deadParticles = job->deadParticles + first;
+	unsigned int numDead = job->function(arrays, end - first, job->secondsElapsed,
+	                                     job->rotationDelta, job->sizeDelta, job->alphaDelta,
+	                                     deadParticles);
+	for(unsigned int i = 0; i < numDead; ++i)
+		deadParticles[i] += first;
+
+	job->numDeadInRange[first / PARTICLE_GRAIN_SIZE] = numDead;
 }
 
-/*
- * ParticleEmitter class
- */
 ParticleEmitter::ParticleEmitter()
 {
 	m_width = 1.0f;
@@ -118,45 +99,159 @@ ParticleEmitter::ParticleEmitter()
 
 	m_particlesPerSecond = 1.0f;
 	m_timeRemainder = 0.0f;
+
+	// give each emitter a different sequence
+	m_random = Random::getThreadRandom().split();
 }
 
-RefPtr <Particle>
-ParticleEmitter::createParticle()
+void
+ParticleEmitter::reserve(unsigned int numParticles)
 {
-	RefPtr <Particle> p = Particle::create();
-
-	p->setPosition(m_position);
-	p->setWidth(m_width);
-	p->setHeight(m_height);
-	p->setColor(m_color);
-
-	// set random rotation
-	p->setRotation(randomFloat(0.0f, 360.0f));
-
-	// set random velocity
-	p->setVelocity(Vector3(randomFloat(), randomFloat(), randomFloat()).normalize());
+	m_positionX.reserve(numParticles);
+	m_positionY.reserve(numParticles);
+	m_positionZ.reserve(numParticles);
+	m_velocityX.reserve(numParticles);
+	m_velocityY.reserve(numParticles);
+	m_velocityZ.reserve(numParticles);
+	m_rotations.reserve(numParticles);
+	m_sizes.reserve(numParticles);
+	m_alphas.reserve(numParticles);
+	m_colors.reserve(numParticles);
+
+	m_texCoords.reserve(numParticles * 12);
+}
 
-	// set random size
-	p->setWidth(randomFloat(0.0f, 1.0f));
-	p->setHeight(p->getWidth());
+void
+ParticleEmitter::emitParticles(unsigned int numParticles)
+{
+	if(numParticles == 0)
+		return;
+
+	unsigned int first = getNumParticles();
+	unsigned int end = first + numParticles;
+
+	m_positionX.resize(end, m_position.x);
+	m_positionY.resize(end, m_position.y);
+	m_positionZ.resize(end, m_position.z);
+
+	// set random velocities
+	m_velocityX.resize(end);
+	m_velocityY.resize(end);
+	m_velocityZ.resize(end);
+	m_random.fillUnitVectors(&m_velocityX[first], &m_velocityY[first], &m_velocityZ[first], numParticles);
+
+	// set random rotations and sizes
+	m_rotations.resize(end);
+	m_sizes.resize(end);
+	m_random.fillFloats(&m_rotations[first], numParticles, 0.0f, 360.0f);
+	m_random.fillFloats(&m_sizes[first], numParticles, 0.0f, 1.0f);
+
+	m_alphas.resize(end, m_color.getFloatA());
+	m_colors.resize(end, m_color);
+}
 
-	return p;
+void
+ParticleEmitter::removeParticle(unsigned int index)
+{
+	// move the last particle into the removed particle's place
+	unsigned int last = getNumParticles() - 1;
+
+	m_positionX[index] = m_positionX[last];
+	m_positionY[index] = m_positionY[last];
+	m_positionZ[index] = m_positionZ[last];
+	m_velocityX[index] = m_velocityX[last];
+	m_velocityY[index] = m_velocityY[last];
+	m_velocityZ[index] = m_velocityZ[last];
+	m_rotations[index] = m_rotations[last];
+	m_sizes[index] = m_sizes[last];
+	m_alphas[index] = m_alphas[last];
+	m_colors[index] = m_colors[last];
+
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_positionZ.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_velocityZ.pop_back();
+	m_rotations.pop_back();
+	m_sizes.pop_back();
+	m_alphas.pop_back();
+	m_colors.pop_back();
 }
 
 void
 ParticleEmitter::render(GfxDriver *driver)
 {
+	unsigned int numParticles = getNumParticles();
+	if(numParticles == 0)
+		return;
+
+	// the texture coordinates are the same for every
+	// particle, so they only need to be set once
+	static const float quadTexCoords[12] = {
+		0.0f, 0.0f,  0.0f, 1.0f,  1.0f, 0.0f,
+		1.0f, 0.0f,  0.0f, 1.0f,  1.0f, 1.0f
+	};
+	unsigned int numTexCoordQuads = (unsigned int)m_texCoords.size() / 12;
+	if(numTexCoordQuads < numParticles) {
+		m_texCoords.resize(numParticles * 12);
+		for(unsigned int i = numTexCoordQuads; i < numParticles; ++i) {
+			for(unsigned int j = 0; j < 12; ++j)
+				m_texCoords[i * 12 + j] = quadTexCoords[j];
+		}
+	}
+
+	// the vertex arrays are only needed until they're drawn
+	LinearAllocator &frameAllocator = LinearAllocator::getFrameAllocator();
+	LinearAllocatorScope scope(frameAllocator);
+	Vector3 *vertexArray = frameAllocator.allocateArray <Vector3> (numParticles * 6);
+	Color *colorArray = frameAllocator.allocateArray <Color> (numParticles * 6);
+
+	// the rows of the modelview matrix are the
+	// viewer's right and up vectors in object space
+	const float *m = driver->getModelViewMatrix().getData();
+	Vector3 right(m[0], m[4], m[8]);
+	Vector3 up(m[1], m[5], m[9]);
+
+	for(unsigned int i = 0; i < numParticles; ++i) {
+		float rotation = degToRad(m_rotations[i]);
+		float c = cosf(rotation) * m_sizes[i];
+		float s = sinf(rotation) * m_sizes[i];
+
+		// the particle's rotated right and up vectors
+		Vector3 a(right.x * c + up.x * s, right.y * c + up.y * s, right.z * c + up.z * s);
+		Vector3 b(up.x * c - right.x * s, up.y * c - right.y * s, up.z * c - right.z * s);
+
+		Vector3 p(m_positionX[i], m_positionY[i], m_positionZ[i]);
+		Vector3 topLeft(p.x - a.x + b.x, p.y - a.y + b.y, p.z - a.z + b.z);
+		Vector3 bottomLeft(p.x - a.x - b.x, p.y - a.y - b.y, p.z - a.z - b.z);
+		Vector3 topRight(p.x + a.x + b.x, p.y + a.y + b.y, p.z + a.z + b.z);
+		Vector3 bottomRight(p.x + a.x - b.x, p.y + a.y - b.y, p.z + a.z - b.z);
+
+		Vector3 *vertices = &vertexArray[i * 6];
+		vertices[0] = topLeft;
+		vertices[1] = bottomLeft;
+		vertices[2] = topRight;
+		vertices[3] = topRight;
+		vertices[4] = bottomLeft;
+		vertices[5] = bottomRight;
+
+		Color color = m_colors[i];
+		color.a = (uint8_t)(m_alphas[i] * 255.0f);
+		Color *colors = &colorArray[i * 6];
+		for(unsigned int j = 0; j < 6; ++j)
+			colors[j] = color;
+	}
+
 	bool depthWritesEnabled = driver->getDepthWritesEnabled();
 	BlendMode blendMode = driver->getBlendMode();
 
 	driver->setDepthWritesEnabled(false);
 	driver->setBlendMode(BLEND_MODE_ADD);
 
-	// render each particle
-	glBindTexture(GL_TEXTURE_2D, m_texture->getId());
-	for(unsigned int i = 0; i < m_particles.size(); i++)
-		m_particles[i]->render(driver);
-	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	// render all particles at once
+	driver->bindTexture(m_texture);
+	driver->drawPrimitives(PRIMITIVE_TYPE_TRIANGLES, numParticles * 6, vertexArray, &m_texCoords[0], colorArray);
 
 	driver->setBlendMode(blendMode);
 	driver->setDepthWritesEnabled(depthWritesEnabled);
@@ -165,21 +260,60 @@ ParticleEmitter::render(GfxDriver *driver)
 void
 ParticleEmitter::cycle(float secondsElapsed)
 {
-	// cycle each particle
-	for(unsigned int i = 0; i < m_particles.size(); i++) {
-		m_particles[i]->cycle(secondsElapsed);
-		if(m_particles[i]->isDone()) {
-			m_particles.erase(m_particles.begin() + i);
-			i--;
+	unsigned int numParticles = getNumParticles();
+	if(numParticles != 0) {
+		unsigned int numRanges = (numParticles + PARTICLE_GRAIN_SIZE - 1) / PARTICLE_GRAIN_SIZE;
+		m_deadParticles.resize(numParticles);
+		m_numDeadInRange.resize(numRanges);
+
+		ParticleCycleJob job;
+		job.function = getParticleCycleFunction(getInstructionSet());
+		job.arrays.positionX = &m_positionX[0];
+		job.arrays.positionY = &m_positionY[0];
+		job.arrays.positionZ = &m_positionZ[0];
+		job.arrays.velocityX = &m_velocityX[0];
+		job.arrays.velocityY = &m_velocityY[0];
+		job.arrays.velocityZ = &m_velocityZ[0];
+		job.arrays.rotations = &m_rotations[0];
+		job.arrays.sizes = &m_sizes[0];
+		job.arrays.alphas = &m_alphas[0];
+		job.secondsElapsed = secondsElapsed;
+		job.rotationDelta = ROTATION_SPEED * secondsElapsed;
+		job.sizeDelta = SIZE_SPEED * secondsElapsed;
+		job.alphaDelta = ALPHA_SPEED * secondsElapsed;
+		job.deadParticles = &m_deadParticles[0];
+		job.numDeadInRange = &m_numDeadInRange[0];
+
+		// cycle each range of particles
+		if(m_jobSystem.isNull()) {
+			for(unsigned int first = 0; first < numParticles; first += PARTICLE_GRAIN_SIZE)
+				cycleParticleRange(&job, first, std::min(first + PARTICLE_GRAIN_SIZE, numParticles));
+		} else {
+			m_jobSystem->parallelFor(numParticles, PARTICLE_GRAIN_SIZE, cycleParticleRange, &job);
 		}
+
+		// gather the dead particles of each range in ascending order
+		unsigned int numDead = m_numDeadInRange[0];
+		for(unsigned int i = 1; i < numRanges; ++i) {
+			const unsigned int *deadInRange = &m_deadParticles[i * PARTICLE_GRAIN_SIZE];
+			for(unsigned int j = 0; j < m_numDeadInRange[i]; ++j)
+				m_deadParticles[numDead++] = deadInRange[j];
+		}
+
+		// remove particles that have faded out, starting with the last
+		// so that the particles moved into their places are still alive
+		for(unsigned int i = numDead; i > 0; --i)
+			removeParticle(m_deadParticles[i - 1]);
 	}
-	
+
 	// create new particles if necessary
-	for(secondsElapsed += m_timeRemainder; secondsElapsed > 0.0f; secondsElapsed -= 1.0f / m_particlesPerSecond) {
-		// create particle
-		m_particles.insert(m_particles.end(), createParticle());
-	}
+	if(m_particlesPerSecond <= 0.0f)
+		return;
+	unsigned int numNewParticles = 0;
+	for(secondsElapsed += m_timeRemainder; secondsElapsed > 0.0f; secondsElapsed -= 1.0f / m_particlesPerSecond)
+		++numNewParticles;
 	m_timeRemainder = secondsElapsed;
+	emitParticles(numNewParticles);
 }
 
 RefPtr <ParticleEmitter>
@@ -188,4 +322,24 @@ ParticleEmitter::create()
 	return RefPtr <ParticleEmitter> (new ParticleEmitter());
 }
 
+void
+ParticleEmitter::setSimdEnabled(bool value)
+{
+	simdEnabled = value;
+}
+
+const char *
+ParticleEmitter::getInstructionSetName()
+{
+	switch(getInstructionSet()) {
+		default:
+		case PARTICLE_INSTRUCTION_SET_SCALAR:
+			return "scalar";
+		case PARTICLE_INSTRUCTION_SET_SSE:
+			return "SSE";
+		case PARTICLE_INSTRUCTION_SET_AVX:
+			return "AVX";
+	}
+}
+
 } // namespace DromeGfx
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ParticleKernels.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+// AVX code is compiled for the functions that use it and is only
+// called if the CPU supports it, so the rest of the library doesn't
+// need to be compiled for AVX
+#define PARTICLE_KERNELS_AVX
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace DromeGfx {
+
+static unsigned int
+cycleRange(const ParticleArrays &arrays, unsigned int first, unsigned int end,
+           float secondsElapsed, float rotationDelta, float sizeDelta, float alphaDelta,
+           unsigned int *deadIndices)
+{
+	unsigned int numDead = 0;
+
+	for(unsigned int i = first; i < end; ++i) {
+		arrays.positionX[i] += arrays.velocityX[i] * secondsElapsed;
+		arrays.positionY[i] += arrays.velocityY[i] * secondsElapsed;
+		arrays.positionZ[i] += arrays.velocityZ[i] * secondsElapsed;
+		arrays.rotations[i] += rotationDelta;
+		arrays.sizes[i] += sizeDelta;
+		arrays.alphas[i] += alphaDelta;
+
+		if(arrays.alphas[i] < 0.0f)
+			deadIndices[numDead++] = i;
+	}
+
+	return numDead;
+}
+
+static unsigned int
+cycleScalar(const ParticleArrays &arrays, unsigned int numParticles,
+            float secondsElapsed, float rotationDelta, float sizeDelta, float alphaDelta,
+            unsigned int *deadIndices)
+{
+	return cycleRange(arrays, 0, numParticles, secondsElapsed, rotationDelta, sizeDelta, alphaDelta, deadIndices);
+}
+
+#ifdef __SSE__
+static unsigned int
+cycleSSE(const ParticleArrays &arrays, unsigned int numParticles,
+         float secondsElapsed, float rotationDelta, float sizeDelta, float alphaDelta,
+         unsigned int *deadIndices)
+{
+	const __m128 time = _mm_set1_ps(secondsElapsed);
+	const __m128 rotation = _mm_set1_ps(rotationDelta);
+	const __m128 size = _mm_set1_ps(sizeDelta);
+	const __m128 alpha = _mm_set1_ps(alphaDelta);
+	const __m128 zero = _mm_setzero_ps();
+	unsigned int numDead = 0;
+	unsigned int i = 0;
+
+	// update four particles at a time
+	for(; i + 4 <= numParticles; i += 4) {
+		__m128 x = _mm_loadu_ps(arrays.positionX + i);
+		__m128 y = _mm_loadu_ps(arrays.positionY + i);
+		__m128 z = _mm_loadu_ps(arrays.positionZ + i);
+		x = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(arrays.velocityX + i), time));
+		y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(arrays.velocityY + i), time));
+		z = _mm_add_ps(z, _mm_mul_ps(_mm_loadu_ps(arrays.velocityZ + i), time));
+		_mm_storeu_ps(arrays.positionX + i, x);
+		_mm_storeu_ps(arrays.positionY + i, y);
+		_mm_storeu_ps(arrays.positionZ + i, z);
+
+		_mm_storeu_ps(arrays.rotations + i, _mm_add_ps(_mm_loadu_ps(arrays.rotations + i), rotation));
+		_mm_storeu_ps(arrays.sizes + i, _mm_add_ps(_mm_loadu_ps(arrays.sizes + i), size));
+
+		__m128 a = _mm_add_ps(_mm_loadu_ps(arrays.alphas + i), alpha);
+		_mm_storeu_ps(arrays.alphas + i, a);
+
+		// record the particles that have faded out
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(a, zero));
+		if(mask != 0) {
+			for(unsigned int j = 0; j < 4; ++j) {
+				if(mask & (1 << j))
+					deadIndices[numDead++] = i + j;
+			}
+		}
+	}
+
+	return numDead + cycleRange(arrays, i, numParticles, secondsElapsed, rotationDelta, sizeDelta, alphaDelta, deadIndices + numDead);
+}
+#endif
+
+#ifdef PARTICLE_KERNELS_AVX
+__attribute__((target("avx"))) static unsigned int
+cycleAVX(const ParticleArrays &arrays, unsigned int numParticles,
+         float secondsElapsed, float rotationDelta, float sizeDelta, float alphaDelta,
+         unsigned int *deadIndices)
+{
+	const __m256 time = _mm256_set1_ps(secondsElapsed);
+	const __m256 rotation = _mm256_set1_ps(rotationDelta);
+	const __m256 size = _mm256_set1_ps(sizeDelta);
+	const __m256 alpha = _mm256_set1_ps(alphaDelta);
+	const __m256 zero = _mm256_setzero_ps();
+	unsigned int numDead = 0;
+	unsigned int i = 0;
+
+	// update eight particles at a time
+	for(; i + 8 <= numParticles; i += 8) {
+		__m256 x = _mm256_loadu_ps(arrays.positionX + i);
+		__m256 y = _mm256_loadu_ps(arrays.positionY + i);
+		__m256 z = _mm256_loadu_ps(arrays.positionZ + i);
+		x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(arrays.velocityX + i), time));
+		y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(arrays.velocityY + i), time));
+		z = _mm256_add_ps(z, _mm256_mul_ps(_mm256_loadu_ps(arrays.velocityZ + i), time));
+		_mm256_storeu_ps(arrays.positionX + i, x);
+		_mm256_storeu_ps(arrays.positionY + i, y);
+		_mm256_storeu_ps(arrays.positionZ + i, z);
+
+		_mm256_storeu_ps(arrays.rotations + i, _mm256_add_ps(_mm256_loadu_ps(arrays.rotations + i), rotation));
+		_mm256_storeu_ps(arrays.sizes + i, _mm256_add_ps(_mm256_loadu_ps(arrays.sizes + i), size));
+
+		__m256 a = _mm256_add_ps(_mm256_loadu_ps(arrays.alphas + i), alpha);
+		_mm256_storeu_ps(arrays.alphas + i, a);
+
+		// record the particles that have faded out
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(a, zero, _CMP_LT_OQ));
+		if(mask != 0) {
+			for(unsigned int j = 0; j < 8; ++j) {
+				if(mask & (1 << j))
+					deadIndices[numDead++] = i + j;
+			}
+		}
+	}
+
+	return numDead + cycleRange(arrays, i, numParticles, secondsElapsed, rotationDelta, sizeDelta, alphaDelta, deadIndices + numDead);
+}
+#endif
+
+ParticleInstructionSet
+getBestParticleInstructionSet()
+{
+#ifdef PARTICLE_KERNELS_AVX
+	if(__builtin_cpu_supports("avx"))
+		return PARTICLE_INSTRUCTION_SET_AVX;
+#endif
+#ifdef __SSE__
+	return PARTICLE_INSTRUCTION_SET_SSE;
+#else
+	return PARTICLE_INSTRUCTION_SET_SCALAR;
+#endif
+}
+
+ParticleCycleFunction
+getParticleCycleFunction(ParticleInstructionSet instructionSet)
+{
+	switch(instructionSet) {
+		default:
+		case PARTICLE_INSTRUCTION_SET_SCALAR:
+			return cycleScalar;
+#ifdef __SSE__
+		case PARTICLE_INSTRUCTION_SET_SSE:
+			return cycleSSE;
+#endif
+#ifdef PARTICLE_KERNELS_AVX
+		case PARTICLE_INSTRUCTION_SET_AVX:
+			return cycleAVX;
+#endif
+	}
+}
+
+} // namespace DromeGfx
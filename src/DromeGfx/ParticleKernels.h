@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEGFX_PARTICLEKERNELS_H__
+#define __DROMEGFX_PARTICLEKERNELS_H__
+
+namespace DromeGfx {
+
+/**
+ * Pointers to the property arrays of a ParticleEmitter's particles.
+ */
+class ParticleArrays
+{
+	public:
+		float *positionX, *positionY, *positionZ;
+		float *velocityX, *velocityY, *velocityZ;
+		float *rotations;
+		float *sizes;
+		float *alphas;
+};
+
+/**
+ * Moves each particle by its velocity and adds the given deltas to its rotation, size and alpha.
+ *
+ * @return The number of particles whose alpha fell below zero. Their indices are written to deadIndices in increasing order.
+ */
+typedef unsigned int (*ParticleCycleFunction)(const ParticleArrays &arrays, unsigned int numParticles, float secondsElapsed, float rotationDelta, float sizeDelta, float alphaDelta, unsigned int *deadIndices);
+
+enum ParticleInstructionSet
+{
+	PARTICLE_INSTRUCTION_SET_SCALAR = 0,
+	PARTICLE_INSTRUCTION_SET_SSE,
+	PARTICLE_INSTRUCTION_SET_AVX
+};
+
+/**
+ * @return The widest instruction set supported by both the compiler and the CPU.
+ */
+ParticleInstructionSet getBestParticleInstructionSet();
+
+/**
+ * @param instructionSet The instruction set to get a function for. It must be supported.
+ * @return The particle cycle function using the given instruction set.
+ */
+ParticleCycleFunction getParticleCycleFunction(ParticleInstructionSet instructionSet);
+
+} // namespace DromeGfx
+
+#endif /* __DROMEGFX_PARTICLEKERNELS_H__ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <DromeGfx/RenderQueue.h>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeMath;
+
+namespace DromeGfx {
+
+/*
+ * RenderItem
+ */
+RenderItem::RenderItem()
+{
+	depth = 0.0f;
+	translucent = false;
+}
+
+/*
+ * RenderQueue
+ */
+RenderQueue::RenderQueue()
+{
+	m_sorted = true;
+
+	// use the depth range of GfxDriver::setProjectionMatrix(int, int)
+	m_minDepth = 0.1f;
+	m_maxDepth = 2000.0f;
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void
+RenderQueue::setDepthRange(float minDepth, float maxDepth)
+{
+	m_minDepth = minDepth;
+	m_maxDepth = maxDepth;
+}
+
+static uint64_t
+getObjectId(map <const void *, uint32_t> &ids, const void *object, uint32_t maxId)
+{
+	map <const void *, uint32_t>::iterator it = ids.find(object);
+	if(it != ids.end())
+		return it->second;
+
+	// objects that don't fit in the key share the largest id
+	uint32_t id = (uint32_t)ids.size();
+	if(id > maxId)
+		id = maxId;
+
+	ids[object] = id;
+	return id;
+}
+
+static uint64_t
+quantizeDepth(float depth, float minDepth, float maxDepth, unsigned int bits)
+{
+	float t = (depth - minDepth) / (maxDepth - minDepth);
+	if(!(t > 0.0f))
+		t = 0.0f;
+	else if(t > 1.0f)
+		t = 1.0f;
+
+	uint64_t maxValue = ((uint64_t)1 << bits) - 1;
+	return (uint64_t)(t * (float)maxValue);
+}
+
+uint64_t
+RenderQueue::makeKey(const RenderItem &item)
+{
+	// ids are assigned in order of first appearance, so
+	// framebuffers are drawn in the order they're used
+	uint64_t framebuffer = getObjectId(m_framebufferIds, item.framebuffer.get(), 0xff);
+	uint64_t program = getObjectId(m_shaderProgramIds, item.shaderProgram.get(), 0xffff);
+	uint64_t texture = getObjectId(m_textureIds, item.textures[0].get(), 0xffff);
+
+	uint64_t key = framebuffer << 56;
+
+	if(!item.translucent) {
+		// framebuffer:8 | 0:1 | program:16 | texture:16 | depth:23
+		key |= program << 39;
+		key |= texture << 23;
+		key |= quantizeDepth(item.depth, m_minDepth, m_maxDepth, 23);
+	} else {
+		// framebuffer:8 | 1:1 | inverted depth:24 | program:16 | texture:15
+		uint64_t depth = quantizeDepth(item.depth, m_minDepth, m_maxDepth, 24);
+		key |= (uint64_t)1 << 55;
+		key |= (0xffffff - depth) << 31;
+		key |= program << 15;
+
+		// translucent items share the ids of opaque ones, so
+		// clamp to the largest id that fits in the shorter field
+		key |= (texture < 0x7fff) ? texture : 0x7fff;
+	}
+
+	return key;
+}
+
+void
+RenderQueue::add(const RenderItem &item)
+{
+	m_keys.push_back(makeKey(item));
+	m_order.push_back((uint32_t)m_items.size());
+	m_items.push_back(item);
+	m_sorted = false;
+}
+
+void
+RenderQueue::sort()
+{
+	if(m_sorted)
+		return;
+
+	size_t n = m_keys.size();
+	m_keysScratch.resize(n);
+	m_orderScratch.resize(n);
+
+	// least significant digit radix sort, eight bits per pass
+	for(unsigned int shift = 0; shift < 64; shift += 8) {
+		size_t counts[256] = { 0 };
+		for(size_t i = 0; i < n; ++i)
+			++counts[(m_keys[i] >> shift) & 0xff];
+
+		// skip passes where every key has the same digit
+		if(counts[(m_keys[0] >> shift) & 0xff] == n)
+			continue;
+
+		size_t offsets[256];
+		size_t offset = 0;
+		for(unsigned int i = 0; i < 256; ++i) {
+			offsets[i] = offset;
+			offset += counts[i];
+		}
+
+		for(size_t i = 0; i < n; ++i) {
+			size_t dest = offsets[(m_keys[i] >> shift) & 0xff]++;
+			m_keysScratch[dest] = m_keys[i];
+			m_orderScratch[dest] = m_order[i];
+		}
+
+		m_keys.swap(m_keysScratch);
+		m_order.swap(m_orderScratch);
+	}
+
+	m_sorted = true;
+}
+
+void
+RenderQueue::execute(GfxDriver *driver, const Matrix4 &view)
+{
+	sort();
+
+	bool depthWritesEnabled = driver->getDepthWritesEnabled();
+
+	// the driver elides state changes that don't change
+	// anything, so every item can simply set all of its state
+	for(size_t i = 0; i < m_order.size(); ++i) {
+		const RenderItem &item = m_items[m_order[i]];
+
+		driver->bindFramebuffer(item.framebuffer);
+		driver->bindShaderProgram(item.shaderProgram);
+		for(unsigned int j = 0; j < RenderItem::MAX_TEXTURES; ++j)
+			driver->bindTexture(j, item.textures[j]);
+		driver->setDepthWritesEnabled(depthWritesEnabled && !item.translucent);
+
+		driver->setModelViewMatrix(view * item.transform);
+		item.mesh.get()->render(driver);
+	}
+
+	driver->setDepthWritesEnabled(depthWritesEnabled);
+}
+
+void
+RenderQueue::clear()
+{
+	m_items.clear();
+	m_keys.clear();
+	m_order.clear();
+	m_sorted = true;
+
+	m_framebufferIds.clear();
+	m_shaderProgramIds.clear();
+	m_textureIds.clear();
+}
+
+RefPtr <RenderQueue>
+RenderQueue::create()
+{
+	return RefPtr <RenderQueue> (new RenderQueue());
+}
+
+} // namespace DromeGfx
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <DromeCore/Exception.h>
+#include <DromeCore/LinearAllocator.h>
+#include <DromeGfx/SceneGraph.h>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeMath;
+
+namespace DromeGfx {
+
+/*
+ * Finds the bounds in world space of a box in local space, by transforming
+ * its center and finding the extents of the transformed box from the
+ * absolute values of the upper 3x3 of the matrix
+ */
+static void
+transformBounds(const Matrix4 &m, const Vector3 &min, const Vector3 &max, Vector3 &worldMin, Vector3 &worldMax)
+{
+	Vector3 center = m * ((min + max) * 0.5f);
+	Vector3 extents = (max - min) * 0.5f;
+	Vector3 worldExtents(fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y + fabsf(m[8]) * extents.z,
+	                     fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y + fabsf(m[9]) * extents.z,
+	                     fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y + fabsf(m[10]) * extents.z);
+
+	worldMin = center - worldExtents;
+	worldMax = center + worldExtents;
+}
+
+static void
+mergeBounds(Vector3 &min, Vector3 &max, const Vector3 &otherMin, const Vector3 &otherMax)
+{
+	min.x = std::min(min.x, otherMin.x);
+	min.y = std::min(min.y, otherMin.y);
+	min.z = std::min(min.z, otherMin.z);
+	max.x = std::max(max.x, otherMax.x);
+	max.y = std::max(max.y, otherMax.y);
+	max.z = std::max(max.z, otherMax.z);
+}
+
+const unsigned int SceneGraph::INVALID_INDEX;
+
+SceneGraph::SceneGraph()
+{
+	m_isSorted = true;
+	m_isDirty = false;
+	m_numUpdatedNodes = 0;
+}
+
+SceneGraph::~SceneGraph()
+{
+}
+
+/*
+ * Marks the subtree bounds of a node and its ancestors as needing to be
+ * recalculated. The ancestors of a marked node are always marked too, so
+ * this can stop at the first node that's already marked.
+ */
+void
+SceneGraph::markBoundsDirty(unsigned int index)
+{
+	while(index != INVALID_INDEX && !m_nodes[index].isBoundsDirty) {
+		m_nodes[index].isBoundsDirty = true;
+		index = m_nodes[index].parent;
+	}
+
+	m_isDirty = true;
+}
+
+/*
+ * Sorts the nodes by depth after setParent() or addNode() broke the order
+ */
+void
+SceneGraph::sortNodes()
+{
+	unsigned int numNodes = (unsigned int)m_nodes.size();
+
+	// calculate the depth of each node; parents can come after their children,
+	// so follow each node's parents up to the first one with a known depth
+	vector <unsigned int> depths(numNodes, INVALID_INDEX);
+	unsigned int maxDepth = 0;
+	for(unsigned int i = 0; i < numNodes; ++i) {
+		unsigned int steps = 0;
+		unsigned int j = i;
+		for(; j != INVALID_INDEX && depths[j] == INVALID_INDEX; j = m_nodes[j].parent)
+			++steps;
+
+		unsigned int depth = (j == INVALID_INDEX) ? steps - 1 : depths[j] + steps;
+		for(j = i; j != INVALID_INDEX && depths[j] == INVALID_INDEX; j = m_nodes[j].parent)
+			depths[j] = depth--;
+
+		maxDepth = std::max(maxDepth, depths[i]);
+	}
+
+	// counting sort, which keeps the order of nodes at the same depth
+	vector <unsigned int> offsets(maxDepth + 2, 0);
+	for(unsigned int i = 0; i < numNodes; ++i)
+		++offsets[depths[i] + 1];
+	for(unsigned int i = 1; i < offsets.size(); ++i)
+		offsets[i] += offsets[i - 1];
+
+	vector <unsigned int> newIndices(numNodes);
+	for(unsigned int i = 0; i < numNodes; ++i)
+		newIndices[i] = offsets[depths[i]]++;
+
+	vector <SceneGraphNode> nodes(numNodes);
+	for(unsigned int i = 0; i < numNodes; ++i) {
+		SceneGraphNode &node = nodes[newIndices[i]];
+		node = m_nodes[i];
+		node.depth = depths[i];
+		if(node.parent != INVALID_INDEX)
+			node.parent = newIndices[node.parent];
+		m_indices[node.id] = newIndices[i];
+	}
+
+	m_nodes.swap(nodes);
+	m_isSorted = true;
+}
+
+unsigned int
+SceneGraph::addNode(const Transform &transform, unsigned int parent)
+{
+	SceneGraphNode node;
+	node.id = (unsigned int)m_indices.size();
+	node.parent = (parent != INVALID_INDEX) ? m_indices[parent] : INVALID_INDEX;
+	node.depth = (parent != INVALID_INDEX) ? m_nodes[node.parent].depth + 1 : 0;
+	node.transform = transform;
+	node.hasBounds = false;
+	node.hasSubtreeBounds = false;
+	node.isDirty = true;
+	node.isBoundsDirty = false;
+
+	// nodes can be appended without sorting as long as they're at least as deep as the last node
+	if(!m_nodes.empty() && node.depth < m_nodes.back().depth)
+		m_isSorted = false;
+
+	m_indices.push_back((unsigned int)m_nodes.size());
+	m_nodes.push_back(node);
+	markBoundsDirty(m_indices.back());
+
+	return node.id;
+}
+
+unsigned int
+SceneGraph::getParent(unsigned int node) const
+{
+	unsigned int parent = m_nodes[m_indices[node]].parent;
+	return (parent != INVALID_INDEX) ? m_nodes[parent].id : INVALID_INDEX;
+}
+
+void
+SceneGraph::setParent(unsigned int node, unsigned int parent)
+{
+	unsigned int index = m_indices[node];
+	unsigned int parentIndex = (parent != INVALID_INDEX) ? m_indices[parent] : INVALID_INDEX;
+
+	for(unsigned int i = parentIndex; i != INVALID_INDEX; i = m_nodes[i].parent) {
+		if(i == index)
+			throw Exception("SceneGraph::setParent(): A node can't be moved under itself or one of its descendants");
+	}
+
+	// the old parent's bounds lose the node, and the new parent's gain it
+	if(m_nodes[index].parent != INVALID_INDEX)
+		markBoundsDirty(m_nodes[index].parent);
+
+	// the node may already be marked, while its new ancestors aren't
+	m_nodes[index].parent = parentIndex;
+	m_nodes[index].isDirty = true;
+	m_nodes[index].isBoundsDirty = false;
+	markBoundsDirty(index);
+
+	// the depths of the node and its descendants may have changed
+	m_isSorted = false;
+}
+
+void
+SceneGraph::setTransform(unsigned int node, const Transform &transform)
+{
+	unsigned int index = m_indices[node];
+
+	m_nodes[index].transform = transform;
+	m_nodes[index].isDirty = true;
+	markBoundsDirty(index);
+}
+
+void
+SceneGraph::setBounds(unsigned int node, const Vector3 &min, const Vector3 &max)
+{
+	unsigned int index = m_indices[node];
+
+	m_nodes[index].min = min;
+	m_nodes[index].max = max;
+	m_nodes[index].hasBounds = true;
+	m_nodes[index].isDirty = true;
+	markBoundsDirty(index);
+}
+
+void
+SceneGraph::clearBounds(unsigned int node)
+{
+	unsigned int index = m_indices[node];
+
+	m_nodes[index].hasBounds = false;
+	markBoundsDirty(index);
+}
+
+bool
+SceneGraph::getWorldBounds(unsigned int node, Vector3 &min, Vector3 &max) const
+{
+	const SceneGraphNode &n = m_nodes[m_indices[node]];
+
+	min = n.subtreeMin;
+	max = n.subtreeMax;
+	return n.hasSubtreeBounds;
+}
+
+void
+SceneGraph::update()
+{
+	if(!m_isSorted)
+		sortNodes();
+
+	m_numUpdatedNodes = 0;
+	if(!m_isDirty)
+		return;
+
+	// recalculate world matrices, parents first; a node whose parent was
+	// recalculated is recalculated too, and its subtree bounds are reset
+	// to its own bounds for its children to be merged into
+	unsigned int numNodes = (unsigned int)m_nodes.size();
+	for(unsigned int i = 0; i < numNodes; ++i) {
+		SceneGraphNode &node = m_nodes[i];
+
+		if(node.parent != INVALID_INDEX && m_nodes[node.parent].isDirty)
+			node.isDirty = true;
+
+		if(node.isDirty) {
+			if(node.parent != INVALID_INDEX)
+				node.worldMatrix = m_nodes[node.parent].worldMatrix * node.transform.getMatrix();
+			else
+				node.worldMatrix = node.transform.getMatrix();
+
+			if(node.hasBounds)
+				transformBounds(node.worldMatrix, node.min, node.max, node.worldMin, node.worldMax);
+
+			node.isBoundsDirty = true;
+			++m_numUpdatedNodes;
+		}
+
+		if(node.isBoundsDirty) {
+			node.subtreeMin = node.worldMin;
+			node.subtreeMax = node.worldMax;
+			node.hasSubtreeBounds = node.hasBounds;
+		}
+	}
+
+	// merge the subtree bounds of each node into its parent's, children first
+	for(unsigned int i = numNodes; i-- > 0;) {
+		SceneGraphNode &node = m_nodes[i];
+
+		if(node.parent != INVALID_INDEX && node.hasSubtreeBounds) {
+			SceneGraphNode &parent = m_nodes[node.parent];
+			if(parent.isBoundsDirty) {
+				if(parent.hasSubtreeBounds) {
+					mergeBounds(parent.subtreeMin, parent.subtreeMax, node.subtreeMin, node.subtreeMax);
+				} else {
+					parent.subtreeMin = node.subtreeMin;
+					parent.subtreeMax = node.subtreeMax;
+					parent.hasSubtreeBounds = true;
+				}
+			}
+		}
+
+		node.isDirty = false;
+		node.isBoundsDirty = false;
+	}
+
+	m_isDirty = false;
+}
+
+void
+SceneGraph::query(const Frustum &frustum, vector <unsigned int> &results) const
+{
+	unsigned int numNodes = (unsigned int)m_nodes.size();
+
+	LinearAllocator &frameAllocator = LinearAllocator::getFrameAllocator();
+	LinearAllocatorScope scope(frameAllocator);
+	bool *isVisible = frameAllocator.allocateArray <bool> (numNodes);
+
+	// parents come before their children, so the descendants
+	// of a node outside the frustum are skipped without a test
+	for(unsigned int i = 0; i < numNodes; ++i) {
+		const SceneGraphNode &node = m_nodes[i];
+
+		if((node.parent != INVALID_INDEX && !isVisible[node.parent]) || !node.hasSubtreeBounds) {
+			isVisible[i] = false;
+			continue;
+		}
+
+		isVisible[i] = frustum.intersectsBox((node.subtreeMin + node.subtreeMax) * 0.5f, (node.subtreeMax - node.subtreeMin) * 0.5f);
+		if(isVisible[i] && node.hasBounds &&
+		   frustum.intersectsBox((node.worldMin + node.worldMax) * 0.5f, (node.worldMax - node.worldMin) * 0.5f))
+			results.push_back(node.id);
+	}
+}
+
+RefPtr <SceneGraph>
+SceneGraph::create()
+{
+	return RefPtr <SceneGraph> (new SceneGraph());
+}
+
+} // namespace DromeGfx
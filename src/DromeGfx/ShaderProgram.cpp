@@ -27,6 +27,8 @@
 #include <cstring>
 #include <DromeCore/Exception.h>
 #include <DromeCore/File.h>
+#include <DromeCore/Profiler.h>
+#include <DromeGfx/Driver.h>
 #include <DromeGfx/OpenGL.h>
 #include <DromeGfx/ShaderProgram.h>
 
@@ -39,6 +41,8 @@ namespace DromeGfx {
 static string
 loadShaderFromFile(const char *filename)
 {
+	ProfilerZone zone("loadShaderFromFile");
+
 	string source;
 	char tmp[512];
 	size_t length;
@@ -62,12 +66,15 @@ loadShaderFromFile(const char *filename)
 
 ShaderProgram::ShaderProgram()
 {
-	m_id = glCreateProgram();
+	// without OpenGL, shaders and uniforms are ignored
+	m_id = GfxDriver::isGLEnabled() ? glCreateProgram() : 0;
+	m_instanceMatrixLocation = -1;
 }
 
 ShaderProgram::~ShaderProgram()
 {
-	glDeleteProgram(m_id);
+	if(m_id != 0)
+		glDeleteProgram(m_id);
 }
 
 unsigned int
@@ -124,6 +131,9 @@ ShaderProgram::attachGeometryShader(PrimitiveType inputPrimitiveType,
                                     int maxOutputVertices,
                                     const char *shader)
 {
+	if(m_id == 0)
+		return;
+
 	attachShader(m_id, GL_GEOMETRY_SHADER_ARB, shader);
 
 	// set input/output primitive types
@@ -147,6 +157,9 @@ ShaderProgram::attachGeometryShaderFromFile(PrimitiveType inputPrimitiveType,
 void
 ShaderProgram::attachVertexShader(const char *shader)
 {
+	if(m_id == 0)
+		return;
+
 	attachShader(m_id, GL_VERTEX_SHADER_ARB, shader);
 }
 
@@ -160,6 +173,9 @@ ShaderProgram::attachVertexShaderFromFile(const char *shaderPath)
 void
 ShaderProgram::attachFragmentShader(const char *shader)
 {
+	if(m_id == 0)
+		return;
+
 	attachShader(m_id, GL_FRAGMENT_SHADER_ARB, shader);
 }
 
@@ -173,6 +189,9 @@ ShaderProgram::attachFragmentShaderFromFile(const char *shaderPath)
 void
 ShaderProgram::linkShaders()
 {
+	if(m_id == 0)
+		return;
+
 	// link the program
 	glLinkProgram(m_id);
 
@@ -190,11 +209,17 @@ ShaderProgram::linkShaders()
 		throw Exception(string("ShaderProgram::linkShaders(): Program linking failed: ") + log);
 		delete [] log;
 	}
+
+	// look up the instancing attribute once instead of on every instanced draw
+	m_instanceMatrixLocation = glGetAttribLocation(m_id, "instanceMatrix");
 }
 
 int
 ShaderProgram::getUniformVariableLocation(const char *name) const
 {
+	if(m_id == 0)
+		return -1;
+
 	int location = glGetUniformLocation(m_id, name);
 	if(location == -1)
 		throw Exception(string("ShaderProgram::getUniformVariableLocation(): Uniform variable '") + name + "' does not exist");
@@ -202,9 +227,21 @@ ShaderProgram::getUniformVariableLocation(const char *name) const
 	return location;
 }
 
+int
+ShaderProgram::getAttributeLocation(const char *name) const
+{
+	if(m_id == 0)
+		return -1;
+
+	return glGetAttribLocation(m_id, name);
+}
+
 void
 ShaderProgram::setUniform(const char *name, int value)
 {
+	if(m_id == 0)
+		return;
+
 	glUniform1iARB(getUniformVariableLocation(name), value);
 }
 
@@ -212,6 +249,9 @@ void
 ShaderProgram::setUniform(const char *name, const Vector3 *values,
                           int numValues)
 {
+	if(m_id == 0)
+		return;
+
 	glUniform3fvARB(getUniformVariableLocation(name), numValues, (float *)values);
 }
 
@@ -225,6 +265,9 @@ void
 ShaderProgram::setUniform(const char *name, const Matrix4 *values,
                           int numValues)
 {
+	if(m_id == 0)
+		return;
+
 	glUniformMatrix4fvARB(getUniformVariableLocation(name), numValues, GL_FALSE, (float *)values);
 }
 
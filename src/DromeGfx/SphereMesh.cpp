@@ -38,9 +38,7 @@ SphereMesh::SphereMesh(unsigned int divisions, const Vector3 &scale)
 	if(divisions < 1)
 		throw Exception("SphereMesh::SphereMesh(): Invalid number of divisions (%u)");
 
-	vector<Vector3> verts;
-	vector<float> texCoords;
-	vector<Vector3> tangentSpace;
+	vector<MeshVertex> verts;
 
 	unsigned int vertsPerSlice = divisions + 1;
 
@@ -53,14 +51,16 @@ SphereMesh::SphereMesh(unsigned int divisions, const Vector3 &scale)
 		for(unsigned int j = 0; j < vertsPerSlice; ++j) {
 			r = ((M_PI * 2.0f) / (float)divisions) * (float)j;
 
-			verts.push_back(Vector3(cosf(r) * s, sinf(r) * s, c) * scale);
+			MeshVertex v;
+			v.position = Vector3(cosf(r) * s, sinf(r) * s, c) * scale;
 
-			texCoords.push_back((float)j / (float)divisions);
-			texCoords.push_back((float)i / (float)(divisions / 2));
+			v.s = (float)j / (float)divisions;
+			v.t = (float)i / (float)(divisions / 2);
 
-			tangentSpace.push_back(Vector3(cosf(r + M_PI/2.0f) * s, sinf(r + M_PI/2.0f) * s, c).normalize());
-			tangentSpace.push_back(Vector3(cosf(r) * sinf(r + M_PI/2.0f), sinf(r) * sinf(r + M_PI/2.0f), cosf(r + M_PI/2.0f)).normalize());
-			tangentSpace.push_back(Vector3(cosf(r) * s, sinf(r) * s, c).normalize());
+			v.tangent = Vector3(cosf(r + M_PI/2.0f) * s, sinf(r + M_PI/2.0f) * s, c).normalize();
+			v.binormal = Vector3(cosf(r) * sinf(r + M_PI/2.0f), sinf(r) * sinf(r + M_PI/2.0f), cosf(r + M_PI/2.0f)).normalize();
+			v.normal = Vector3(cosf(r) * s, sinf(r) * s, c).normalize();
+			verts.push_back(v);
 		}
 	}
 
@@ -75,10 +75,11 @@ SphereMesh::SphereMesh(unsigned int divisions, const Vector3 &scale)
 		m_commands.push_back(cmd);
 	}
 
-	// create vertex buffers
-	m_vertices = VertexBuffer::create(&(verts[0]), (unsigned int)verts.size());
-	m_texCoords = VertexBuffer::create(&(texCoords[0]), (unsigned int)texCoords.size());
-	m_tangentSpace = VertexBuffer::create(&(tangentSpace[0]), (unsigned int)tangentSpace.size());
+	// create vertex buffer
+	setVertices(verts);
+
+	// draw the whole mesh with a single call
+	bake();
 }
 
 RefPtr <SphereMesh>
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <DromeCore/LinearAllocator.h>
+#include <DromeGfx/SpriteBatch.h>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeMath;
+
+namespace DromeGfx {
+
+SpriteBatch::SpriteBatch()
+{
+	m_sortByTexture = false;
+}
+
+SpriteBatch::~SpriteBatch()
+{
+}
+
+void
+SpriteBatch::addQuad(const RefPtr <Texture> &texture, const Color &color,
+                     const Rect2i &src, const Rect2i &dest)
+{
+	float s0 = 0.0f, t0 = 0.0f, s1 = 0.0f, t1 = 0.0f;
+	if(texture.isSet()) {
+		float width = (float)texture->getWidth();
+		float height = (float)texture->getHeight();
+
+		s0 = (float)src.min.x / width;
+		t0 = (float)src.min.y / height;
+		s1 = (float)src.max.x / width;
+		t1 = (float)src.max.y / height;
+	}
+
+	SpriteVertex corners[4] = {
+		{ (float)dest.min.x, (float)dest.min.y, s0, t0, color },
+		{ (float)dest.min.x, (float)dest.max.y, s0, t1, color },
+		{ (float)dest.max.x, (float)dest.min.y, s1, t0, color },
+		{ (float)dest.max.x, (float)dest.max.y, s1, t1, color }
+	};
+
+	// two counter-clockwise triangles
+	m_vertices.push_back(corners[0]);
+	m_vertices.push_back(corners[1]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[1]);
+	m_vertices.push_back(corners[3]);
+
+	// extend the last batch if it uses the same texture
+	if(!m_batches.empty() && m_batches.back().texture == texture) {
+		m_batches.back().numVertices += VERTICES_PER_QUAD;
+	} else {
+		Batch batch;
+		batch.texture = texture;
+		batch.firstVertex = (unsigned int)m_vertices.size() - VERTICES_PER_QUAD;
+		batch.numVertices = VERTICES_PER_QUAD;
+		m_batches.push_back(batch);
+	}
+}
+
+static bool
+compareBatchTextures(const SpriteBatch::Batch &b1, const SpriteBatch::Batch &b2)
+{
+	return b1.texture.get() < b2.texture.get();
+}
+
+void
+SpriteBatch::sort()
+{
+	if(!m_sortByTexture || m_batches.size() < 2)
+		return;
+
+	// the sorted copies are scratch memory
+	LinearAllocator &frameAllocator = LinearAllocator::getFrameAllocator();
+	LinearAllocatorScope scope(frameAllocator);
+
+	// stable sorting keeps the order of quads that use the same texture
+	vector <Batch, LinearStlAllocator <Batch> > batches(m_batches.begin(), m_batches.end(),
+	                                                    LinearStlAllocator <Batch> (frameAllocator));
+	stable_sort(batches.begin(), batches.end(), compareBatchTextures);
+
+	// copy the vertices in batch order and merge batches with the same texture
+	SpriteVertex *vertices = frameAllocator.allocateArray <SpriteVertex> (m_vertices.size());
+	unsigned int numVertices = 0;
+	m_batches.clear();
+	for(unsigned int i = 0; i < batches.size(); ++i) {
+		const Batch &b = batches[i];
+
+		if(!m_batches.empty() && m_batches.back().texture == b.texture) {
+			m_batches.back().numVertices += b.numVertices;
+		} else {
+			Batch batch;
+			batch.texture = b.texture;
+			batch.firstVertex = numVertices;
+			batch.numVertices = b.numVertices;
+			m_batches.push_back(batch);
+		}
+
+		copy(m_vertices.begin() + b.firstVertex, m_vertices.begin() + b.firstVertex + b.numVertices,
+		     vertices + numVertices);
+		numVertices += b.numVertices;
+	}
+
+	copy(vertices, vertices + numVertices, m_vertices.begin());
+}
+
+void
+SpriteBatch::clear()
+{
+	m_vertices.clear();
+	m_batches.clear();
+}
+
+RefPtr <SpriteBatch>
+SpriteBatch::create()
+{
+	return RefPtr <SpriteBatch> (new SpriteBatch());
+}
+
+} // namespace DromeGfx
@@ -24,6 +24,9 @@
  */
 
 #include <DromeCore/Exception.h>
+#include <DromeCore/ObjectPool.h>
+#include <DromeCore/Profiler.h>
+#include <DromeGfx/Driver.h>
 #include <DromeGfx/OpenGL.h>
 #include <DromeGfx/Texture.h>
 
@@ -31,18 +34,44 @@ using namespace DromeCore;
 
 namespace DromeGfx {
 
-Texture::Texture()
+static ObjectPool texturePool("Texture");
+
+void *
+Texture::operator new(size_t size)
 {
-	// generate texture
-	glGenTextures(1, &m_id);
+	return texturePool.allocate(size);
+}
 
+void
+Texture::operator delete(void *ptr, size_t size)
+{
+	texturePool.deallocate(ptr, size);
+}
+
+Texture::Texture()
+{
 	m_width = 0;
 	m_height = 0;
+
+	// generate texture
+	m_id = 0;
+	if(GfxDriver::isGLEnabled())
+		glGenTextures(1, &m_id);
 }
 
-Texture::Texture(RefPtr <Image> image)
+Texture::Texture(const RefPtr <Image> &image)
 {
-	// generate and bind texture
+	m_width = image->getWidth();
+	m_height = image->getHeight();
+
+	m_id = 0;
+	if(!GfxDriver::isGLEnabled())
+		return;
+
+	// generate and bind texture, remembering the previous binding
+	// so that the state cached by the driver stays valid
+	GLint previousId;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousId);
 	glGenTextures(1, &m_id);
 	glBindTexture(GL_TEXTURE_2D, m_id);
 
@@ -57,6 +86,7 @@ Texture::Texture(RefPtr <Image> image)
 	GLint format;
 	switch(image->getNumComponents()) {
 		default:
+			glBindTexture(GL_TEXTURE_2D, previousId);
 			glDeleteTextures(1, &m_id);
 			throw Exception("Texture::Texture(): Unsupported number of color components");
 			break;
@@ -76,14 +106,13 @@ Texture::Texture(RefPtr <Image> image)
 
 	// create the texture using the image data
 	glTexImage2D(GL_TEXTURE_2D, 0, format, image->getWidth(), image->getHeight(), 0, format, GL_UNSIGNED_BYTE, image->getData());
-
-	m_width = image->getWidth();
-	m_height = image->getHeight();
+	glBindTexture(GL_TEXTURE_2D, previousId);
 }
 
 Texture::~Texture()
 {
-	glDeleteTextures(1, &m_id);
+	if(m_id != 0)
+		glDeleteTextures(1, &m_id);
 }
 
 unsigned int
@@ -111,8 +140,10 @@ Texture::none()
 }
 
 RefPtr <Texture>
-Texture::create(RefPtr <Image> image)
+Texture::create(const RefPtr <Image> &image)
 {
+	ProfilerZone zone("Texture::create");
+
 	return RefPtr <Texture> (new Texture(image));
 }
 
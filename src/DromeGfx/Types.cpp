@@ -47,4 +47,17 @@ primitiveTypeToGL(PrimitiveType type)
 	}
 }
 
+unsigned int
+vertexBufferUsageToGL(VertexBufferUsage usage)
+{
+	switch(usage) {
+		default:
+			return GL_STATIC_DRAW;
+		case VERTEX_BUFFER_USAGE_DYNAMIC:
+			return GL_DYNAMIC_DRAW;
+		case VERTEX_BUFFER_USAGE_STREAM:
+			return GL_STREAM_DRAW;
+	}
+}
+
 } // namespace DromeGfx
@@ -24,6 +24,8 @@
  */
 
 #include <DromeCore/Exception.h>
+#include <DromeCore/ObjectPool.h>
+#include <DromeGfx/Driver.h>
 #include <DromeGfx/OpenGL.h>
 #include <DromeGfx/VertexBuffer.h>
 
@@ -32,17 +34,44 @@ using namespace DromeMath;
 
 namespace DromeGfx {
 
-VertexBuffer::VertexBuffer(const float *data, int size)
+static ObjectPool vertexBufferPool("VertexBuffer");
+
+void *
+VertexBuffer::operator new(size_t size)
 {
+	return vertexBufferPool.allocate(size);
+}
+
+void
+VertexBuffer::operator delete(void *ptr, size_t size)
+{
+	vertexBufferPool.deallocate(ptr, size);
+}
+
+VertexBuffer::VertexBuffer(const float *data, int size, VertexBufferUsage usage)
+{
+	m_size = size;
+	m_usage = usage;
+
+	m_id = 0;
+	if(!GfxDriver::isGLEnabled())
+		return;
+
+	// remember the previous binding so that the
+	// state cached by the driver stays valid
+	GLint previousId;
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousId);
+
 	glGenBuffers(1, &m_id);
 	glBindBuffer(GL_ARRAY_BUFFER, m_id);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * size, data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * size, data, vertexBufferUsageToGL(usage));
+	glBindBuffer(GL_ARRAY_BUFFER, previousId);
 }
 
 VertexBuffer::~VertexBuffer()
 {
-	glDeleteBuffers(1, &m_id);
+	if(m_id != 0)
+		glDeleteBuffers(1, &m_id);
 }
 
 unsigned int
@@ -51,6 +80,73 @@ VertexBuffer::getId() const
 	return m_id;
 }
 
+int
+VertexBuffer::getSize() const
+{
+	return m_size;
+}
+
+VertexBufferUsage
+VertexBuffer::getUsage() const
+{
+	return m_usage;
+}
+
+void
+VertexBuffer::setData(const float *data, int size)
+{
+	if(m_id == 0) {
+		m_size = size;
+		return;
+	}
+
+	// remember the previous binding so that the
+	// state cached by the driver stays valid
+	GLint previousId;
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousId);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_id);
+	setBoundData(data, size);
+	glBindBuffer(GL_ARRAY_BUFFER, previousId);
+}
+
+void
+VertexBuffer::setBoundData(const float *data, int size)
+{
+	m_size = size;
+	if(m_id == 0)
+		return;
+
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * size, data, vertexBufferUsageToGL(m_usage));
+}
+
+void
+VertexBuffer::setSubData(int offset, const float *data, int size)
+{
+	if(offset < 0 || size < 0 || offset + size > m_size)
+		throw Exception("VertexBuffer::setSubData(): Range exceeds the size of the buffer");
+	if(m_id == 0)
+		return;
+
+	GLint previousId;
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousId);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_id);
+	setBoundSubData(offset, data, size);
+	glBindBuffer(GL_ARRAY_BUFFER, previousId);
+}
+
+void
+VertexBuffer::setBoundSubData(int offset, const float *data, int size)
+{
+	if(offset < 0 || size < 0 || offset + size > m_size)
+		throw Exception("VertexBuffer::setBoundSubData(): Range exceeds the size of the buffer");
+	if(m_id == 0)
+		return;
+
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * offset, sizeof(float) * size, data);
+}
+
 RefPtr <VertexBuffer>
 VertexBuffer::none()
 {
@@ -58,21 +154,21 @@ VertexBuffer::none()
 }
 
 RefPtr <VertexBuffer>
-VertexBuffer::create(const float *data, int size)
+VertexBuffer::create(const float *data, int size, VertexBufferUsage usage)
 {
-	return RefPtr <VertexBuffer> (new VertexBuffer(data, size));
+	return RefPtr <VertexBuffer> (new VertexBuffer(data, size, usage));
 }
 
 RefPtr <VertexBuffer>
 VertexBuffer::create(const Vector3 *data, int size)
 {
-	return RefPtr <VertexBuffer> (new VertexBuffer((const float *)data, size * 3));
+	return RefPtr <VertexBuffer> (new VertexBuffer((const float *)data, size * 3, VERTEX_BUFFER_USAGE_STATIC));
 }
 
 RefPtr <VertexBuffer>
 VertexBuffer::create(const Matrix4 *data, int size)
 {
-	return RefPtr <VertexBuffer> (new VertexBuffer((const float *)data, size * 16));
+	return RefPtr <VertexBuffer> (new VertexBuffer((const float *)data, size * 16, VERTEX_BUFFER_USAGE_STATIC));
 }
 
 } // namespace DromeGfx
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <DromeCore/Exception.h>
+#include <DromeGfx/VertexLayout.h>
+
+using namespace DromeCore;
+
+namespace DromeGfx {
+
+VertexLayout::VertexLayout(unsigned int stride)
+{
+	m_stride = stride;
+
+	for(unsigned int i = 0; i < NUM_VERTEX_ATTRIBUTES; ++i)
+		m_offsets[i] = -1;
+}
+
+void
+VertexLayout::setAttribute(VertexAttribute attribute, unsigned int offset)
+{
+	if(attribute >= NUM_VERTEX_ATTRIBUTES)
+		throw Exception("VertexLayout::setAttribute(): Invalid vertex attribute");
+
+	m_offsets[attribute] = (int)offset;
+}
+
+VertexLayout
+VertexLayout::meshVertex()
+{
+	VertexLayout layout(sizeof(MeshVertex));
+
+	layout.setAttribute(VERTEX_ATTRIBUTE_POSITION, 0);
+	layout.setAttribute(VERTEX_ATTRIBUTE_TEXCOORD, sizeof(float) * 3);
+	layout.setAttribute(VERTEX_ATTRIBUTE_TANGENT, sizeof(float) * 5);
+	layout.setAttribute(VERTEX_ATTRIBUTE_BINORMAL, sizeof(float) * 8);
+	layout.setAttribute(VERTEX_ATTRIBUTE_NORMAL, sizeof(float) * 11);
+
+	return layout;
+}
+
+} // namespace DromeGfx
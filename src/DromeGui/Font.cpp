@@ -24,6 +24,7 @@
  */
 
 #include <DromeCore/File.h>
+#include <DromeCore/Profiler.h>
 #include <DromeGui/Font.h>
 #ifdef APPLE
 	#include "CoreGraphicsFont.h"
@@ -233,6 +234,8 @@ RefPtr <Font>
 Font::create(GfxDriver *driver, const char *filename,
              unsigned int width, unsigned int height)
 {
+	ProfilerZone zone("Font::create");
+
 #ifdef APPLE
 	return CoreGraphicsFont::create(driver, File::getPath(filename).c_str(), width, height);
 #else
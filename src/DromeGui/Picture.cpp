@@ -31,7 +31,7 @@ using namespace DromeMath;
 
 namespace DromeGui {
 
-Picture::Picture(GfxDriver * /*driver*/, RefPtr <Image> image)
+Picture::Picture(GfxDriver * /*driver*/, const RefPtr <Image> &image)
 {
 	m_imageWidth = image->getWidth();
 	m_imageHeight = image->getHeight();
@@ -61,7 +61,7 @@ Picture::render(GfxDriver *driver)
 }
 
 RefPtr <Picture>
-Picture::create(GfxDriver *driver, RefPtr <Image> image)
+Picture::create(GfxDriver *driver, const RefPtr <Image> &image)
 {
 	return RefPtr <Picture> (new Picture(driver, image));
 }
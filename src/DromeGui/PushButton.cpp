@@ -32,8 +32,8 @@ using namespace DromeMath;
 
 namespace DromeGui {
 
-PushButton::PushButton(GfxDriver *driver, RefPtr <Image> image,
-                       RefPtr <Font> font)
+PushButton::PushButton(GfxDriver *driver, const RefPtr <Image> &image,
+                       const RefPtr <Font> &font)
  : Picture(driver, image)
 {
 	m_font = font;
@@ -71,7 +71,7 @@ PushButton::render(GfxDriver *driver)
 }
 
 RefPtr <PushButton>
-PushButton::create(GfxDriver *driver, RefPtr <Image> image, RefPtr <Font> font)
+PushButton::create(GfxDriver *driver, const RefPtr <Image> &image, const RefPtr <Font> &font)
 {
 	return RefPtr <PushButton> (new PushButton(driver, image, font));
 }
@@ -52,6 +52,13 @@ BoundingBox::getType() const
 	return PHYSICS_OBJECT_TYPE_BOUNDING_BOX;
 }
 
+void
+BoundingBox::getBounds(Vector3 &min, Vector3 &max) const
+{
+	min = m_position - m_bounds;
+	max = m_position + m_bounds;
+}
+
 static bool
 pointInBox(const Vector3 &point,
            const Vector3 &boxPosition, const Vector3 &boxBounds)
@@ -177,6 +184,8 @@ BoundingBox::collisionCheck(const PhysicsObject *object) const
 			return pointInBox(object->getPosition(), m_position, m_bounds);
 		case PHYSICS_OBJECT_TYPE_BOUNDING_BOX:
 			return collisionCheck((const BoundingBox *)object);
+		case PHYSICS_OBJECT_TYPE_BOUNDING_SPHERE:
+			return collisionCheck((const BoundingSphere *)object);
 	}
 }
 
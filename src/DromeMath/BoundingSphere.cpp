@@ -53,6 +53,13 @@ BoundingSphere::getType() const
 	return PHYSICS_OBJECT_TYPE_BOUNDING_SPHERE;
 }
 
+void
+BoundingSphere::getBounds(Vector3 &min, Vector3 &max) const
+{
+	min = m_position - m_radius;
+	max = m_position + m_radius;
+}
+
 static bool
 pointInSphere(const Vector3 &point,
               const Vector3 &spherePosition, float sphereRadius)
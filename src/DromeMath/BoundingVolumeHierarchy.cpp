@@ -0,0 +1,505 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <DromeMath/BoundingSphere.h>
+#include <DromeMath/BoundingVolumeHierarchy.h>
+
+using namespace std;
+
+namespace DromeMath {
+
+// number of bins used to evaluate split positions along each axis
+static const unsigned int NUM_BINS = 16;
+
+// leaves with more objects than this are always split if possible
+static const unsigned int MAX_LEAF_OBJECTS = 4;
+
+// limits the depth of the tree so that queries can use a fixed-size stack
+static const unsigned int MAX_DEPTH = 48;
+static const unsigned int STACK_SIZE = 64;
+
+static inline float
+getAxis(const Vector3 &v, unsigned int axis)
+{
+	return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+static inline void
+growBounds(Vector3 &min, Vector3 &max, const Vector3 &otherMin, const Vector3 &otherMax)
+{
+	min.x = std::min(min.x, otherMin.x);
+	min.y = std::min(min.y, otherMin.y);
+	min.z = std::min(min.z, otherMin.z);
+	max.x = std::max(max.x, otherMax.x);
+	max.y = std::max(max.y, otherMax.y);
+	max.z = std::max(max.z, otherMax.z);
+}
+
+static inline float
+getSurfaceArea(const Vector3 &min, const Vector3 &max)
+{
+	float x = max.x - min.x;
+	float y = max.y - min.y;
+	float z = max.z - min.z;
+
+	return 2.0f * (x*y + y*z + z*x);
+}
+
+static inline bool
+boxesOverlap(const Vector3 &min1, const Vector3 &max1, const Vector3 &min2, const Vector3 &max2)
+{
+	return (min1.x <= max2.x) && (max1.x >= min2.x) &&
+	       (min1.y <= max2.y) && (max1.y >= min2.y) &&
+	       (min1.z <= max2.z) && (max1.z >= min2.z);
+}
+
+// returns the distance along the ray at which it enters the box, or a
+// negative value if the ray misses the box within the given distance
+static inline float
+rayBoxDistance(const Vector3 &origin, const Vector3 &inverseDirection, float maxDistance,
+               const Vector3 &min, const Vector3 &max)
+{
+	float t1 = (min.x - origin.x) * inverseDirection.x;
+	float t2 = (max.x - origin.x) * inverseDirection.x;
+	float tmin = std::min(t1, t2);
+	float tmax = std::max(t1, t2);
+
+	t1 = (min.y - origin.y) * inverseDirection.y;
+	t2 = (max.y - origin.y) * inverseDirection.y;
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	t1 = (min.z - origin.z) * inverseDirection.z;
+	t2 = (max.z - origin.z) * inverseDirection.z;
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	tmin = std::max(tmin, 0.0f);
+	if(tmax < tmin || tmin > maxDistance)
+		return -1.0f;
+
+	return tmin;
+}
+
+static inline float
+raySphereDistance(const Vector3 &origin, const Vector3 &direction, float maxDistance,
+                  const Vector3 &center, float radius)
+{
+	Vector3 offset = origin - center;
+	float a = direction.dotProduct(direction);
+	float b = offset.dotProduct(direction);
+	float c = offset.dotProduct(offset) - radius * radius;
+
+	// the ray starts inside the sphere
+	if(c <= 0.0f)
+		return 0.0f;
+
+	float discriminant = b*b - a*c;
+	if(b > 0.0f || discriminant < 0.0f || a == 0.0f)
+		return -1.0f;
+
+	float t = (-b - sqrtf(discriminant)) / a;
+	return (t <= maxDistance) ? t : -1.0f;
+}
+
+const unsigned int BoundingVolumeHierarchy::INVALID_INDEX;
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+}
+
+void
+BoundingVolumeHierarchy::clear()
+{
+	m_objects.clear();
+	m_objectMin.clear();
+	m_objectMax.clear();
+	m_objectOrder.clear();
+	m_objectLeaves.clear();
+	m_nodes.clear();
+}
+
+unsigned int
+BoundingVolumeHierarchy::addObject(const PhysicsObject *object)
+{
+	m_objects.push_back(object);
+	m_objectMin.push_back(Vector3());
+	m_objectMax.push_back(Vector3());
+	m_objectLeaves.push_back(INVALID_INDEX);
+
+	return (unsigned int)m_objects.size() - 1;
+}
+
+void
+BoundingVolumeHierarchy::updateObjectBounds(unsigned int objectIndex)
+{
+	m_objects[objectIndex]->getBounds(m_objectMin[objectIndex], m_objectMax[objectIndex]);
+}
+
+bool
+BoundingVolumeHierarchy::updateNodeBounds(unsigned int nodeIndex)
+{
+	BoundingVolumeHierarchyNode &node = m_nodes[nodeIndex];
+	Vector3 min, max;
+
+	if(node.isLeaf()) {
+		unsigned int objectIndex = m_objectOrder[node.offset];
+		min = m_objectMin[objectIndex];
+		max = m_objectMax[objectIndex];
+		for(unsigned int i = 1; i < node.numObjects; ++i) {
+			objectIndex = m_objectOrder[node.offset + i];
+			growBounds(min, max, m_objectMin[objectIndex], m_objectMax[objectIndex]);
+		}
+	} else {
+		const BoundingVolumeHierarchyNode &left = m_nodes[nodeIndex + 1];
+		const BoundingVolumeHierarchyNode &right = m_nodes[node.offset];
+		min = left.min;
+		max = left.max;
+		growBounds(min, max, right.min, right.max);
+	}
+
+	bool changed = min.x != node.min.x || min.y != node.min.y || min.z != node.min.z ||
+	               max.x != node.max.x || max.y != node.max.y || max.z != node.max.z;
+	node.min = min;
+	node.max = max;
+
+	return changed;
+}
+
+// predicate for partitioning objects by the bin their center falls into
+class BinPredicate
+{
+	private:
+		const Vector3 *m_min, *m_max;
+		unsigned int m_axis;
+		float m_centerMin, m_scale;
+		unsigned int m_splitBin;
+
+	public:
+		BinPredicate(const Vector3 *minParam, const Vector3 *maxParam, unsigned int axisParam,
+		             float centerMinParam, float scaleParam, unsigned int splitBinParam)
+		{
+			m_min = minParam;
+			m_max = maxParam;
+			m_axis = axisParam;
+			m_centerMin = centerMinParam;
+			m_scale = scaleParam;
+			m_splitBin = splitBinParam;
+		}
+
+		unsigned int getBin(unsigned int objectIndex) const
+		{
+			float center = (getAxis(m_min[objectIndex], m_axis) + getAxis(m_max[objectIndex], m_axis)) * 0.5f;
+			unsigned int bin = (unsigned int)((center - m_centerMin) * m_scale);
+			return std::min(bin, NUM_BINS - 1);
+		}
+
+		bool operator () (unsigned int objectIndex) const
+		{
+			return getBin(objectIndex) <= m_splitBin;
+		}
+};
+
+unsigned int
+BoundingVolumeHierarchy::buildNode(unsigned int first, unsigned int count,
+                                   unsigned int parent, unsigned int depth)
+{
+	unsigned int nodeIndex = (unsigned int)m_nodes.size();
+	m_nodes.push_back(BoundingVolumeHierarchyNode());
+
+	// calculate the bounds of the objects and of their centers
+	unsigned int objectIndex = m_objectOrder[first];
+	Vector3 min = m_objectMin[objectIndex];
+	Vector3 max = m_objectMax[objectIndex];
+	Vector3 centerMin = (min + max) * 0.5f;
+	Vector3 centerMax = centerMin;
+	for(unsigned int i = 1; i < count; ++i) {
+		objectIndex = m_objectOrder[first + i];
+		growBounds(min, max, m_objectMin[objectIndex], m_objectMax[objectIndex]);
+
+		Vector3 center = (m_objectMin[objectIndex] + m_objectMax[objectIndex]) * 0.5f;
+		growBounds(centerMin, centerMax, center, center);
+	}
+
+	m_nodes[nodeIndex].min = min;
+	m_nodes[nodeIndex].max = max;
+	m_nodes[nodeIndex].parent = parent;
+
+	// find the split with the lowest surface area heuristic cost
+	unsigned int bestAxis = INVALID_INDEX;
+	unsigned int bestBin = 0;
+	float bestCost = FLT_MAX;
+	float bestScale = 0.0f;
+	if(count > 1 && depth < MAX_DEPTH) {
+		for(unsigned int axis = 0; axis < 3; ++axis) {
+			float axisMin = getAxis(centerMin, axis);
+			float axisMax = getAxis(centerMax, axis);
+			if(axisMax <= axisMin)
+				continue;
+
+			float scale = (float)NUM_BINS / (axisMax - axisMin);
+			BinPredicate predicate(&m_objectMin[0], &m_objectMax[0], axis, axisMin, scale, 0);
+
+			unsigned int binCounts[NUM_BINS];
+			Vector3 binMin[NUM_BINS], binMax[NUM_BINS];
+			for(unsigned int i = 0; i < NUM_BINS; ++i) {
+				binCounts[i] = 0;
+				binMin[i] = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+				binMax[i] = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			}
+
+			for(unsigned int i = 0; i < count; ++i) {
+				objectIndex = m_objectOrder[first + i];
+				unsigned int bin = predicate.getBin(objectIndex);
+				++binCounts[bin];
+				growBounds(binMin[bin], binMax[bin], m_objectMin[objectIndex], m_objectMax[objectIndex]);
+			}
+
+			// sweep from the right to get the cost of each right side
+			float rightCosts[NUM_BINS];
+			Vector3 sideMin = binMin[NUM_BINS - 1];
+			Vector3 sideMax = binMax[NUM_BINS - 1];
+			unsigned int sideCount = binCounts[NUM_BINS - 1];
+			rightCosts[NUM_BINS - 1] = (float)sideCount * getSurfaceArea(sideMin, sideMax);
+			for(unsigned int i = NUM_BINS - 1; i > 1; --i) {
+				growBounds(sideMin, sideMax, binMin[i - 1], binMax[i - 1]);
+				sideCount += binCounts[i - 1];
+				rightCosts[i - 1] = (sideCount == 0) ? 0.0f : (float)sideCount * getSurfaceArea(sideMin, sideMax);
+			}
+
+			// sweep from the left, splitting after each bin
+			sideMin = binMin[0];
+			sideMax = binMax[0];
+			sideCount = binCounts[0];
+			for(unsigned int i = 0; i < NUM_BINS - 1; ++i) {
+				if(i != 0) {
+					growBounds(sideMin, sideMax, binMin[i], binMax[i]);
+					sideCount += binCounts[i];
+				}
+				if(sideCount == 0 || sideCount == count)
+					continue;
+
+				float cost = (float)sideCount * getSurfaceArea(sideMin, sideMax) + rightCosts[i + 1];
+				if(cost < bestCost) {
+					bestAxis = axis;
+					bestBin = i;
+					bestCost = cost;
+					bestScale = scale;
+				}
+			}
+		}
+	}
+
+	// compare the cost of splitting (one traversal step
+	// plus the children) with the cost of a leaf
+	float area = getSurfaceArea(min, max);
+	bool makeLeaf = (bestAxis == INVALID_INDEX) ||
+	                (count <= MAX_LEAF_OBJECTS && area + bestCost >= (float)count * area);
+
+	unsigned int numLeft = 0;
+	if(!makeLeaf) {
+		BinPredicate predicate(&m_objectMin[0], &m_objectMax[0], bestAxis,
+		                       getAxis(centerMin, bestAxis), bestScale, bestBin);
+		unsigned int *begin = &m_objectOrder[0] + first;
+		numLeft = (unsigned int)(std::partition(begin, begin + count, predicate) - begin);
+		makeLeaf = (numLeft == 0 || numLeft == count);
+	}
+
+	if(makeLeaf) {
+		m_nodes[nodeIndex].offset = first;
+		m_nodes[nodeIndex].numObjects = count;
+		for(unsigned int i = 0; i < count; ++i)
+			m_objectLeaves[m_objectOrder[first + i]] = nodeIndex;
+	} else {
+		m_nodes[nodeIndex].numObjects = 0;
+		buildNode(first, numLeft, nodeIndex, depth + 1);
+		unsigned int right = buildNode(first + numLeft, count - numLeft, nodeIndex, depth + 1);
+		m_nodes[nodeIndex].offset = right;
+	}
+
+	return nodeIndex;
+}
+
+void
+BoundingVolumeHierarchy::build()
+{
+	m_nodes.clear();
+	m_objectOrder.resize(m_objects.size());
+	for(unsigned int i = 0; i < m_objects.size(); ++i) {
+		updateObjectBounds(i);
+		m_objectOrder[i] = i;
+	}
+
+	if(m_objects.empty())
+		return;
+
+	m_nodes.reserve(m_objects.size() * 2);
+	buildNode(0, (unsigned int)m_objects.size(), INVALID_INDEX, 0);
+}
+
+void
+BoundingVolumeHierarchy::refit()
+{
+	for(unsigned int i = 0; i < m_objects.size(); ++i)
+		updateObjectBounds(i);
+
+	// children always follow their parents, so nodes
+	// can be updated from the last to the first
+	for(unsigned int i = (unsigned int)m_nodes.size(); i > 0; --i)
+		updateNodeBounds(i - 1);
+}
+
+void
+BoundingVolumeHierarchy::refit(unsigned int objectIndex)
+{
+	updateObjectBounds(objectIndex);
+
+	// update the nodes above the object until one doesn't change
+	unsigned int nodeIndex = m_objectLeaves[objectIndex];
+	while(nodeIndex != INVALID_INDEX && updateNodeBounds(nodeIndex))
+		nodeIndex = m_nodes[nodeIndex].parent;
+}
+
+void
+BoundingVolumeHierarchy::query(const Frustum &frustum, vector <unsigned int> &results) const
+{
+	if(m_nodes.empty())
+		return;
+
+	unsigned int stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize != 0) {
+		const BoundingVolumeHierarchyNode &node = m_nodes[stack[--stackSize]];
+		if(!frustum.intersectsBox((node.min + node.max) * 0.5f, (node.max - node.min) * 0.5f))
+			continue;
+
+		if(node.isLeaf()) {
+			for(unsigned int i = 0; i < node.numObjects; ++i) {
+				unsigned int objectIndex = m_objectOrder[node.offset + i];
+				const Vector3 &min = m_objectMin[objectIndex];
+				const Vector3 &max = m_objectMax[objectIndex];
+				if(node.numObjects == 1 || frustum.intersectsBox((min + max) * 0.5f, (max - min) * 0.5f))
+					results.push_back(objectIndex);
+			}
+		} else {
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = (unsigned int)(&node - &m_nodes[0]) + 1;
+		}
+	}
+}
+
+void
+BoundingVolumeHierarchy::query(const Vector3 &min, const Vector3 &max,
+                               vector <unsigned int> &results) const
+{
+	if(m_nodes.empty())
+		return;
+
+	unsigned int stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize != 0) {
+		const BoundingVolumeHierarchyNode &node = m_nodes[stack[--stackSize]];
+		if(!boxesOverlap(min, max, node.min, node.max))
+			continue;
+
+		if(node.isLeaf()) {
+			for(unsigned int i = 0; i < node.numObjects; ++i) {
+				unsigned int objectIndex = m_objectOrder[node.offset + i];
+				if(boxesOverlap(min, max, m_objectMin[objectIndex], m_objectMax[objectIndex]))
+					results.push_back(objectIndex);
+			}
+		} else {
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = (unsigned int)(&node - &m_nodes[0]) + 1;
+		}
+	}
+}
+
+void
+BoundingVolumeHierarchy::query(const PhysicsObject *object, vector <unsigned int> &results) const
+{
+	Vector3 min, max;
+	object->getBounds(min, max);
+	query(min, max, results);
+}
+
+RaycastInfo
+BoundingVolumeHierarchy::raycast(const Vector3 &origin, const Vector3 &direction,
+                                 float maxDistance) const
+{
+	RaycastInfo info(false, 0, maxDistance);
+	if(m_nodes.empty())
+		return info;
+
+	Vector3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+	unsigned int stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize != 0) {
+		const BoundingVolumeHierarchyNode &node = m_nodes[stack[--stackSize]];
+
+		// skip nodes that are missed or are further away than the closest hit
+		if(rayBoxDistance(origin, inverseDirection, info.distance, node.min, node.max) < 0.0f)
+			continue;
+
+		if(node.isLeaf()) {
+			for(unsigned int i = 0; i < node.numObjects; ++i) {
+				unsigned int objectIndex = m_objectOrder[node.offset + i];
+				const PhysicsObject *object = m_objects[objectIndex];
+
+				float distance;
+				if(object->getType() == PHYSICS_OBJECT_TYPE_BOUNDING_SPHERE)
+					distance = raySphereDistance(origin, direction, info.distance, object->getPosition(), ((const BoundingSphere *)object)->getRadius());
+				else
+					distance = rayBoxDistance(origin, inverseDirection, info.distance, m_objectMin[objectIndex], m_objectMax[objectIndex]);
+
+				if(distance >= 0.0f) {
+					info.hit = true;
+					info.objectIndex = objectIndex;
+					info.distance = distance;
+				}
+			}
+		} else {
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = (unsigned int)(&node - &m_nodes[0]) + 1;
+		}
+	}
+
+	if(!info.hit)
+		info.distance = 0.0f;
+
+	return info;
+}
+
+} // namespace DromeMath
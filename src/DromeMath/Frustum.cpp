@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <DromeMath/Frustum.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace DromeMath {
+
+Frustum::Frustum()
+{
+	setMatrix(Matrix4());
+}
+
+Frustum::Frustum(const Matrix4 &projectionView)
+{
+	setMatrix(projectionView);
+}
+
+void
+Frustum::setMatrix(const Matrix4 &projectionView)
+{
+	const float *m = projectionView.getData();
+
+	// the matrix is stored in column-major order, so
+	// each row is made of every fourth element
+	for(unsigned int i = 0; i < NUM_PLANES; ++i) {
+		int row = i / 2;
+		float sign = ((i % 2) == 0) ? 1.0f : -1.0f;
+
+		float x = m[3] + sign * m[row];
+		float y = m[7] + sign * m[4 + row];
+		float z = m[11] + sign * m[8 + row];
+		float d = m[15] + sign * m[12 + row];
+
+		// normalize the plane so that sphere radii can be compared
+		// against the distance of the sphere's center to the plane
+		float length = sqrtf(x*x + y*y + z*z);
+		if(length > 0.0f) {
+			x /= length;
+			y /= length;
+			z /= length;
+			d /= length;
+		}
+
+		m_normalX[i] = x;
+		m_normalY[i] = y;
+		m_normalZ[i] = z;
+		m_distance[i] = d;
+	}
+
+	for(unsigned int i = NUM_PLANES; i < NUM_PADDED_PLANES; ++i) {
+		m_normalX[i] = m_normalY[i] = m_normalZ[i] = 0.0f;
+		m_distance[i] = 1.0f;
+	}
+}
+
+Vector3
+Frustum::getPlaneNormal(Plane plane) const
+{
+	return Vector3(m_normalX[plane], m_normalY[plane], m_normalZ[plane]);
+}
+
+float
+Frustum::getPlaneDistance(Plane plane) const
+{
+	return m_distance[plane];
+}
+
+#ifdef __SSE__
+static inline bool
+isSphereOutside(const float *nx, const float *ny, const float *nz, const float *nd,
+                float cx, float cy, float cz, float radius)
+{
+	__m128 x = _mm_set1_ps(cx);
+	__m128 y = _mm_set1_ps(cy);
+	__m128 z = _mm_set1_ps(cz);
+	__m128 r = _mm_set1_ps(-radius);
+	int outside = 0;
+
+	// test four planes at a time
+	for(unsigned int i = 0; i < Frustum::NUM_PADDED_PLANES; i += 4) {
+		__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nx + i), x),
+		                                    _mm_mul_ps(_mm_loadu_ps(ny + i), y)),
+		                         _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nz + i), z),
+		                                    _mm_loadu_ps(nd + i)));
+		outside |= _mm_movemask_ps(_mm_cmplt_ps(dist, r));
+	}
+
+	return outside != 0;
+}
+
+static inline bool
+isBoxOutside(const float *nx, const float *ny, const float *nz, const float *nd,
+             float cx, float cy, float cz, float ex, float ey, float ez)
+{
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	__m128 x = _mm_set1_ps(cx);
+	__m128 y = _mm_set1_ps(cy);
+	__m128 z = _mm_set1_ps(cz);
+	__m128 extentX = _mm_set1_ps(ex);
+	__m128 extentY = _mm_set1_ps(ey);
+	__m128 extentZ = _mm_set1_ps(ez);
+	int outside = 0;
+
+	// test four planes at a time
+	for(unsigned int i = 0; i < Frustum::NUM_PADDED_PLANES; i += 4) {
+		__m128 planeX = _mm_loadu_ps(nx + i);
+		__m128 planeY = _mm_loadu_ps(ny + i);
+		__m128 planeZ = _mm_loadu_ps(nz + i);
+
+		__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX, x), _mm_mul_ps(planeY, y)),
+		                         _mm_add_ps(_mm_mul_ps(planeZ, z), _mm_loadu_ps(nd + i)));
+
+		// projected radius of the box onto the plane normal
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, planeX), extentX),
+		                                 _mm_mul_ps(_mm_andnot_ps(signMask, planeY), extentY)),
+		                      _mm_mul_ps(_mm_andnot_ps(signMask, planeZ), extentZ));
+
+		outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, r), _mm_setzero_ps()));
+	}
+
+	return outside != 0;
+}
+#else
+static inline bool
+isSphereOutside(const float *nx, const float *ny, const float *nz, const float *nd,
+                float cx, float cy, float cz, float radius)
+{
+	bool outside = false;
+
+	for(unsigned int i = 0; i < Frustum::NUM_PLANES; ++i) {
+		float dist = nx[i]*cx + ny[i]*cy + nz[i]*cz + nd[i];
+		outside |= (dist < -radius);
+	}
+
+	return outside;
+}
+
+static inline bool
+isBoxOutside(const float *nx, const float *ny, const float *nz, const float *nd,
+             float cx, float cy, float cz, float ex, float ey, float ez)
+{
+	bool outside = false;
+
+	for(unsigned int i = 0; i < Frustum::NUM_PLANES; ++i) {
+		float dist = nx[i]*cx + ny[i]*cy + nz[i]*cz + nd[i];
+		float r = fabsf(nx[i])*ex + fabsf(ny[i])*ey + fabsf(nz[i])*ez;
+		outside |= ((dist + r) < 0.0f);
+	}
+
+	return outside;
+}
+#endif
+
+bool
+Frustum::containsPoint(const Vector3 &point) const
+{
+	return !isSphereOutside(m_normalX, m_normalY, m_normalZ, m_distance,
+	                        point.x, point.y, point.z, 0.0f);
+}
+
+bool
+Frustum::intersectsSphere(const Vector3 &center, float radius) const
+{
+	return !isSphereOutside(m_normalX, m_normalY, m_normalZ, m_distance,
+	                        center.x, center.y, center.z, radius);
+}
+
+bool
+Frustum::intersectsBox(const Vector3 &center, const Vector3 &extents) const
+{
+	return !isBoxOutside(m_normalX, m_normalY, m_normalZ, m_distance,
+	                     center.x, center.y, center.z,
+	                     extents.x, extents.y, extents.z);
+}
+
+bool
+Frustum::intersects(const BoundingSphere &sphere) const
+{
+	return intersectsSphere(sphere.getPosition(), sphere.getRadius());
+}
+
+bool
+Frustum::intersects(const BoundingBox &box) const
+{
+	return intersectsBox(box.getPosition(), box.getBounds());
+}
+
+unsigned int
+Frustum::cullSpheres(const Vector3 *centers, const float *radii,
+                     unsigned int numSpheres, unsigned int *visibleIndices) const
+{
+	unsigned int numVisible = 0;
+
+	for(unsigned int i = 0; i < numSpheres; ++i) {
+		const Vector3 &c = centers[i];
+
+		// write every index and only advance past the visible ones
+		visibleIndices[numVisible] = i;
+		numVisible += isSphereOutside(m_normalX, m_normalY, m_normalZ, m_distance,
+		                              c.x, c.y, c.z, radii[i]) ? 0 : 1;
+	}
+
+	return numVisible;
+}
+
+unsigned int
+Frustum::cullBoxes(const Vector3 *centers, const Vector3 *extents,
+                   unsigned int numBoxes, unsigned int *visibleIndices) const
+{
+	unsigned int numVisible = 0;
+
+	for(unsigned int i = 0; i < numBoxes; ++i) {
+		const Vector3 &c = centers[i];
+		const Vector3 &e = extents[i];
+
+		// write every index and only advance past the visible ones
+		visibleIndices[numVisible] = i;
+		numVisible += isBoxOutside(m_normalX, m_normalY, m_normalZ, m_distance,
+		                           c.x, c.y, c.z, e.x, e.y, e.z) ? 0 : 1;
+	}
+
+	return numVisible;
+}
+
+} // namespace DromeMath
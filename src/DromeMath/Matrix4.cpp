@@ -25,12 +25,595 @@
 
 #include <cmath>
 #include <sstream>
+#include <vector>
 #include <DromeMath/Matrix4.h>
+#include <DromeMath/ParallelRunner.h>
+#include "Simd.h"
 
 using namespace std;
 
 namespace DromeMath {
 
+/*
+ * Kernels operating on arrays of 16 floats in column-major order. The
+ * result may be the same array as either operand.
+ */
+#if defined(DROMEMATH_SSE)
+static inline __m128
+transformSSE(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v)
+{
+	__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+	r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+	r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+	r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+	return r;
+}
+
+static inline void
+multiplyMatrices(const float *a, const float *b, float *result)
+{
+	__m128 c0 = _mm_loadu_ps(a);
+	__m128 c1 = _mm_loadu_ps(a + 4);
+	__m128 c2 = _mm_loadu_ps(a + 8);
+	__m128 c3 = _mm_loadu_ps(a + 12);
+
+	// each column of the result only depends on the same column of b
+	for(int i = 0; i < 16; i += 4)
+		_mm_storeu_ps(result + i, transformSSE(c0, c1, c2, c3, _mm_loadu_ps(b + i)));
+}
+
+static void
+transposeMatrix(const float *m, float *result)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	_mm_storeu_ps(result, c0);
+	_mm_storeu_ps(result + 4, c1);
+	_mm_storeu_ps(result + 8, c2);
+	_mm_storeu_ps(result + 12, c3);
+}
+
+/*
+ * Cramer's rule with the cofactors computed four at a time, after
+ * Intel's "Streaming SIMD Extensions - Inverse of 4x4 Matrix". The
+ * inverse of the transpose is the transpose of the inverse, so it works
+ * on the elements in either order.
+ */
+static void
+invertMatrix(const float *m, float *result)
+{
+	__m128 minor0, minor1, minor2, minor3;
+	__m128 row0, row1, row2, row3;
+	__m128 det, tmp;
+
+	tmp = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)m), (const __m64 *)(m + 4));
+	row1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(m + 8)), (const __m64 *)(m + 12));
+	row0 = _mm_shuffle_ps(tmp, row1, 0x88);
+	row1 = _mm_shuffle_ps(row1, tmp, 0xdd);
+	tmp = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(m + 2)), (const __m64 *)(m + 6));
+	row3 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(m + 10)), (const __m64 *)(m + 14));
+	row2 = _mm_shuffle_ps(tmp, row3, 0x88);
+	row3 = _mm_shuffle_ps(row3, tmp, 0xdd);
+
+	tmp = _mm_mul_ps(row2, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor0 = _mm_mul_ps(row1, tmp);
+	minor1 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+	minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+	minor1 = _mm_shuffle_ps(minor1, minor1, 0x4e);
+
+	tmp = _mm_mul_ps(row1, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+	minor3 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+	minor3 = _mm_shuffle_ps(minor3, minor3, 0x4e);
+
+	tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4e), row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	row2 = _mm_shuffle_ps(row2, row2, 0x4e);
+	minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+	minor2 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+	minor2 = _mm_shuffle_ps(minor2, minor2, 0x4e);
+
+	tmp = _mm_mul_ps(row0, row1);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+	tmp = _mm_mul_ps(row0, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+	minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+	tmp = _mm_mul_ps(row0, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+	// the determinant is the dot product of the first row and its cofactors
+	det = _mm_mul_ps(row0, minor0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4e), det);
+	det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xb1), det);
+	det = _mm_div_ss(_mm_set_ss(1.0f), det);
+	det = _mm_shuffle_ps(det, det, 0x00);
+
+	_mm_storeu_ps(result, _mm_mul_ps(det, minor0));
+	_mm_storeu_ps(result + 4, _mm_mul_ps(det, minor1));
+	_mm_storeu_ps(result + 8, _mm_mul_ps(det, minor2));
+	_mm_storeu_ps(result + 12, _mm_mul_ps(det, minor3));
+}
+
+static inline __m128
+crossProductSSE(__m128 a, __m128 b)
+{
+	__m128 a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 a2 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 b2 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+
+	return _mm_sub_ps(_mm_mul_ps(a1, b2), _mm_mul_ps(a2, b1));
+}
+
+/*
+ * Writes the inverse of an affine matrix m to result, given the columns of
+ * the inverse of its upper 3x3 (with W set to 0); the inverse translation
+ * is the inverted upper 3x3 times -t
+ */
+static inline void
+setAffineInverse(__m128 c0, __m128 c1, __m128 c2, const float *m, float *result)
+{
+	__m128 t = _mm_loadu_ps(m + 12);
+	__m128 c3 = _mm_mul_ps(c0, _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)));
+	c3 = _mm_add_ps(c3, _mm_mul_ps(c1, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+	c3 = _mm_add_ps(c3, _mm_mul_ps(c2, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2))));
+	c3 = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), c3);
+
+	_mm_storeu_ps(result, c0);
+	_mm_storeu_ps(result + 4, c1);
+	_mm_storeu_ps(result + 8, c2);
+	_mm_storeu_ps(result + 12, c3);
+}
+
+/*
+ * The rows of the inverse of the upper 3x3 are the cross products of its
+ * columns (the columns of its cofactor matrix) divided by its determinant
+ */
+static void
+invertAffineMatrix(const float *m, float *result)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+
+	__m128 r0 = crossProductSSE(c1, c2);
+	__m128 r1 = crossProductSSE(c2, c0);
+	__m128 r2 = crossProductSSE(c0, c1);
+	__m128 r3 = _mm_setzero_ps();
+
+	// the W of each column is 0, so the determinant is the sum of all four products
+	__m128 det = _mm_mul_ps(c0, r0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4e), det);
+	det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xb1), det);
+	det = _mm_div_ss(_mm_set_ss(1.0f), det);
+	det = _mm_shuffle_ps(det, det, 0x00);
+
+	r0 = _mm_mul_ps(r0, det);
+	r1 = _mm_mul_ps(r1, det);
+	r2 = _mm_mul_ps(r2, det);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	setAffineInverse(r0, r1, r2, m, result);
+}
+
+/*
+ * The inverse of a rotation is its transpose
+ */
+static void
+invertOrthonormalMatrix(const float *m, float *result)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_setzero_ps();
+
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	setAffineInverse(c0, c1, c2, m, result);
+}
+#elif defined(DROMEMATH_NEON)
+static inline float32x4_t
+transformNEON(float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t c3, float32x4_t v)
+{
+	float32x4_t r = vmulq_lane_f32(c0, vget_low_f32(v), 0);
+	r = vmlaq_lane_f32(r, c1, vget_low_f32(v), 1);
+	r = vmlaq_lane_f32(r, c2, vget_high_f32(v), 0);
+	r = vmlaq_lane_f32(r, c3, vget_high_f32(v), 1);
+
+	return r;
+}
+
+static inline void
+multiplyMatrices(const float *a, const float *b, float *result)
+{
+	float32x4_t c0 = vld1q_f32(a);
+	float32x4_t c1 = vld1q_f32(a + 4);
+	float32x4_t c2 = vld1q_f32(a + 8);
+	float32x4_t c3 = vld1q_f32(a + 12);
+
+	// each column of the result only depends on the same column of b
+	for(int i = 0; i < 16; i += 4)
+		vst1q_f32(result + i, transformNEON(c0, c1, c2, c3, vld1q_f32(b + i)));
+}
+
+static void
+transposeMatrix(const float *m, float *result)
+{
+	// the interleaved load gathers every fourth element into each register
+	float32x4x4_t rows = vld4q_f32(m);
+	vst1q_f32(result, rows.val[0]);
+	vst1q_f32(result + 4, rows.val[1]);
+	vst1q_f32(result + 8, rows.val[2]);
+	vst1q_f32(result + 12, rows.val[3]);
+}
+#else
+static inline void
+multiplyMatrices(const float *a, const float *b, float *result)
+{
+	float m[16];
+
+	for(int i = 0; i < 16; i += 4) {
+		for(int j = 0; j < 4; ++j)
+			m[i + j] = a[j] * b[i] + a[4 + j] * b[i + 1] + a[8 + j] * b[i + 2] + a[12 + j] * b[i + 3];
+	}
+
+	for(int i = 0; i < 16; ++i)
+		result[i] = m[i];
+}
+
+static void
+transposeMatrix(const float *m, float *result)
+{
+	float t[16];
+
+	for(int i = 0; i < 4; ++i) {
+		for(int j = 0; j < 4; ++j)
+			t[i*4+j] = m[j*4+i];
+	}
+
+	for(int i = 0; i < 16; ++i)
+		result[i] = t[i];
+}
+#endif
+
+#ifndef DROMEMATH_SSE
+/*
+ * Cramer's rule with the cofactors expanded from the 2x2 determinants
+ * of the first two and last two rows. The inverse of the transpose is
+ * the transpose of the inverse, so it works on the elements in either
+ * order.
+ */
+static void
+invertMatrix(const float *m, float *result)
+{
+	float a0 = m[0] * m[5] - m[1] * m[4];
+	float a1 = m[0] * m[6] - m[2] * m[4];
+	float a2 = m[0] * m[7] - m[3] * m[4];
+	float a3 = m[1] * m[6] - m[2] * m[5];
+	float a4 = m[1] * m[7] - m[3] * m[5];
+	float a5 = m[2] * m[7] - m[3] * m[6];
+	float b0 = m[8] * m[13] - m[9] * m[12];
+	float b1 = m[8] * m[14] - m[10] * m[12];
+	float b2 = m[8] * m[15] - m[11] * m[12];
+	float b3 = m[9] * m[14] - m[10] * m[13];
+	float b4 = m[9] * m[15] - m[11] * m[13];
+	float b5 = m[10] * m[15] - m[11] * m[14];
+
+	float invDet = 1.0f / (a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0);
+	float t[16];
+
+	t[ 0] = ( m[5] * b5 - m[6] * b4 + m[7] * b3) * invDet;
+	t[ 1] = (-m[1] * b5 + m[2] * b4 - m[3] * b3) * invDet;
+	t[ 2] = ( m[13] * a5 - m[14] * a4 + m[15] * a3) * invDet;
+	t[ 3] = (-m[9] * a5 + m[10] * a4 - m[11] * a3) * invDet;
+	t[ 4] = (-m[4] * b5 + m[6] * b2 - m[7] * b1) * invDet;
+	t[ 5] = ( m[0] * b5 - m[2] * b2 + m[3] * b1) * invDet;
+	t[ 6] = (-m[12] * a5 + m[14] * a2 - m[15] * a1) * invDet;
+	t[ 7] = ( m[8] * a5 - m[10] * a2 + m[11] * a1) * invDet;
+	t[ 8] = ( m[4] * b4 - m[5] * b2 + m[7] * b0) * invDet;
+	t[ 9] = (-m[0] * b4 + m[1] * b2 - m[3] * b0) * invDet;
+	t[10] = ( m[12] * a4 - m[13] * a2 + m[15] * a0) * invDet;
+	t[11] = (-m[8] * a4 + m[9] * a2 - m[11] * a0) * invDet;
+	t[12] = (-m[4] * b3 + m[5] * b1 - m[6] * b0) * invDet;
+	t[13] = ( m[0] * b3 - m[1] * b1 + m[2] * b0) * invDet;
+	t[14] = (-m[12] * a3 + m[13] * a1 - m[14] * a0) * invDet;
+	t[15] = ( m[8] * a3 - m[9] * a1 + m[10] * a0) * invDet;
+
+	for(int i = 0; i < 16; ++i)
+		result[i] = t[i];
+}
+#endif /* DROMEMATH_SSE */
+
+/*
+ * Calculates the rows of the inverse of the upper 3x3 of the column-major
+ * matrix m, which are the cross products of its columns (the columns of
+ * its cofactor matrix) divided by its determinant
+ */
+static void
+invertUpper3x3(const float *m, Vector3 rows[3])
+{
+	Vector3 c0(m[0], m[1], m[2]);
+	Vector3 c1(m[4], m[5], m[6]);
+	Vector3 c2(m[8], m[9], m[10]);
+
+	rows[0] = c1.crossProduct(c2);
+	rows[1] = c2.crossProduct(c0);
+	rows[2] = c0.crossProduct(c1);
+
+	float invDet = 1.0f / c0.dotProduct(rows[0]);
+	for(int i = 0; i < 3; ++i)
+		rows[i] *= invDet;
+}
+
+#ifndef DROMEMATH_SSE
+/*
+ * Writes the inverse of an affine matrix m to result, given the rows of
+ * the inverse of its upper 3x3; the inverse translation is the inverted
+ * upper 3x3 times -t
+ */
+static void
+setAffineInverse(const Vector3 rows[3], const float *m, float *result)
+{
+	Vector3 translation(m[12], m[13], m[14]);
+	float t[16];
+
+	for(int i = 0; i < 3; ++i) {
+		t[i] = rows[i].x;
+		t[4 + i] = rows[i].y;
+		t[8 + i] = rows[i].z;
+		t[12 + i] = -rows[i].dotProduct(translation);
+	}
+
+	t[3] = t[7] = t[11] = 0.0f;
+	t[15] = 1.0f;
+
+	for(int i = 0; i < 16; ++i)
+		result[i] = t[i];
+}
+
+static void
+invertAffineMatrix(const float *m, float *result)
+{
+	Vector3 rows[3];
+	invertUpper3x3(m, rows);
+	setAffineInverse(rows, m, result);
+}
+
+/*
+ * The inverse of a rotation is its transpose, so
+ * the rows of the inverse are the columns
+ */
+static void
+invertOrthonormalMatrix(const float *m, float *result)
+{
+	Vector3 rows[3];
+	for(int i = 0; i < 3; ++i)
+		rows[i] = Vector3(m[i * 4], m[i * 4 + 1], m[i * 4 + 2]);
+
+	setAffineInverse(rows, m, result);
+}
+#endif /* DROMEMATH_SSE */
+
+/*
+ * Vector array kernels. Each transforms vectors[first] up to vectors[end]
+ * by the upper 3x3 of the column-major matrix m, adds the translation t,
+ * and optionally normalizes the results. The results may be written
+ * over the vectors.
+ */
+static const float ZERO_TRANSLATION[3] = { 0.0f, 0.0f, 0.0f };
+
+// number of vectors transformed by each call on a ParallelRunner
+static const unsigned int PARALLEL_GRAIN_SIZE = 4096;
+
+static inline void
+transformVector(const float *m, const float *t, bool normalize, const Vector3 &vector, Vector3 &result)
+{
+	float x = vector.x, y = vector.y, z = vector.z;
+	float rx = m[0] * x + m[4] * y + m[8] * z + t[0];
+	float ry = m[1] * x + m[5] * y + m[9] * z + t[1];
+	float rz = m[2] * x + m[6] * y + m[10] * z + t[2];
+
+	if(normalize) {
+		float scale = 1.0f / sqrtf(rx * rx + ry * ry + rz * rz);
+		rx *= scale;
+		ry *= scale;
+		rz *= scale;
+	}
+
+	result.x = rx;
+	result.y = ry;
+	result.z = rz;
+}
+
+static void
+transformVectors(const float *m, const float *t, bool normalize,
+                 const Vector3 *vectors, Vector3 *results, unsigned int first, unsigned int end)
+{
+	unsigned int i = first;
+
+#if defined(DROMEMATH_SSE)
+	// transform four vectors at a time, with each register
+	// holding the same coordinate of all four vectors
+	if(end - first >= 4) {
+		__m128 m0 = _mm_set1_ps(m[0]), m4 = _mm_set1_ps(m[4]), m8 = _mm_set1_ps(m[8]), tx = _mm_set1_ps(t[0]);
+		__m128 m1 = _mm_set1_ps(m[1]), m5 = _mm_set1_ps(m[5]), m9 = _mm_set1_ps(m[9]), ty = _mm_set1_ps(t[1]);
+		__m128 m2 = _mm_set1_ps(m[2]), m6 = _mm_set1_ps(m[6]), m10 = _mm_set1_ps(m[10]), tz = _mm_set1_ps(t[2]);
+		__m128 one = _mm_set1_ps(1.0f);
+
+		for(; i + 4 <= end; i += 4) {
+			__m128 x, y, z;
+			loadVector3x4(vectors + i, x, y, z);
+
+			__m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)), tx);
+			__m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)), ty);
+			__m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)), tz);
+
+			if(normalize) {
+				__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz));
+				__m128 scale = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+				rx = _mm_mul_ps(rx, scale);
+				ry = _mm_mul_ps(ry, scale);
+				rz = _mm_mul_ps(rz, scale);
+			}
+
+			storeVector3x4(results + i, rx, ry, rz);
+		}
+	}
+#elif defined(DROMEMATH_NEON)
+	// transform four vectors at a time; the interleaved load and store
+	// put the same coordinate of all four vectors in each register
+	for(; i + 4 <= end; i += 4) {
+		float32x4x3_t v = vld3q_f32(&vectors[i].x);
+		float32x4x3_t r;
+		for(int j = 0; j < 3; ++j) {
+			r.val[j] = vmlaq_n_f32(vdupq_n_f32(t[j]), v.val[0], m[j]);
+			r.val[j] = vmlaq_n_f32(r.val[j], v.val[1], m[4 + j]);
+			r.val[j] = vmlaq_n_f32(r.val[j], v.val[2], m[8 + j]);
+		}
+		vst3q_f32(&results[i].x, r);
+
+		// NEON has no exact square root or division on all processors
+		if(normalize) {
+			for(unsigned int j = i; j < i + 4; ++j)
+				results[j] = results[j].normalize();
+		}
+	}
+#endif
+
+	for(; i < end; ++i)
+		transformVector(m, t, normalize, vectors[i], results[i]);
+}
+
+static void
+transformVectorsIndexed(const Matrix4 *matrices, const unsigned short *matrixIndices, bool translate, bool normalize,
+                        const Vector3 *vectors, Vector3 *results, unsigned int first, unsigned int end)
+{
+	for(unsigned int i = first; i < end; ++i) {
+		const float *m = matrices[matrixIndices[i]].getData();
+
+#if defined(DROMEMATH_SSE)
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(vectors[i].x));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(vectors[i].y)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(vectors[i].z)));
+		if(translate)
+			r = _mm_add_ps(r, _mm_loadu_ps(m + 12));
+
+		if(normalize) {
+			__m128 lengthSquared = _mm_mul_ps(r, r);
+			lengthSquared = _mm_add_ss(_mm_add_ss(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 1, 1, 1))),
+			                           _mm_movehl_ps(lengthSquared, lengthSquared));
+			__m128 scale = _mm_div_ss(_mm_set_ss(1.0f), _mm_sqrt_ss(lengthSquared));
+			r = _mm_mul_ps(r, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(0, 0, 0, 0)));
+		}
+
+		// store X and Y, then Z, since a Vector3 is only 12 bytes
+		_mm_storel_pi((__m64 *)&results[i].x, r);
+		_mm_store_ss(&results[i].z, _mm_movehl_ps(r, r));
+#else
+		transformVector(m, translate ? m + 12 : ZERO_TRANSLATION, normalize, vectors[i], results[i]);
+#endif
+	}
+}
+
+/*
+ * Arguments of a vector array transform, for splitting it into ranges
+ * that can be run on several threads
+ */
+class VectorTransformJob
+{
+	public:
+		const float *matrix;
+		const float *translation;
+		const Matrix4 *matrices;
+		const unsigned short *matrixIndices;
+		bool translate;
+		bool normalize;
+		const Vector3 *vectors;
+		Vector3 *results;
+};
+
+static void
+transformRange(void *data, unsigned int first, unsigned int end)
+{
+	const VectorTransformJob *job = (const VectorTransformJob *)data;
+
+	if(job->matrices != NULL)
+		transformVectorsIndexed(job->matrices, job->matrixIndices, job->translate, job->normalize, job->vectors, job->results, first, end);
+	else
+		transformVectors(job->matrix, job->translation, job->normalize, job->vectors, job->results, first, end);
+}
+
+static void
+runTransform(VectorTransformJob &job, unsigned int numVectors, ParallelRunner *runner)
+{
+	if(runner != NULL && numVectors > PARALLEL_GRAIN_SIZE)
+		runner->parallelFor(numVectors, PARALLEL_GRAIN_SIZE, transformRange, &job);
+	else
+		transformRange(&job, 0, numVectors);
+}
+
+static void
+runTransform(const float *matrix, const float *translation, bool normalize,
+             const Vector3 *vectors, Vector3 *results, unsigned int numVectors, ParallelRunner *runner)
+{
+	VectorTransformJob job;
+	job.matrix = matrix;
+	job.translation = translation;
+	job.matrices = NULL;
+	job.matrixIndices = NULL;
+	job.translate = true;
+	job.normalize = normalize;
+	job.vectors = vectors;
+	job.results = results;
+
+	runTransform(job, numVectors, runner);
+}
+
+static void
+runTransform(const Matrix4 *matrices, const unsigned short *matrixIndices, bool translate, bool normalize,
+             const Vector3 *vectors, Vector3 *results, unsigned int numVectors, ParallelRunner *runner)
+{
+	VectorTransformJob job;
+	job.matrix = NULL;
+	job.translation = NULL;
+	job.matrices = matrices;
+	job.matrixIndices = matrixIndices;
+	job.translate = translate;
+	job.normalize = normalize;
+	job.vectors = vectors;
+	job.results = results;
+
+	runTransform(job, numVectors, runner);
+}
+
 Matrix4::Matrix4()
 {
 	for(int i = 0; i < 4; ++i) {
@@ -45,99 +628,211 @@ Matrix4::Matrix4(const float matrix[16])
 		m_matrix[i] = matrix[i];
 }
 
-const float *
-Matrix4::getData() const
+bool
+Matrix4::operator == (const Matrix4 &matrix) const
 {
-	return m_matrix;
+	for(int i = 0; i < 16; ++i) {
+		if(m_matrix[i] != matrix.m_matrix[i])
+			return false;
+	}
+
+	return true;
 }
 
-float &
-Matrix4::operator [] (int i)
+bool
+Matrix4::operator != (const Matrix4 &matrix) const
 {
-	return m_matrix[i];
+	return !(*this == matrix);
 }
 
 Matrix4
 Matrix4::operator * (float scalar) const
 {
-	float m[16];
+	Matrix4 m(UNINITIALIZED);
 
 	for(int i = 0; i < 16; ++i)
-		m[i] = m_matrix[i] * scalar;
+		m.m_matrix[i] = m_matrix[i] * scalar;
 
-	return Matrix4(m);
+	return m;
 }
 
 Matrix4
 Matrix4::operator + (const Matrix4 &matrix) const
 {
-	float m[16];
+	Matrix4 m(UNINITIALIZED);
 
 	for(int i = 0; i < 16; ++i)
-		m[i] = m_matrix[i] + matrix.m_matrix[i];
+		m.m_matrix[i] = m_matrix[i] + matrix.m_matrix[i];
 
-	return Matrix4(m);
+	return m;
 }
 
 Matrix4
 Matrix4::operator - (const Matrix4 &matrix) const
 {
-	float m[16];
+	Matrix4 m(UNINITIALIZED);
 
 	for(int i = 0; i < 16; ++i)
-		m[i] = m_matrix[i] - matrix.m_matrix[i];
+		m.m_matrix[i] = m_matrix[i] - matrix.m_matrix[i];
 
-	return Matrix4(m);
+	return m;
 }
 
 Matrix4
 Matrix4::operator * (const Matrix4 &matrix) const
 {
-	const float *m1 = matrix.m_matrix;
-	const float *m2 = m_matrix;
-	float m[16];
+	Matrix4 m(UNINITIALIZED);
+	multiplyMatrices(m_matrix, matrix.m_matrix, m.m_matrix);
 
-	m[ 0] = m1[ 0]*m2[ 0] + m1[ 1]*m2[ 4] + m1[ 2]*m2[ 8] + m1[ 3]*m2[12];
-	m[ 1] = m1[ 0]*m2[ 1] + m1[ 1]*m2[ 5] + m1[ 2]*m2[ 9] + m1[ 3]*m2[13];
-	m[ 2] = m1[ 0]*m2[ 2] + m1[ 1]*m2[ 6] + m1[ 2]*m2[10] + m1[ 3]*m2[14];
-	m[ 3] = m1[ 0]*m2[ 3] + m1[ 1]*m2[ 7] + m1[ 2]*m2[11] + m1[ 3]*m2[15];
-	m[ 4] = m1[ 4]*m2[ 0] + m1[ 5]*m2[ 4] + m1[ 6]*m2[ 8] + m1[ 7]*m2[12];
-	m[ 5] = m1[ 4]*m2[ 1] + m1[ 5]*m2[ 5] + m1[ 6]*m2[ 9] + m1[ 7]*m2[13];
-	m[ 6] = m1[ 4]*m2[ 2] + m1[ 5]*m2[ 6] + m1[ 6]*m2[10] + m1[ 7]*m2[14];
-	m[ 7] = m1[ 4]*m2[ 3] + m1[ 5]*m2[ 7] + m1[ 6]*m2[11] + m1[ 7]*m2[15];
-	m[ 8] = m1[ 8]*m2[ 0] + m1[ 9]*m2[ 4] + m1[10]*m2[ 8] + m1[11]*m2[12];
-	m[ 9] = m1[ 8]*m2[ 1] + m1[ 9]*m2[ 5] + m1[10]*m2[ 9] + m1[11]*m2[13];
-	m[10] = m1[ 8]*m2[ 2] + m1[ 9]*m2[ 6] + m1[10]*m2[10] + m1[11]*m2[14];
-	m[11] = m1[ 8]*m2[ 3] + m1[ 9]*m2[ 7] + m1[10]*m2[11] + m1[11]*m2[15];
-	m[12] = m1[12]*m2[ 0] + m1[13]*m2[ 4] + m1[14]*m2[ 8] + m1[15]*m2[12];
-	m[13] = m1[12]*m2[ 1] + m1[13]*m2[ 5] + m1[14]*m2[ 9] + m1[15]*m2[13];
-	m[14] = m1[12]*m2[ 2] + m1[13]*m2[ 6] + m1[14]*m2[10] + m1[15]*m2[14];
-	m[15] = m1[12]*m2[ 3] + m1[13]*m2[ 7] + m1[14]*m2[11] + m1[15]*m2[15];
-
-	return Matrix4(m);
+	return m;
 }
 
 Vector3
 Matrix4::operator * (const Vector3 &vector) const
 {
-	float x = m_matrix[0]*vector.x + m_matrix[1]*vector.y + m_matrix[2]*vector.z + m_matrix[3];
-	float y = m_matrix[4]*vector.x + m_matrix[5]*vector.y + m_matrix[6]*vector.z + m_matrix[7];
-	float z = m_matrix[8]*vector.x + m_matrix[9]*vector.y + m_matrix[10]*vector.z + m_matrix[11];
+	Vector3 result;
+	transformPoints(&vector, &result, 1);
+
+	return result;
+}
 
-	return Vector3(x, y, z);
+Vector4
+Matrix4::operator * (const Vector4 &vector) const
+{
+	Vector4 result;
+
+#if defined(DROMEMATH_SSE)
+	__m128 r = transformSSE(_mm_loadu_ps(m_matrix), _mm_loadu_ps(m_matrix + 4),
+	                        _mm_loadu_ps(m_matrix + 8), _mm_loadu_ps(m_matrix + 12),
+	                        _mm_loadu_ps(&vector.x));
+	_mm_storeu_ps(&result.x, r);
+#elif defined(DROMEMATH_NEON)
+	float32x4_t r = transformNEON(vld1q_f32(m_matrix), vld1q_f32(m_matrix + 4),
+	                              vld1q_f32(m_matrix + 8), vld1q_f32(m_matrix + 12),
+	                              vld1q_f32(&vector.x));
+	vst1q_f32(&result.x, r);
+#else
+	const float *m = m_matrix;
+	result.x = m[0] * vector.x + m[4] * vector.y + m[8] * vector.z + m[12] * vector.w;
+	result.y = m[1] * vector.x + m[5] * vector.y + m[9] * vector.z + m[13] * vector.w;
+	result.z = m[2] * vector.x + m[6] * vector.y + m[10] * vector.z + m[14] * vector.w;
+	result.w = m[3] * vector.x + m[7] * vector.y + m[11] * vector.z + m[15] * vector.w;
+#endif
+
+	return result;
+}
+
+void
+Matrix4::transformPoints(const Vector3 *points, Vector3 *results, unsigned int numPoints,
+                         ParallelRunner *runner) const
+{
+	runTransform(m_matrix, m_matrix + 12, false, points, results, numPoints, runner);
+}
+
+void
+Matrix4::transformDirections(const Vector3 *directions, Vector3 *results, unsigned int numDirections,
+                             ParallelRunner *runner) const
+{
+	runTransform(m_matrix, ZERO_TRANSLATION, false, directions, results, numDirections, runner);
+}
+
+void
+Matrix4::transformNormals(const Vector3 *normals, Vector3 *results, unsigned int numNormals,
+                          ParallelRunner *runner) const
+{
+	Matrix4 m = normalMatrix();
+	runTransform(m.m_matrix, ZERO_TRANSLATION, true, normals, results, numNormals, runner);
+}
+
+void
+Matrix4::transformPoints(const Matrix4 *matrices, const unsigned short *matrixIndices,
+                         const Vector3 *points, Vector3 *results, unsigned int numPoints,
+                         ParallelRunner *runner)
+{
+	runTransform(matrices, matrixIndices, true, false, points, results, numPoints, runner);
+}
+
+void
+Matrix4::transformDirections(const Matrix4 *matrices, const unsigned short *matrixIndices,
+                             const Vector3 *directions, Vector3 *results, unsigned int numDirections,
+                             ParallelRunner *runner)
+{
+	runTransform(matrices, matrixIndices, false, false, directions, results, numDirections, runner);
+}
+
+void
+Matrix4::transformNormals(const Matrix4 *matrices, const unsigned short *matrixIndices,
+                          const Vector3 *normals, Vector3 *results, unsigned int numNormals,
+                          ParallelRunner *runner)
+{
+	// find the matrices that are used, so that each normal
+	// matrix is calculated once instead of once per normal
+	unsigned int numMatrices = 0;
+	for(unsigned int i = 0; i < numNormals; ++i) {
+		if(matrixIndices[i] >= numMatrices)
+			numMatrices = matrixIndices[i] + 1;
+	}
+	if(numMatrices == 0)
+		return;
+
+	vector <Matrix4> normalMatrices(numMatrices);
+	for(unsigned int i = 0; i < numMatrices; ++i)
+		normalMatrices[i] = matrices[i].normalMatrix();
+
+	runTransform(&normalMatrices[0], matrixIndices, false, true, normals, results, numNormals, runner);
 }
 
 Matrix4
-Matrix4::transpose() const
+Matrix4::normalMatrix() const
 {
-	float m[16];
+	// the inverse transpose has the rows of the inverse as its columns
+	Vector3 rows[3];
+	invertUpper3x3(m_matrix, rows);
 
-	for(int i = 0; i < 4; ++i) {
-		for(int j = 0; j < 4; ++j)
-			m[i*4+j] = m_matrix[j*4+i];
+	Matrix4 m;
+	for(int i = 0; i < 3; ++i) {
+		m.m_matrix[i * 4] = rows[i].x;
+		m.m_matrix[i * 4 + 1] = rows[i].y;
+		m.m_matrix[i * 4 + 2] = rows[i].z;
 	}
 
-	return Matrix4(m);
+	return m;
+}
+
+Matrix4
+Matrix4::transpose() const
+{
+	Matrix4 m(UNINITIALIZED);
+	transposeMatrix(m_matrix, m.m_matrix);
+
+	return m;
+}
+
+Matrix4
+Matrix4::inverse() const
+{
+	Matrix4 m(UNINITIALIZED);
+	invertMatrix(m_matrix, m.m_matrix);
+
+	return m;
+}
+
+Matrix4
+Matrix4::inverseAffine() const
+{
+	Matrix4 m(UNINITIALIZED);
+	invertAffineMatrix(m_matrix, m.m_matrix);
+
+	return m;
+}
+
+Matrix4
+Matrix4::inverseOrthonormal() const
+{
+	Matrix4 m(UNINITIALIZED);
+	invertOrthonormalMatrix(m_matrix, m.m_matrix);
+
+	return m;
 }
 
 Matrix4
@@ -277,4 +972,30 @@ Matrix4::rotation(float angle, const Vector3 &vector)
 	return m;
 }
 
+void
+Matrix4::multiply(const Matrix4 &matrix, const Matrix4 *matrices, Matrix4 *results, unsigned int numMatrices)
+{
+	for(unsigned int i = 0; i < numMatrices; ++i)
+		multiplyMatrices(matrix.m_matrix, matrices[i].m_matrix, results[i].m_matrix);
+}
+
+void
+Matrix4::multiply(const Matrix4 *matrices1, const Matrix4 *matrices2, Matrix4 *results, unsigned int numMatrices)
+{
+	for(unsigned int i = 0; i < numMatrices; ++i)
+		multiplyMatrices(matrices1[i].m_matrix, matrices2[i].m_matrix, results[i].m_matrix);
+}
+
+const char *
+Matrix4::getInstructionSetName()
+{
+#if defined(DROMEMATH_SSE)
+	return "SSE";
+#elif defined(DROMEMATH_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
 } // namespace DromeMath
@@ -82,6 +82,12 @@ PhysicsObject::getType() const
 	return PHYSICS_OBJECT_TYPE_POINT;
 }
 
+void
+PhysicsObject::getBounds(Vector3 &min, Vector3 &max) const
+{
+	min = max = m_position;
+}
+
 CollisionInfo
 PhysicsObject::collisionCheck(const PhysicsObject * /*object*/) const
 {
@@ -97,7 +103,18 @@ PhysicsObject::collisionCheck(const PhysicsObject &object) const
 void
 PhysicsObject::collisionResponse(const PhysicsObject *object)
 {
-	CollisionInfo info = collisionCheck(object);
+	collisionResponse(collisionCheck(object));
+}
+
+void
+PhysicsObject::collisionResponse(const PhysicsObject &object)
+{
+	collisionResponse(&object);
+}
+
+void
+PhysicsObject::collisionResponse(const CollisionInfo &info)
+{
 	if(info.collision) {
 	//	m_position = m_oldPosition;
 		m_position += info.direction * info.distance;
@@ -107,10 +124,4 @@ PhysicsObject::collisionResponse(const PhysicsObject *object)
 	}
 }
 
-void
-PhysicsObject::collisionResponse(const PhysicsObject &object)
-{
-	collisionResponse(&object);
-}
-
 } // namespace DromeMath
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <DromeMath/PhysicsWorld.h>
+
+using namespace std;
+
+namespace DromeMath {
+
+// number of bodies or pairs handled by each parallel range
+static const unsigned int PARALLEL_GRAIN_SIZE = 256;
+
+static inline float
+getAxis(const Vector3 &v, unsigned int axis)
+{
+	return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+// orders body indices by the minimum of their bounds along an axis
+class BoundsComparator
+{
+	private:
+		const Vector3 *m_min;
+		unsigned int m_axis;
+
+	public:
+		BoundsComparator(const Vector3 *minParam, unsigned int axisParam) { m_min = minParam; m_axis = axisParam; }
+
+		bool operator () (unsigned int a, unsigned int b) const
+		{
+			return getAxis(m_min[a], m_axis) < getAxis(m_min[b], m_axis);
+		}
+};
+
+PhysicsWorld::PhysicsWorld()
+{
+	m_gravity = STANDARD_GRAVITY;
+	m_sweepAxis = 0;
+	m_parallelRunner = NULL;
+	m_integrateTime = 0.0f;
+}
+
+void
+PhysicsWorld::clear()
+{
+	m_bodies.clear();
+	m_static.clear();
+	m_min.clear();
+	m_max.clear();
+	m_sortedBodies.clear();
+	m_pairs.clear();
+	m_pairInfo.clear();
+	m_contacts.clear();
+}
+
+unsigned int
+PhysicsWorld::addBody(PhysicsObject *body, bool isStatic)
+{
+	unsigned int index = (unsigned int)m_bodies.size();
+
+	m_bodies.push_back(body);
+	m_static.push_back(isStatic);
+	m_min.push_back(Vector3());
+	m_max.push_back(Vector3());
+	m_sortedBodies.push_back(index);
+
+	return index;
+}
+
+void
+PhysicsWorld::runParallel(unsigned int count, unsigned int grainSize, ParallelFunction function)
+{
+	if(m_parallelRunner != NULL && count > grainSize)
+		m_parallelRunner->parallelFor(count, grainSize, function, this);
+	else
+		function(this, 0, count);
+}
+
+void
+PhysicsWorld::integrateRange(void *data, unsigned int first, unsigned int end)
+{
+	PhysicsWorld *world = (PhysicsWorld *)data;
+
+	for(unsigned int i = first; i < end; ++i) {
+		if(!world->m_static[i])
+			world->m_bodies[i]->cycle(world->m_integrateTime, world->m_gravity);
+	}
+}
+
+void
+PhysicsWorld::integrate(float time)
+{
+	m_integrateTime = time;
+	runParallel((unsigned int)m_bodies.size(), PARALLEL_GRAIN_SIZE, integrateRange);
+}
+
+void
+PhysicsWorld::updateBoundsRange(void *data, unsigned int first, unsigned int end)
+{
+	PhysicsWorld *world = (PhysicsWorld *)data;
+
+	for(unsigned int i = first; i < end; ++i)
+		world->m_bodies[i]->getBounds(world->m_min[i], world->m_max[i]);
+}
+
+void
+PhysicsWorld::updateBounds()
+{
+	runParallel((unsigned int)m_bodies.size(), PARALLEL_GRAIN_SIZE, updateBoundsRange);
+}
+
+void
+PhysicsWorld::checkPairRange(void *data, unsigned int first, unsigned int end)
+{
+	PhysicsWorld *world = (PhysicsWorld *)data;
+
+	for(unsigned int i = first; i < end; ++i) {
+		unsigned int a = world->m_pairs[i * 2];
+		unsigned int b = world->m_pairs[i * 2 + 1];
+		world->m_pairInfo[i] = world->m_bodies[a]->collisionCheck(world->m_bodies[b]);
+	}
+}
+
+void
+PhysicsWorld::sortBodies()
+{
+	unsigned int numBodies = (unsigned int)m_bodies.size();
+	if(numBodies == 0)
+		return;
+
+	// sweep along the axis with the largest variance of
+	// body centers to get the fewest overlapping bounds
+	Vector3 sum, sumOfSquares;
+	for(unsigned int i = 0; i < numBodies; ++i) {
+		Vector3 center = (m_min[i] + m_max[i]) * 0.5f;
+		sum += center;
+		sumOfSquares += center * center;
+	}
+
+	Vector3 variance = sumOfSquares - (sum * sum) / (float)numBodies;
+	unsigned int axis = 0;
+	if(variance.y > variance.x)
+		axis = 1;
+	if(variance.z > getAxis(variance, axis))
+		axis = 2;
+
+	BoundsComparator comparator(&m_min[0], axis);
+	if(axis != m_sweepAxis) {
+		m_sweepAxis = axis;
+		std::sort(m_sortedBodies.begin(), m_sortedBodies.end(), comparator);
+		return;
+	}
+
+	// the order from the last step is usually nearly
+	// correct, so an insertion sort is close to linear
+	for(unsigned int i = 1; i < numBodies; ++i) {
+		unsigned int body = m_sortedBodies[i];
+		unsigned int j = i;
+		while(j > 0 && comparator(body, m_sortedBodies[j - 1])) {
+			m_sortedBodies[j] = m_sortedBodies[j - 1];
+			--j;
+		}
+		m_sortedBodies[j] = body;
+	}
+}
+
+void
+PhysicsWorld::detectCollisions()
+{
+	updateBounds();
+	sortBodies();
+
+	// find the pairs of bodies whose bounds overlap
+	m_pairs.clear();
+	unsigned int numBodies = (unsigned int)m_sortedBodies.size();
+	for(unsigned int i = 0; i < numBodies; ++i) {
+		unsigned int a = m_sortedBodies[i];
+		float max = getAxis(m_max[a], m_sweepAxis);
+
+		for(unsigned int j = i + 1; j < numBodies; ++j) {
+			unsigned int b = m_sortedBodies[j];
+			if(getAxis(m_min[b], m_sweepAxis) > max)
+				break;
+
+			if(m_static[a] && m_static[b])
+				continue;
+
+			if(m_min[a].x <= m_max[b].x && m_max[a].x >= m_min[b].x &&
+			   m_min[a].y <= m_max[b].y && m_max[a].y >= m_min[b].y &&
+			   m_min[a].z <= m_max[b].z && m_max[a].z >= m_min[b].z) {
+				// put the non-static body first
+				if(m_static[a]) {
+					m_pairs.push_back(b);
+					m_pairs.push_back(a);
+				} else {
+					m_pairs.push_back(a);
+					m_pairs.push_back(b);
+				}
+			}
+		}
+	}
+
+	// run the narrowphase on the candidate pairs
+	unsigned int numPairs = (unsigned int)m_pairs.size() / 2;
+	m_pairInfo.resize(numPairs, CollisionInfo(false));
+	runParallel(numPairs, PARALLEL_GRAIN_SIZE, checkPairRange);
+
+	// gather the contacts in pair order
+	m_contacts.clear();
+	for(unsigned int i = 0; i < numPairs; ++i) {
+		if(m_pairInfo[i].collision)
+			m_contacts.push_back(Contact(m_pairs[i * 2], m_pairs[i * 2 + 1], m_pairInfo[i]));
+	}
+}
+
+void
+PhysicsWorld::collide()
+{
+	detectCollisions();
+
+	for(unsigned int i = 0; i < m_contacts.size(); ++i) {
+		const Contact &contact = m_contacts[i];
+
+		// the first body of a contact is never static. it's moved
+		// out of the second body, which leaves the two touching, so
+		// the second body only has its velocity reflected
+		m_bodies[contact.body1]->collisionResponse(contact.info);
+		if(!m_static[contact.body2])
+			m_bodies[contact.body2]->collisionResponse(CollisionInfo(true, contact.info.direction * -1.0f, 0.0f));
+	}
+}
+
+void
+PhysicsWorld::step(float time)
+{
+	integrate(time);
+	collide();
+}
+
+} // namespace DromeMath
@@ -26,9 +26,73 @@
 #include <cmath>
 #include <DromeMath/Quaternion.h>
 #include <DromeMath/Util.h>
+#include "Simd.h"
 
 namespace DromeMath {
 
+// above this cosine of the angle between two rotations, slerp()
+// interpolates linearly, since sin(theta) is too small to divide by
+static const float SLERP_LINEAR_THRESHOLD = 0.9995f;
+
+/*
+ * Writes the matrix representation of q to the column-major array m
+ */
+static inline void
+setMatrix(const Quaternion &q, float *m)
+{
+	const Vector3 &v = q.v;
+	float w = q.w;
+
+	m[0] = 1.0f - (2.0f * v.y*v.y) - (2.0f * v.z*v.z);
+	m[1] = (2.0f * v.x * v.y) - (2.0f * v.z * w);
+	m[2] = (2.0f * v.x * v.z) + (2.0f * v.y * w);
+	m[3] = 0.0f;
+
+	m[4] = (2.0f * v.x * v.y) + (2.0f * v.z * w);
+	m[5] = 1.0f - (2.0f * v.x*v.x) - (2.0f * v.z*v.z);
+	m[6] = (2.0f * v.y * v.z) - (2.0f * v.x * w);
+	m[7] = 0.0f;
+
+	m[8] = (2.0f * v.x * v.z) - (2.0f * v.y * w);
+	m[9] = (2.0f * v.y * v.z) + (2.0f * v.x * w);
+	m[10] = 1.0f - (2.0f * v.x*v.x) - (2.0f * v.y*v.y);
+	m[11] = 0.0f;
+
+	m[12] = 0.0f;
+	m[13] = 0.0f;
+	m[14] = 0.0f;
+	m[15] = 1.0f;
+}
+
+/*
+ * Calculates the weights of from and to for interpolating spherically
+ * between them; returns true if the weights are linear and the result
+ * must be normalized
+ */
+static inline bool
+getSlerpWeights(float cosTheta, float t, float &fromWeight, float &toWeight)
+{
+	// negating a quaternion gives the same rotation, so
+	// interpolate towards whichever of to and -to is closer
+	float sign = 1.0f;
+	if(cosTheta < 0.0f) {
+		cosTheta = -cosTheta;
+		sign = -1.0f;
+	}
+
+	if(cosTheta > SLERP_LINEAR_THRESHOLD) {
+		fromWeight = 1.0f - t;
+		toWeight = t * sign;
+		return true;
+	}
+
+	float theta = acosf(cosTheta);
+	float invSinTheta = 1.0f / sqrtf(1.0f - cosTheta * cosTheta);
+	fromWeight = sinf((1.0f - t) * theta) * invSinTheta;
+	toWeight = sinf(t * theta) * invSinTheta * sign;
+	return false;
+}
+
 Quaternion
 Quaternion::normalize() const
 {
@@ -46,29 +110,17 @@ Quaternion::conjugate() const
 Matrix4
 Quaternion::toMatrix4() const
 {
-	Matrix4 tmp;
-
-	tmp[0] = 1.0f - (2.0f * v.y*v.y) - (2.0f * v.z*v.z);
-	tmp[1] = (2.0f * v.x * v.y) + (2.0f * v.z * w);
-	tmp[2] = (2.0f * v.x * v.z) - (2.0f * v.y * w);
-	tmp[3] = 0.0f;
-
-	tmp[4] = (2.0f * v.x * v.y) - (2.0f * v.z * w);
-	tmp[5] = 1.0f - (2.0f * v.x*v.x) - (2.0f * v.z*v.z);
-	tmp[6] = (2.0f * v.y * v.z) + (2.0f * v.x * w);
-	tmp[7] = 0.0f;
+	Matrix4 m;
+	setMatrix(*this, &m[0]);
 
-	tmp[8] = (2.0f * v.x * v.z) + (2.0f * v.y * w);
-	tmp[9] = (2.0f * v.y * v.z) - (2.0f * v.x * w);
-	tmp[10] = 1.0f - (2.0f * v.x*v.x) - (2.0f * v.y*v.y);
-	tmp[11] = 0.0f;
-
-	tmp[12] = 0.0f;
-	tmp[13] = 0.0f;
-	tmp[14] = 0.0f;
-	tmp[15] = 1.0f;
+	return m;
+}
 
-	return tmp.transpose();
+void
+Quaternion::rotate(const Vector3 *vectors, Vector3 *results, unsigned int numVectors) const
+{
+	// the conjugate's matrix rotates by this quaternion
+	conjugate().toMatrix4().transformDirections(vectors, results, numVectors);
 }
 
 Quaternion
@@ -103,4 +155,225 @@ Quaternion::fromRotation(const Vector3 &rotation)
 	return (q1 * q2) * q3;
 }
 
+Quaternion
+Quaternion::nlerp(const Quaternion &from, const Quaternion &to, float t)
+{
+	// negating a quaternion gives the same rotation, so
+	// interpolate towards whichever of to and -to is closer
+	float sign = (from.dotProduct(to) < 0.0f) ? -1.0f : 1.0f;
+
+	return Quaternion(from.v + (to.v * sign - from.v) * t,
+	                  from.w + (to.w * sign - from.w) * t).normalize();
+}
+
+Quaternion
+Quaternion::slerp(const Quaternion &from, const Quaternion &to, float t)
+{
+	float fromWeight, toWeight;
+	bool isLinear = getSlerpWeights(from.dotProduct(to), t, fromWeight, toWeight);
+
+	Quaternion q(from.v * fromWeight + to.v * toWeight, from.w * fromWeight + to.w * toWeight);
+	return isLinear ? q.normalize() : q;
+}
+
+/*
+ * The batch operations below work on four quaternions at a time, with
+ * each register holding the same component of all four (structure of
+ * arrays); the quaternions are transposed into that form after loading
+ * and back before storing.
+ */
+#if defined(DROMEMATH_SSE)
+static inline void
+loadQuaternions(const Quaternion *q, __m128 &x, __m128 &y, __m128 &z, __m128 &w)
+{
+	x = _mm_loadu_ps(&q[0].v.x);
+	y = _mm_loadu_ps(&q[1].v.x);
+	z = _mm_loadu_ps(&q[2].v.x);
+	w = _mm_loadu_ps(&q[3].v.x);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+static inline void
+storeQuaternions(Quaternion *q, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(&q[0].v.x, x);
+	_mm_storeu_ps(&q[1].v.x, y);
+	_mm_storeu_ps(&q[2].v.x, z);
+	_mm_storeu_ps(&q[3].v.x, w);
+}
+
+static inline __m128
+dotProductSSE(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw)
+{
+	__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+	return _mm_add_ps(d, _mm_mul_ps(aw, bw));
+}
+
+// multiplies x, y, z and w by 1 / their length, or by 1 where mask is clear
+static inline void
+normalizeSSE(__m128 &x, __m128 &y, __m128 &z, __m128 &w, __m128 mask)
+{
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_div_ps(one, _mm_sqrt_ps(dotProductSSE(x, y, z, w, x, y, z, w)));
+	scale = _mm_or_ps(_mm_and_ps(mask, scale), _mm_andnot_ps(mask, one));
+
+	x = _mm_mul_ps(x, scale);
+	y = _mm_mul_ps(y, scale);
+	z = _mm_mul_ps(z, scale);
+	w = _mm_mul_ps(w, scale);
+}
+#endif /* DROMEMATH_SSE */
+
+void
+Quaternion::nlerp(const Quaternion *from, const Quaternion *to, float t, Quaternion *results, unsigned int numQuaternions)
+{
+	unsigned int i = 0;
+
+#if defined(DROMEMATH_SSE)
+	__m128 vt = _mm_set1_ps(t);
+	__m128 zero = _mm_setzero_ps();
+	__m128 signBit = _mm_set1_ps(-0.0f);
+	__m128 all = _mm_cmpeq_ps(zero, zero);
+
+	for(; i + 4 <= numQuaternions; i += 4) {
+		__m128 ax, ay, az, aw, bx, by, bz, bw;
+		loadQuaternions(from + i, ax, ay, az, aw);
+		loadQuaternions(to + i, bx, by, bz, bw);
+
+		// flip the signs of the quaternions of to that are further than their negations
+		__m128 sign = _mm_and_ps(_mm_cmplt_ps(dotProductSSE(ax, ay, az, aw, bx, by, bz, bw), zero), signBit);
+		bx = _mm_xor_ps(bx, sign);
+		by = _mm_xor_ps(by, sign);
+		bz = _mm_xor_ps(bz, sign);
+		bw = _mm_xor_ps(bw, sign);
+
+		__m128 rx = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), vt));
+		__m128 ry = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), vt));
+		__m128 rz = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), vt));
+		__m128 rw = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), vt));
+		normalizeSSE(rx, ry, rz, rw, all);
+
+		storeQuaternions(results + i, rx, ry, rz, rw);
+	}
+#endif
+
+	for(; i < numQuaternions; ++i)
+		results[i] = nlerp(from[i], to[i], t);
+}
+
+void
+Quaternion::slerp(const Quaternion *from, const Quaternion *to, float t, Quaternion *results, unsigned int numQuaternions)
+{
+	unsigned int i = 0;
+
+#if defined(DROMEMATH_SSE)
+	for(; i + 4 <= numQuaternions; i += 4) {
+		__m128 ax, ay, az, aw, bx, by, bz, bw;
+		loadQuaternions(from + i, ax, ay, az, aw);
+		loadQuaternions(to + i, bx, by, bz, bw);
+
+		// there are no SSE instructions for the trigonometric
+		// functions, so the weights are calculated separately
+		DROMEMATH_ALIGN(16) float cosTheta[4], fromWeights[4], toWeights[4], isLinear[4];
+		_mm_store_ps(cosTheta, dotProductSSE(ax, ay, az, aw, bx, by, bz, bw));
+		for(int j = 0; j < 4; ++j)
+			isLinear[j] = getSlerpWeights(cosTheta[j], t, fromWeights[j], toWeights[j]) ? 1.0f : 0.0f;
+
+		__m128 fromWeight = _mm_load_ps(fromWeights);
+		__m128 toWeight = _mm_load_ps(toWeights);
+		__m128 rx = _mm_add_ps(_mm_mul_ps(ax, fromWeight), _mm_mul_ps(bx, toWeight));
+		__m128 ry = _mm_add_ps(_mm_mul_ps(ay, fromWeight), _mm_mul_ps(by, toWeight));
+		__m128 rz = _mm_add_ps(_mm_mul_ps(az, fromWeight), _mm_mul_ps(bz, toWeight));
+		__m128 rw = _mm_add_ps(_mm_mul_ps(aw, fromWeight), _mm_mul_ps(bw, toWeight));
+		normalizeSSE(rx, ry, rz, rw, _mm_cmpneq_ps(_mm_load_ps(isLinear), _mm_setzero_ps()));
+
+		storeQuaternions(results + i, rx, ry, rz, rw);
+	}
+#endif
+
+	for(; i < numQuaternions; ++i)
+		results[i] = slerp(from[i], to[i], t);
+}
+
+void
+Quaternion::rotate(const Quaternion *rotations, const Vector3 *vectors, Vector3 *results, unsigned int numVectors)
+{
+	unsigned int i = 0;
+
+#if defined(DROMEMATH_SSE)
+	__m128 two = _mm_set1_ps(2.0f);
+
+	for(; i + 4 <= numVectors; i += 4) {
+		__m128 qx, qy, qz, qw, x, y, z;
+		loadQuaternions(rotations + i, qx, qy, qz, qw);
+		loadVector3x4(vectors + i, x, y, z);
+
+		// t = 2 * (q.v x v), result = v + t * q.w + q.v x t
+		__m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qy, z), _mm_mul_ps(qz, y)), two);
+		__m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qz, x), _mm_mul_ps(qx, z)), two);
+		__m128 tz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qx, y), _mm_mul_ps(qy, x)), two);
+		x = _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(tx, qw)), _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(qz, ty)));
+		y = _mm_add_ps(_mm_add_ps(y, _mm_mul_ps(ty, qw)), _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz)));
+		z = _mm_add_ps(_mm_add_ps(z, _mm_mul_ps(tz, qw)), _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx)));
+
+		storeVector3x4(results + i, x, y, z);
+	}
+#endif
+
+	for(; i < numVectors; ++i)
+		results[i] = rotations[i].rotate(vectors[i]);
+}
+
+void
+Quaternion::toMatrix4(const Quaternion *quaternions, Matrix4 *results, unsigned int numQuaternions)
+{
+	unsigned int i = 0;
+
+#if defined(DROMEMATH_SSE)
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 two = _mm_set1_ps(2.0f);
+	__m128 lastColumn = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+	for(; i + 4 <= numQuaternions; i += 4) {
+		__m128 x, y, z, w;
+		loadQuaternions(quaternions + i, x, y, z, w);
+
+		__m128 x2 = _mm_mul_ps(two, x), y2 = _mm_mul_ps(two, y), z2 = _mm_mul_ps(two, z);
+		__m128 xx = _mm_mul_ps(x2, x), yy = _mm_mul_ps(y2, y), zz = _mm_mul_ps(z2, z);
+		__m128 xy = _mm_mul_ps(x2, y), xz = _mm_mul_ps(x2, z), yz = _mm_mul_ps(y2, z);
+		__m128 xw = _mm_mul_ps(x2, w), yw = _mm_mul_ps(y2, w), zw = _mm_mul_ps(z2, w);
+
+		// the same element of all four matrices, one column at a
+		// time, which are transposed into the columns of each matrix
+		__m128 columns[3][4];
+		columns[0][0] = _mm_sub_ps(_mm_sub_ps(one, yy), zz);
+		columns[0][1] = _mm_sub_ps(xy, zw);
+		columns[0][2] = _mm_add_ps(xz, yw);
+		columns[1][0] = _mm_add_ps(xy, zw);
+		columns[1][1] = _mm_sub_ps(_mm_sub_ps(one, xx), zz);
+		columns[1][2] = _mm_sub_ps(yz, xw);
+		columns[2][0] = _mm_sub_ps(xz, yw);
+		columns[2][1] = _mm_add_ps(yz, xw);
+		columns[2][2] = _mm_sub_ps(_mm_sub_ps(one, xx), yy);
+
+		for(int j = 0; j < 3; ++j) {
+			columns[j][3] = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(columns[j][0], columns[j][1], columns[j][2], columns[j][3]);
+		}
+
+		for(int k = 0; k < 4; ++k) {
+			float *m = &results[i + k][0];
+			_mm_storeu_ps(m, columns[0][k]);
+			_mm_storeu_ps(m + 4, columns[1][k]);
+			_mm_storeu_ps(m + 8, columns[2][k]);
+			_mm_storeu_ps(m + 12, lastColumn);
+		}
+	}
+#endif
+
+	for(; i < numQuaternions; ++i)
+		setMatrix(quaternions[i], &results[i][0]);
+}
+
 } // namespace DromeMath
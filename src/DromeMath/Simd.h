@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DROMEMATH_SIMD_H__
+#define __DROMEMATH_SIMD_H__
+
+/*
+ * Selects the SIMD instruction set used by the math classes, which is
+ * the one the compiler targets; SSE is always available on x86-64.
+ */
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define DROMEMATH_SSE
+#include <xmmintrin.h>
+#include <DromeMath/Vector3.h>
+
+namespace DromeMath {
+
+/*
+ * Loads four consecutive Vector3s so that x, y and z each hold the same
+ * coordinate of all four. A Vector3 is only 12 bytes, so the first three
+ * loads also read the next vector's X, and the last vector is loaded
+ * without reading past it.
+ */
+static inline void
+loadVector3x4(const Vector3 *vectors, __m128 &x, __m128 &y, __m128 &z)
+{
+	x = _mm_loadu_ps(&vectors[0].x);
+	y = _mm_loadu_ps(&vectors[1].x);
+	z = _mm_loadu_ps(&vectors[2].x);
+	__m128 w = _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)&vectors[3].x),
+	                         _mm_load_ss(&vectors[3].z));
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+/*
+ * Stores four consecutive Vector3s from registers holding the same
+ * coordinate of all four. Each of the first three stores writes a value
+ * that the next store replaces, and the last vector is stored without
+ * writing past it.
+ */
+static inline void
+storeVector3x4(Vector3 *vectors, __m128 x, __m128 y, __m128 z)
+{
+	__m128 w = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(&vectors[0].x, x);
+	_mm_storeu_ps(&vectors[1].x, y);
+	_mm_storeu_ps(&vectors[2].x, z);
+	_mm_storel_pi((__m64 *)&vectors[3].x, w);
+	_mm_store_ss(&vectors[3].z, _mm_movehl_ps(w, w));
+}
+
+} // namespace DromeMath
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DROMEMATH_NEON
+#include <arm_neon.h>
+#endif
+
+#endif /* __DROMEMATH_SIMD_H__ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <DromeMath/Transform.h>
+
+namespace DromeMath {
+
+Transform::Transform(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale)
+{
+	m_translation = translation;
+	m_rotation = rotation;
+	m_scale = scale;
+	m_isMatrixValid = false;
+}
+
+void
+Transform::updateMatrix() const
+{
+	const Vector3 &v = m_rotation.v;
+	float w = m_rotation.w;
+
+	// the columns of the rotation matrix, each multiplied by the scale on its axis
+	m_matrix[0] = (1.0f - 2.0f * (v.y * v.y + v.z * v.z)) * m_scale.x;
+	m_matrix[1] = (2.0f * (v.x * v.y + v.z * w)) * m_scale.x;
+	m_matrix[2] = (2.0f * (v.x * v.z - v.y * w)) * m_scale.x;
+	m_matrix[3] = 0.0f;
+
+	m_matrix[4] = (2.0f * (v.x * v.y - v.z * w)) * m_scale.y;
+	m_matrix[5] = (1.0f - 2.0f * (v.x * v.x + v.z * v.z)) * m_scale.y;
+	m_matrix[6] = (2.0f * (v.y * v.z + v.x * w)) * m_scale.y;
+	m_matrix[7] = 0.0f;
+
+	m_matrix[8] = (2.0f * (v.x * v.z + v.y * w)) * m_scale.z;
+	m_matrix[9] = (2.0f * (v.y * v.z - v.x * w)) * m_scale.z;
+	m_matrix[10] = (1.0f - 2.0f * (v.x * v.x + v.y * v.y)) * m_scale.z;
+	m_matrix[11] = 0.0f;
+
+	m_matrix[12] = m_translation.x;
+	m_matrix[13] = m_translation.y;
+	m_matrix[14] = m_translation.z;
+	m_matrix[15] = 1.0f;
+
+	m_isMatrixValid = true;
+}
+
+Matrix4
+Transform::getInverseMatrix() const
+{
+	// the inverse scales, rotates and translates by the inverse of each, in the
+	// opposite order; the rows of the inverse rotation are the columns of the rotation
+	const Vector3 &v = m_rotation.v;
+	float w = m_rotation.w;
+	Vector3 invScale(1.0f / m_scale.x, 1.0f / m_scale.y, 1.0f / m_scale.z);
+	Vector3 rows[3];
+	rows[0] = Vector3(1.0f - 2.0f * (v.y * v.y + v.z * v.z), 2.0f * (v.x * v.y + v.z * w), 2.0f * (v.x * v.z - v.y * w)) * invScale.x;
+	rows[1] = Vector3(2.0f * (v.x * v.y - v.z * w), 1.0f - 2.0f * (v.x * v.x + v.z * v.z), 2.0f * (v.y * v.z + v.x * w)) * invScale.y;
+	rows[2] = Vector3(2.0f * (v.x * v.z + v.y * w), 2.0f * (v.y * v.z - v.x * w), 1.0f - 2.0f * (v.x * v.x + v.y * v.y)) * invScale.z;
+
+	Matrix4 m;
+	for(int i = 0; i < 3; ++i) {
+		m[i] = rows[i].x;
+		m[4 + i] = rows[i].y;
+		m[8 + i] = rows[i].z;
+		m[12 + i] = -rows[i].dotProduct(m_translation);
+	}
+
+	return m;
+}
+
+Transform
+Transform::operator * (const Transform &transform) const
+{
+	return Transform(transformPoint(transform.m_translation),
+	                 m_rotation * transform.m_rotation,
+	                 m_scale * transform.m_scale);
+}
+
+Transform
+Transform::inverse() const
+{
+	Quaternion rotation = m_rotation.conjugate();
+	Vector3 scale(1.0f / m_scale.x, 1.0f / m_scale.y, 1.0f / m_scale.z);
+	Vector3 translation = rotation.rotate(m_translation * -1.0f) * scale;
+
+	return Transform(translation, rotation, scale);
+}
+
+Vector3
+Transform::transformPoint(const Vector3 &point) const
+{
+	return m_rotation.rotate(point * m_scale) + m_translation;
+}
+
+Vector3
+Transform::transformDirection(const Vector3 &direction) const
+{
+	return m_rotation.rotate(direction * m_scale);
+}
+
+} // namespace DromeMath
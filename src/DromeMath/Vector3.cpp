@@ -24,20 +24,12 @@
  */
 
 #include <DromeMath/Vector3.h>
-#include <cmath>
 #include <sstream>
 
 using namespace std;
 
 namespace DromeMath {
 
-Vector3::Vector3(float x_param, float y_param, float z_param)
-{
-	x = x_param;
-	y = y_param;
-	z = z_param;
-}
-
 Vector3::Vector3(const char *s)
 {
 	stringstream stream(s);
@@ -50,131 +42,6 @@ Vector3::Vector3(const string &s)
 	stream >> x >> y >> z;
 }
 
-float
-Vector3::dotProduct(const Vector3 &v) const
-{
-	return x * v.x + y * v.y + z * v.z;
-}
-
-float
-Vector3::length() const
-{
-	return sqrtf(dotProduct(*this));
-}
-
-Vector3
-Vector3::crossProduct(const Vector3 &v) const
-{
-	return Vector3(y * v.z - z * v.y,
-	               z * v.x - x * v.z,
-	               x * v.y - y * v.x);
-}
-
-Vector3
-Vector3::normalize() const
-{
-	float scale = 1.0f / sqrtf(x*x + y*y + z*z);
-	return Vector3(x * scale, y * scale, z * scale);
-}
-
-Vector3
-Vector3::operator + (const Vector3 &v) const
-{
-	return Vector3(x + v.x, y + v.y, z + v.z);
-}
-
-Vector3
-Vector3::operator + (float f) const
-{
-	return Vector3(x + f, y + f, z + f);
-}
-
-void
-Vector3::operator += (const Vector3 &v)
-{
-	x += v.x;
-	y += v.y;
-	z += v.z;
-}
-
-void
-Vector3::operator += (float f)
-{
-	x += f;
-	y += f;
-	z += f;
-}
-
-Vector3
-Vector3::operator - (const Vector3 &v) const
-{
-	return Vector3(x - v.x, y - v.y, z - v.z);
-}
-
-Vector3
-Vector3::operator - (float f) const
-{
-	return Vector3(x - f, y - f, z - f);
-}
-
-void
-Vector3::operator -= (const Vector3 &v)
-{
-	x -= v.x;
-	y -= v.y;
-	z -= v.z;
-}
-
-void
-Vector3::operator -= (float f)
-{
-	x -= f;
-	y -= f;
-	z -= f;
-}
-
-Vector3
-Vector3::operator * (const Vector3 &v) const
-{
-	return Vector3(x * v.x, y * v.y, z * v.z);
-}
-
-Vector3
-Vector3::operator * (float f) const
-{
-	return Vector3(x * f, y * f, z * f);
-}
-
-void
-Vector3::operator *= (const Vector3 &v)
-{
-	x *= v.x;
-	y *= v.y;
-	z *= v.z;
-}
-
-void
-Vector3::operator *= (float f)
-{
-	x *= f;
-	y *= f;
-	z *= f;
-}
-
-Vector3
-Vector3::operator / (float f) const
-{
-	return Vector3(x / f, y / f, z / f);
-}
-
-void
-Vector3::operator /= (float f)
-{
-	x /= f;
-	y /= f;
-	z /= f;
-}
-
 string
 Vector3::toString() const
 {
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <vector>
+#include <DromeCore/DromeCore>
+#include <DromeGfx/DromeGfx>
+#include <DromeGfx/DriverRecorder.h>
+#include <DromeMath/DromeMath>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeGfx;
+using namespace DromeMath;
+
+static const unsigned int GRID_SIZE = 24;
+static const unsigned int NUM_TEXTURES = 4;
+static const unsigned int NUM_LIGHTS = 3;
+static const unsigned int NUM_FRAMES = 2000;
+
+/*
+ * a grid of textured blocks with a few lights circling above it,
+ * laid out like the scene used by MyScene1
+ */
+class BenchScene
+{
+	public:
+		RefPtr <SceneGraph> sceneGraph;
+		RefPtr <RenderQueue> renderQueue;
+		RefPtr <SphereMesh> sphere;
+		RefPtr <Texture> textures[NUM_TEXTURES];
+		RefPtr <Texture> normalmap;
+		RefPtr <Texture> lightTextures[NUM_LIGHTS];
+		RefPtr <Mesh> blockMeshes[NUM_TEXTURES];
+
+		// the mesh and texture of each block node
+		vector <unsigned int> blockNodes;
+		vector <unsigned int> blockTextures;
+		vector <unsigned int> visibleNodes;
+
+		unsigned int lightsNode;
+		unsigned int lightNodes[NUM_LIGHTS];
+
+		Camera camera;
+		float rotation;
+
+		BenchScene();
+
+		void cycle(float secondsElapsed);
+		void renderDirect(GfxDriver *driver);
+		void renderQueued(GfxDriver *driver);
+};
+
+BenchScene::BenchScene()
+{
+	sceneGraph = SceneGraph::create();
+	renderQueue = RenderQueue::create();
+	sphere = SphereMesh::create(10, 0.1f);
+	rotation = 0.0f;
+
+	for(unsigned int i = 0; i < NUM_TEXTURES; ++i) {
+		RefPtr <Image> image = Image::create(64, 64, 3);
+		textures[i] = Texture::create(image);
+		blockMeshes[i] = CubeMesh::create(Vector3(0.5f, 0.5f, 0.5f + (float)i * 0.25f));
+	}
+	normalmap = Texture::create(Image::create(64, 64, 3));
+
+	lightsNode = sceneGraph->addNode(Transform());
+	for(unsigned int i = 0; i < NUM_LIGHTS; ++i) {
+		float r = (float)i * ((M_PI * 2.0f) / (float)NUM_LIGHTS);
+		lightNodes[i] = sceneGraph->addNode(Transform(Vector3(cosf(r), sinf(r), 2.0f) * 7.5f), lightsNode);
+		lightTextures[i] = Texture::create(Image::create(1, 1, 3));
+	}
+
+	unsigned int levelNode = sceneGraph->addNode(Transform());
+	for(unsigned int y = 0; y < GRID_SIZE; ++y) {
+		for(unsigned int x = 0; x < GRID_SIZE; ++x) {
+			Vector3 position(((float)x - (float)GRID_SIZE / 2.0f) * 1.5f, ((float)y - (float)GRID_SIZE / 2.0f) * 1.5f, 0.0f);
+			unsigned int texture = (x * 7 + y * 3) % NUM_TEXTURES;
+			Vector3 bounds(0.5f, 0.5f, 0.5f + (float)texture * 0.25f);
+
+			unsigned int node = sceneGraph->addNode(Transform(position), levelNode);
+			sceneGraph->setBounds(node, bounds * -1.0f, bounds);
+			blockNodes.push_back(node);
+			blockTextures.push_back(texture);
+		}
+	}
+}
+
+void
+BenchScene::cycle(float secondsElapsed)
+{
+	rotation += (M_PI / 8.0f) * secondsElapsed;
+	sceneGraph->setTransform(lightsNode, Transform(Vector3(), Quaternion::fromAxis(Vector3(0.0f, 0.0f, 1.0f), rotation * 2.0f)));
+
+	camera.setPosition((Vector3(cosf(rotation), sinf(rotation)) * 12.0f) + Vector3(0.0f, 0.0f, 6.0f));
+	camera.lookAt(Vector3(0.0f, 0.0f, -2.0f));
+	camera.update();
+}
+
+/*
+ * binds the state of each visible block and draws it
+ * in scene graph order, the way MyScene1 draws with shaders
+ */
+void
+BenchScene::renderDirect(GfxDriver *driver)
+{
+	sceneGraph->update();
+	visibleNodes.clear();
+	sceneGraph->query(camera.getFrustum(driver->getProjectionMatrix()), visibleNodes);
+
+	driver->clearBuffers();
+	driver->setCullFace(CULL_FACE_BACK);
+	for(unsigned int i = 0; i < visibleNodes.size(); ++i) {
+		unsigned int node = visibleNodes[i];
+		if(node < blockNodes[0])
+			continue;
+
+		unsigned int texture = blockTextures[node - blockNodes[0]];
+		driver->setModelViewMatrix(camera.getMatrix() * sceneGraph->getWorldMatrix(node));
+		driver->bindTexture(0, textures[texture]);
+		driver->bindTexture(1, normalmap);
+		blockMeshes[texture]->render(driver);
+	}
+	driver->bindTexture(1, Texture::none());
+
+	for(unsigned int i = 0; i < NUM_LIGHTS; ++i) {
+		driver->setModelViewMatrix(camera.getMatrix() * sceneGraph->getWorldMatrix(lightNodes[i]));
+		driver->bindTexture(lightTextures[i]);
+		sphere->render(driver);
+	}
+
+	driver->flush();
+}
+
+/*
+ * submits the visible blocks through a RenderQueue,
+ * the way MyScene1 draws without shaders
+ */
+void
+BenchScene::renderQueued(GfxDriver *driver)
+{
+	sceneGraph->update();
+	visibleNodes.clear();
+	sceneGraph->query(camera.getFrustum(driver->getProjectionMatrix()), visibleNodes);
+
+	driver->clearBuffers();
+	driver->setCullFace(CULL_FACE_BACK);
+	renderQueue->clear();
+	for(unsigned int i = 0; i < visibleNodes.size(); ++i) {
+		unsigned int node = visibleNodes[i];
+		if(node < blockNodes[0])
+			continue;
+
+		unsigned int texture = blockTextures[node - blockNodes[0]];
+		const Matrix4 &transform = sceneGraph->getWorldMatrix(node);
+
+		RenderItem item;
+		item.mesh = blockMeshes[texture];
+		item.textures[0] = textures[texture];
+		item.textures[1] = normalmap;
+		item.transform = transform;
+		item.depth = (Vector3(transform[12], transform[13], transform[14]) - camera.getPosition()).length();
+		renderQueue->add(item);
+	}
+	for(unsigned int i = 0; i < NUM_LIGHTS; ++i) {
+		const Matrix4 &transform = sceneGraph->getWorldMatrix(lightNodes[i]);
+
+		RenderItem item;
+		item.mesh = sphere;
+		item.textures[0] = lightTextures[i];
+		item.transform = transform;
+		item.depth = (Vector3(transform[12], transform[13], transform[14]) - camera.getPosition()).length();
+		renderQueue->add(item);
+	}
+	renderQueue->execute(driver, camera.getMatrix());
+
+	driver->flush();
+}
+
+class BenchResult
+{
+	public:
+		uint64_t nanoseconds;
+		unsigned int numCommands;
+		unsigned int numRedundantCommands;
+		unsigned int numStateChanges;
+		unsigned int numDraws;
+
+		BenchResult()
+		{
+			nanoseconds = 0;
+			numCommands = numRedundantCommands = numStateChanges = numDraws = 0;
+		}
+};
+
+static BenchResult
+benchmark(BenchScene &scene, GfxDriverRecorder &recorder, bool queued)
+{
+	BenchResult result;
+
+	for(unsigned int i = 0; i < NUM_FRAMES; ++i) {
+		scene.cycle(1.0f / 60.0f);
+
+		// the time includes culling and recording the commands
+		uint64_t start = getNanoseconds();
+		if(queued)
+			scene.renderQueued(&recorder);
+		else
+			scene.renderDirect(&recorder);
+		result.nanoseconds += getNanoseconds() - start;
+
+		unsigned int numDraws = recorder.getNumCommands(GFX_COMMAND_DRAW_MESH) + recorder.getNumCommands(GFX_COMMAND_DRAW_MESH_INSTANCED);
+		result.numCommands += recorder.getNumCommands();
+		result.numRedundantCommands += recorder.getNumRedundantCommands();
+		result.numDraws += numDraws;
+		result.numStateChanges += recorder.getNumCommands() - numDraws - recorder.getNumFrames();
+		recorder.clear();
+	}
+
+	return result;
+}
+
+static void
+printResult(const char *name, const BenchResult &result)
+{
+	double frames = (double)NUM_FRAMES;
+	printf("%-14s %8.2f us/frame %8.1f commands %8.1f draws %8.1f state changes %8.1f redundant\n",
+	       name, (double)result.nanoseconds / frames / 1000.0, (double)result.numCommands / frames,
+	       (double)result.numDraws / frames, (double)result.numStateChanges / frames,
+	       (double)result.numRedundantCommands / frames);
+}
+
+int
+main(int /*argc*/, char ** /*argv*/)
+{
+	// there's no OpenGL context, so resources mustn't create OpenGL objects
+	GfxDriver::setGLEnabled(false);
+
+	GfxDriverRecorder recorder;
+	GfxDriver *driver = &recorder;
+	driver->setViewportDimensions(1280, 720);
+	driver->setProjectionMatrix(1280, 720);
+	recorder.clear();
+
+	BenchScene scene;
+	printf("%u blocks, %u lights, %u frames\n\n", GRID_SIZE * GRID_SIZE, NUM_LIGHTS, NUM_FRAMES);
+
+	BenchResult direct = benchmark(scene, recorder, false);
+	printResult("direct", direct);
+
+	BenchResult queued = benchmark(scene, recorder, true);
+	printResult("render queue", queued);
+
+	return 0;
+}
@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <vector>
+#include <DromeCore/DromeCore>
+#include <DromeMath/DromeMath>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeMath;
+
+static const unsigned int NUM_MATRICES = 256;
+static const unsigned int NUM_POINTS = 4096;
+static const unsigned int NUM_ITERATIONS = 4000;
+
+// the scalar operations were compiled in Matrix4.cpp, so keep them out of line
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif /* _MSC_VER */
+
+/*
+ * the scalar matrix operations the way Matrix4 implemented them
+ * before it used SIMD instructions
+ */
+class LegacyMatrix4
+{
+	public:
+		float m_matrix[16];
+
+		LegacyMatrix4() { }
+
+		LegacyMatrix4(const float matrix[16])
+		{
+			for(int i = 0; i < 16; ++i)
+				m_matrix[i] = matrix[i];
+		}
+
+		NOINLINE LegacyMatrix4
+		operator * (const LegacyMatrix4 &matrix) const
+		{
+			const float *m1 = matrix.m_matrix;
+			const float *m2 = m_matrix;
+			float m[16];
+
+			for(int i = 0; i < 4; ++i) {
+				for(int j = 0; j < 4; ++j)
+					m[i*4+j] = m1[i*4]*m2[j] + m1[i*4+1]*m2[4+j] + m1[i*4+2]*m2[8+j] + m1[i*4+3]*m2[12+j];
+			}
+
+			return LegacyMatrix4(m);
+		}
+
+		NOINLINE Vector3
+		operator * (const Vector3 &v) const
+		{
+			const float *m = m_matrix;
+			return Vector3(m[0]*v.x + m[4]*v.y + m[8]*v.z + m[12],
+			               m[1]*v.x + m[5]*v.y + m[9]*v.z + m[13],
+			               m[2]*v.x + m[6]*v.y + m[10]*v.z + m[14]);
+		}
+
+		NOINLINE LegacyMatrix4
+		transpose() const
+		{
+			float m[16];
+
+			for(int i = 0; i < 4; ++i) {
+				for(int j = 0; j < 4; ++j)
+					m[i*4+j] = m_matrix[j*4+i];
+			}
+
+			return LegacyMatrix4(m);
+		}
+};
+
+static vector <Matrix4> matrices;
+static vector <LegacyMatrix4> legacyMatrices;
+static vector <Vector3> points;
+static vector <Quaternion> rotations1;
+static vector <Quaternion> rotations2;
+
+// accumulates results so that the compiler can't skip computing them
+static volatile float sink;
+
+static double
+benchmarkMultiplyLegacy()
+{
+	vector <LegacyMatrix4> results(NUM_MATRICES);
+	LegacyMatrix4 view = legacyMatrices[0];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = view * legacyMatrices[j];
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1].m_matrix[0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkMultiply()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+	Matrix4 view = matrices[0];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = view * matrices[j];
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkMultiplyBatch()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+	Matrix4 view = matrices[0];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+		Matrix4::multiply(view, &matrices[0], &results[0], NUM_MATRICES);
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkTransformLegacy()
+{
+	vector <Vector3> results(NUM_POINTS);
+	LegacyMatrix4 m = legacyMatrices[1];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_POINTS; ++j)
+			results[j] = m * points[j];
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkTransformBatch()
+{
+	vector <Vector3> results(NUM_POINTS);
+	Matrix4 m = matrices[1];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+		m.transformPoints(&points[0], &results[0], NUM_POINTS);
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkTransformNormalsLegacy()
+{
+	vector <Vector3> results(NUM_POINTS);
+	LegacyMatrix4 m(matrices[1].normalMatrix().getData());
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_POINTS; ++j)
+			results[j] = (m * points[j]).normalize();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkTransformNormalsBatch()
+{
+	vector <Vector3> results(NUM_POINTS);
+	Matrix4 m = matrices[1];
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+		m.transformNormals(&points[0], &results[0], NUM_POINTS);
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkTransposeLegacy()
+{
+	vector <LegacyMatrix4> results(NUM_MATRICES);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = legacyMatrices[j].transpose();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1].m_matrix[0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkTranspose()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = matrices[j].transpose();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkInverse()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = matrices[j].inverse();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkInverseAffine()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = matrices[j].inverseAffine();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkInverseOrthonormal()
+{
+	vector <Matrix4> results(NUM_MATRICES);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_MATRICES; ++j)
+			results[j] = matrices[j].inverseOrthonormal();
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_MATRICES - 1][0];
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_MATRICES);
+}
+
+static double
+benchmarkRotateLegacy()
+{
+	vector <Vector3> results(NUM_POINTS);
+
+	// rotating by each quaternion's matrix, without a direct rotation
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_POINTS; ++j)
+			results[j] = rotations1[j].conjugate().toMatrix4() * points[j];
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkRotate()
+{
+	vector <Vector3> results(NUM_POINTS);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		for(unsigned int j = 0; j < NUM_POINTS; ++j)
+			results[j] = rotations1[j].rotate(points[j]);
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkRotateBatch()
+{
+	vector <Vector3> results(NUM_POINTS);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+		Quaternion::rotate(&rotations1[0], &points[0], &results[0], NUM_POINTS);
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].x;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static double
+benchmarkInterpolate(bool spherical, bool batch)
+{
+	vector <Quaternion> results(NUM_POINTS);
+
+	uint64_t start = getNanoseconds();
+	for(unsigned int i = 0; i < NUM_ITERATIONS; ++i) {
+		if(batch && spherical) {
+			Quaternion::slerp(&rotations1[0], &rotations2[0], 0.3f, &results[0], NUM_POINTS);
+		} else if(batch) {
+			Quaternion::nlerp(&rotations1[0], &rotations2[0], 0.3f, &results[0], NUM_POINTS);
+		} else {
+			for(unsigned int j = 0; j < NUM_POINTS; ++j) {
+				if(spherical)
+					results[j] = Quaternion::slerp(rotations1[j], rotations2[j], 0.3f);
+				else
+					results[j] = Quaternion::nlerp(rotations1[j], rotations2[j], 0.3f);
+			}
+		}
+	}
+	uint64_t elapsed = getNanoseconds() - start;
+
+	sink = results[NUM_POINTS - 1].w;
+	return (double)elapsed / ((double)NUM_ITERATIONS * NUM_POINTS);
+}
+
+static void
+printResult(const char *name, double nanoseconds, double baseline)
+{
+	printf("%-32s %8.2f ns %6.2fx\n", name, nanoseconds, baseline / nanoseconds);
+}
+
+int
+main(int /*argc*/, char ** /*argv*/)
+{
+	// random rigid transforms, which are always invertible
+	Random random;
+	for(unsigned int i = 0; i < NUM_MATRICES; ++i) {
+		Vector3 axis = random.nextUnitVector();
+		Vector3 translation = random.nextUnitVector() * random.nextFloat(0.0f, 100.0f);
+		Matrix4 m = Matrix4::translation(translation) * Matrix4::rotation(random.nextFloat(0.0f, 6.28f), axis);
+		matrices.push_back(m);
+		legacyMatrices.push_back(LegacyMatrix4(m.getData()));
+	}
+	points.resize(NUM_POINTS);
+	random.fillUnitVectors(&points[0], NUM_POINTS);
+	for(unsigned int i = 0; i < NUM_POINTS; ++i) {
+		rotations1.push_back(Quaternion::fromAxis(random.nextUnitVector(), random.nextFloat(0.0f, 6.28f)));
+		rotations2.push_back(Quaternion::fromAxis(random.nextUnitVector(), random.nextFloat(0.0f, 6.28f)));
+	}
+
+	printf("Matrix4 instruction set: %s\n\n", Matrix4::getInstructionSetName());
+
+	double legacy = benchmarkMultiplyLegacy();
+	printResult("multiply, scalar", legacy, legacy);
+	printResult("multiply", benchmarkMultiply(), legacy);
+	printResult("multiply, batch", benchmarkMultiplyBatch(), legacy);
+
+	legacy = benchmarkTransformLegacy();
+	printResult("transform point, scalar", legacy, legacy);
+	printResult("transform points, batch", benchmarkTransformBatch(), legacy);
+
+	legacy = benchmarkTransformNormalsLegacy();
+	printResult("transform normal, scalar", legacy, legacy);
+	printResult("transform normals, batch", benchmarkTransformNormalsBatch(), legacy);
+
+	legacy = benchmarkTransposeLegacy();
+	printResult("transpose, scalar", legacy, legacy);
+	printResult("transpose", benchmarkTranspose(), legacy);
+
+	double inverse = benchmarkInverse();
+	printResult("inverse", inverse, inverse);
+	printResult("inverse, affine", benchmarkInverseAffine(), inverse);
+	printResult("inverse, orthonormal", benchmarkInverseOrthonormal(), inverse);
+
+	legacy = benchmarkRotateLegacy();
+	printResult("rotate vector, by matrix", legacy, legacy);
+	printResult("rotate vector", benchmarkRotate(), legacy);
+	printResult("rotate vectors, batch", benchmarkRotateBatch(), legacy);
+
+	legacy = benchmarkInterpolate(false, false);
+	printResult("nlerp", legacy, legacy);
+	printResult("nlerp, batch", benchmarkInterpolate(false, true), legacy);
+
+	legacy = benchmarkInterpolate(true, false);
+	printResult("slerp", legacy, legacy);
+	printResult("slerp, batch", benchmarkInterpolate(true, true), legacy);
+
+	return 0;
+}
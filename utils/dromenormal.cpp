@@ -36,7 +36,7 @@ using namespace DromeGfx;
 using namespace DromeMath;
 
 static uint8_t *
-generate_normalmap(RefPtr <Image> bumpimg)
+generate_normalmap(const RefPtr <Image> &bumpimg)
 {
 	unsigned int width = bumpimg->getWidth();
 	unsigned int height = bumpimg->getHeight();
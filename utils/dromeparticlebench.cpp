@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2012 Josh A. Beam
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <DromeCore/DromeCore>
+#include <DromeGfx/ParticleEmitter.h>
+#include <DromeMath/DromeMath>
+
+using namespace std;
+using namespace DromeCore;
+using namespace DromeGfx;
+using namespace DromeMath;
+
+static const unsigned int NUM_PARTICLES = 100000;
+static const unsigned int NUM_CYCLES = 200;
+
+// short enough that no particle fades out during the benchmark
+static const float SECONDS_PER_CYCLE = 0.001f;
+
+/*
+ * per-particle objects updated through Vector3 operators,
+ * the way ParticleEmitter worked before its arrays were split
+ */
+class LegacyParticle
+{
+	public:
+		Vector3 position;
+		Vector3 velocity;
+		float rotation;
+		float width, height;
+		float alpha;
+		bool done;
+
+		void cycle(float secondsElapsed)
+		{
+			position += velocity * secondsElapsed;
+			rotation += 30.0f * secondsElapsed;
+			width -= 0.25f * secondsElapsed;
+			height -= 0.25f * secondsElapsed;
+
+			alpha -= 0.75f * secondsElapsed;
+			if(alpha < 0.0f)
+				done = true;
+		}
+};
+
+static double
+benchmarkLegacy()
+{
+	vector <LegacyParticle *> particles;
+	for(unsigned int i = 0; i < NUM_PARTICLES; ++i) {
+		LegacyParticle *p = new LegacyParticle();
+		p->velocity = Vector3(randomFloat(), randomFloat(), randomFloat()).normalize();
+		p->rotation = randomFloat(0.0f, 360.0f);
+		p->width = p->height = randomFloat(0.0f, 1.0f);
+		p->alpha = 1.0f;
+		p->done = false;
+		particles.push_back(p);
+	}
+
+	long start = getTicks();
+	for(unsigned int i = 0; i < NUM_CYCLES; ++i) {
+		for(unsigned int j = 0; j < particles.size(); ++j) {
+			particles[j]->cycle(SECONDS_PER_CYCLE);
+			if(particles[j]->done) {
+				delete particles[j];
+				particles.erase(particles.begin() + j);
+				--j;
+			}
+		}
+	}
+	long ticks = getTicks() - start;
+
+	for(unsigned int i = 0; i < particles.size(); ++i)
+		delete particles[i];
+
+	return (double)ticks;
+}
+
+static double
+benchmarkEmitter(bool simdEnabled, unsigned int *numParticles)
+{
+	ParticleEmitter::setSimdEnabled(simdEnabled);
+
+	// emit all particles in one cycle, then stop emitting
+	RefPtr <ParticleEmitter> emitter = ParticleEmitter::create();
+	emitter->reserve(NUM_PARTICLES);
+	emitter->setParticlesPerSecond((float)NUM_PARTICLES);
+	emitter->cycle(1.0f - 0.5f / (float)NUM_PARTICLES);
+	emitter->setParticlesPerSecond(0.0f);
+
+	long start = getTicks();
+	for(unsigned int i = 0; i < NUM_CYCLES; ++i)
+		emitter->cycle(SECONDS_PER_CYCLE);
+	long ticks = getTicks() - start;
+
+	*numParticles = emitter->getNumParticles();
+	return (double)ticks;
+}
+
+static void
+printResult(const char *name, double milliseconds, double baseline)
+{
+	double nanoseconds = (milliseconds * 1000000.0) / ((double)NUM_PARTICLES * (double)NUM_CYCLES);
+	printf("%-24s %8.1f ms %8.2f ns/particle %6.2fx\n", name, milliseconds, nanoseconds, baseline / milliseconds);
+}
+
+int
+main(int /*argc*/, char ** /*argv*/)
+{
+	getTicks();
+	printf("%u particles, %u cycles\n\n", NUM_PARTICLES, NUM_CYCLES);
+
+	double legacy = benchmarkLegacy();
+	printResult("per-particle objects", legacy, legacy);
+
+	unsigned int numScalar, numSimd;
+	double scalar = benchmarkEmitter(false, &numScalar);
+	printResult("ParticleEmitter scalar", scalar, legacy);
+
+	ParticleEmitter::setSimdEnabled(true);
+	char name[64];
+	snprintf(name, sizeof(name), "ParticleEmitter %s", ParticleEmitter::getInstructionSetName());
+	double simd = benchmarkEmitter(true, &numSimd);
+	printResult(name, simd, legacy);
+
+	if(numScalar != numSimd) {
+		fprintf(stderr, "Particle counts differ: %u scalar, %u SIMD\n", numScalar, numSimd);
+		return 1;
+	}
+
+	return 0;
+}